@@ -2,35 +2,109 @@
 #include <GLFW/glfw3.h>
 #include <glad/glad.h>
 #include <cstddef>
+#include <glimac/Arena.hpp>
+#include <glimac/AssetLoader.hpp>
+#include <glimac/BBox.hpp>
+#include <glimac/BVH.hpp>
 #include <glimac/Cylindre.hpp>
+#include <glimac/DataTexture.hpp>
 #include <glimac/FilePath.hpp>
 #include <glimac/FreeFlyCamera.hpp>
+#include <glimac/Frustum.hpp>
+#include <glimac/GLState.hpp>
 #include <glimac/Geometry.hpp>
 #include <glimac/Image.hpp>
+#include <glimac/InstanceBuffer.hpp>
+#include <glimac/LightClusters.hpp>
+#include <glimac/MeshBuffer.hpp>
+#include <glimac/MeshLOD.hpp>
 #include <glimac/Program.hpp>
+#include <glimac/RenderQueue.hpp>
+#include <glimac/RenderStats.hpp>
+#include <glimac/Scene.hpp>
+#include <glimac/SegmentCache.hpp>
 #include <glimac/Sphere.hpp>
+#include <glimac/TextureManager.hpp>
 #include <glimac/TrackballCamera.hpp>
+#include <glimac/UniformBuffer.hpp>
 #include <glimac/common.hpp>
 #include <glimac/glm.hpp>
+#include <limits>
+#include <memory>
 #include <vector>
 
 int window_width  = 1280;
 int window_height = 720;
+// taille en pixels du framebuffer, qui peut différer de celle de la fenêtre (écrans haute densité):
+// c'est celle du viewport et de gl_FragCoord
+int framebuffer_width  = 1280;
+int framebuffer_height = 720;
 const float r = 0.5f;
 const float PI = 3.141593;
+const float zNear = 0.1f;
+const float zFar  = 100.f;
 
 #define MAX_TEXTURES 2
-#define MAX_LIGHTS 10
+// taille du tableau du bloc LightData de lights.fs.glsl (les lumières ponctuelles sont dans une texture)
+#define MAX_DIR_LIGHTS 16
+
+// points de liaison des blocs d'uniformes
+enum UniformBinding { FRAME_UNIFORMS_BINDING, LIGHT_UNIFORMS_BINDING };
+
+// unités des textures de l'éclairage par clusters, après celles des matériaux
+enum LightTextureUnit { POINT_LIGHT_TEXTURE_UNIT = MAX_TEXTURES, CLUSTER_TEXTURE_UNIT, LIGHT_INDEX_TEXTURE_UNIT };
+
+// largeur des textures de données (lumières, indices): 1024 x 1024 texels au plus
+#define DATA_TEXTURE_WIDTH 1024
+
+// éclairement en dessous duquel une lumière ponctuelle est ignorée: donne son rayon d'influence
+const float LIGHT_CUTOFF = 1.f / 256.f;
 
 float randomFloat(float limit)
 {
     return static_cast<float>(rand()) / static_cast<float>(RAND_MAX / limit);
 }
 
+/* BLOCS D'UNIFORMES */
+// copies exactes (disposition std140) des blocs FrameData et LightData des shaders
+struct FrameUniforms {
+    glm::mat4 ViewMatrix;
+    glm::mat4 ProjMatrix;
+    glm::vec4 ViewPos;
+    glm::vec4 AmbiantLight;
+};
+
+struct DirLightUniforms {
+    glm::vec3 direction;
+    float     intensity;
+    glm::vec3 color;
+    float     padding;
+};
+
+struct LightUniforms {
+    glm::ivec4       Count;        // x dir lights, y point lights
+    glm::vec4        ClusterScale; // xy: tuiles par pixel, zw: tranche = log(profondeur) * z + w
+    glm::ivec4       ClusterGrid;  // nombre de tuiles en x, en y, de tranches
+    DirLightUniforms DirLights[MAX_DIR_LIGHTS];
+};
+
+// deux texels RGBA32F de uPointLightTexture
+struct PointLightTexels {
+    glm::vec3 position; // repère de la vue
+    float     radius;
+    glm::vec3 color;
+    float     intensity;
+};
+
+static_assert(sizeof(FrameUniforms) == 160, "FrameUniforms must match the std140 layout of FrameData");
+static_assert(sizeof(DirLightUniforms) == 32, "DirLightUniforms must match its std140 array stride");
+static_assert(offsetof(LightUniforms, DirLights) == 48, "LightUniforms must match the std140 layout of LightData");
+static_assert(sizeof(PointLightTexels) == 2 * sizeof(glm::vec4), "PointLightTexels must fill two RGBA texels");
+static_assert(sizeof(glimac::LightClusters::Cluster) == 2 * sizeof(uint32_t), "a cluster must fill one RG32UI texel");
+
 /* STRUCTURES */
 struct Material {
 private:
-    GLint uMVPMatrix_gl;
     GLint uMVMatrix_gl;
     GLint uNormalMatrix_gl;
 
@@ -39,8 +113,9 @@ private:
     GLint shininess_gl;
     GLint hasTexture_gl;
     GLint isLamp_gl;
+    GLint isInstanced_gl;
 
-    GLuint* uTextures_gl;
+    std::vector<GLuint> uTextures_gl;
 
 public:
     glm::vec3  color;
@@ -49,8 +124,10 @@ public:
     bool       hasTexture;
     int       NbTextures;
     bool       isLamp;
+    bool       isInstanced = false; // couleur et matrice modèle lues dans les attributs d'instance
 
-    std::unique_ptr<glimac::Image>* uTextures;
+    // images possédées par le matériau, libérées avec lui (leurs textures GL par TextureManager::clear)
+    std::vector<std::unique_ptr<glimac::Image>> uTextures;
 
 
     Material(){}
@@ -63,14 +140,14 @@ public:
 
         hasTexture_gl = glGetUniformLocation(prog_GLid, "uMaterial.hasTexture");
         isLamp_gl        = glGetUniformLocation(prog_GLid, "uMaterial.isLamp");
+        isInstanced_gl   = glGetUniformLocation(prog_GLid, "uInstanced");
 
-        uMVPMatrix_gl   = glGetUniformLocation(prog_GLid, "uMVPMatrix");
         uMVMatrix_gl    = glGetUniformLocation(prog_GLid, "uMVMatrix");
         uNormalMatrix_gl = glGetUniformLocation(prog_GLid, "uNormalMatrix");
 
         // Textures
-        uTextures_gl = (GLuint*)calloc(MAX_TEXTURES, sizeof(GLuint));
-        uTextures    = (std::unique_ptr<glimac::Image>*)calloc(MAX_TEXTURES, sizeof(std::unique_ptr<glimac::Image>));
+        uTextures_gl.resize(MAX_TEXTURES);
+        uTextures.resize(MAX_TEXTURES);
 
         for (int i = 0; i < MAX_TEXTURES; i++) {
             char varname[50] = "";
@@ -79,43 +156,42 @@ public:
         }
     }
 
+    // Identifiant de la première texture (0 sans texture), pour la clé de tri des commandes de dessin
+    GLuint GetTextureKey() const {
+        return (hasTexture && NbTextures > 0) ? glimac::TextureManager::getTexture(uTextures[0].get()) : 0;
+    }
+
     void ChargeGLints(){
+        glimac::RenderStats::addStateChange(glimac::RenderStats::MATERIAL_CHANGE);
         glUniform3f(color_gl, color.x, color.y, color.z);
         glUniform1f(specularIntensity_gl, specularIntensity);
         glUniform1f(shininess_gl, shininess);
         glUniform1f(hasTexture_gl, hasTexture);
         glUniform1f(isLamp_gl, isLamp);
+        glUniform1i(isInstanced_gl, isInstanced);
         if (hasTexture){
-            GLuint texture;
-            glGenTextures(NbTextures, &texture);
-            glBindTexture(GL_TEXTURE_2D, texture);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            for (int i = 0; i < NbTextures; i++) {
-                if(i==0)
-                    glActiveTexture(GL_TEXTURE0);
-                else
-                    glActiveTexture(GL_TEXTURE1);
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, uTextures[i]->getWidth(), uTextures[i]->getHeight(), 0, GL_RGBA, GL_FLOAT, uTextures[i]->getPixels());
+            // les textures GL sont créées une seule fois par le TextureManager, ici on ne fait que les binder
+            for (int i = 0; i < MAX_TEXTURES; i++) {
+                if (i < NbTextures) {
+                    glimac::TextureManager::bind(uTextures[i].get(), i);
+                }
+                else { // unité inutilisée: on évite d'échantillonner la texture d'un autre matériau
+                    glimac::GLState::bindTexture(i, 0);
+                }
                 glUniform1i(uTextures_gl[i], i);
             }
         }
     }
 
-    void ChargeMatrices(glm::mat4 materialMVMatrix, glm::mat4 projMatrix)
+    // la projection est dans le bloc FrameData
+    void ChargeMatrices(glm::mat4 materialMVMatrix)
     {
         glUniformMatrix4fv(uMVMatrix_gl, 1, GL_FALSE, glm::value_ptr(materialMVMatrix));
         glUniformMatrix4fv(uNormalMatrix_gl, 1, GL_FALSE, glm::value_ptr(glm::transpose(glm::inverse(materialMVMatrix))));
-        glUniformMatrix4fv(uMVPMatrix_gl, 1, GL_FALSE, glm::value_ptr(projMatrix * materialMVMatrix));
     }
 };
 
 struct PointLight {
-private:
-    GLint position_gl;
-    GLint intensity_gl;
-    GLint color_gl;
-
 public:
     glm::vec3 position;
     float     intensity;
@@ -123,30 +199,27 @@ public:
 
     PointLight() {}
 
-    PointLight(GLint prog_GLid, int i)
+    // Distance à laquelle l'éclairement (intensity² * couleur / d², voir lights.fs.glsl) passe sous LIGHT_CUTOFF
+    float GetRadius() const
     {
-        char varname[50] = "";
-        sprintf(varname, "uPointLights[%d].position", i);
-        position_gl = glGetUniformLocation(prog_GLid, varname);
-
-        sprintf(varname, "uPointLights[%d].intensity", i);
-        intensity_gl = glGetUniformLocation(prog_GLid, varname);
-
-        sprintf(varname, "uPointLights[%d].color", i);
-        color_gl = glGetUniformLocation(prog_GLid, varname);
-
+        float maxColor = glm::max(color.r, glm::max(color.g, color.b));
+        return intensity * glm::sqrt(maxColor / LIGHT_CUTOFF);
     }
 
-    void ChargeGLints(glm::vec3 light_position)
+    // light_position: position dans le repère de la vue
+    PointLightTexels GetTexels(glm::vec3 light_position) const
     {
-        glUniform3fv(position_gl, 1, glm::value_ptr(light_position));
-        glUniform3f(color_gl, color.x, color.y, color.z);
-        glUniform1f(intensity_gl, intensity);
+        PointLightTexels texels;
+        texels.position  = light_position;
+        texels.radius    = GetRadius();
+        texels.color     = color;
+        texels.intensity = intensity;
+        return texels;
     }
 
-    Material* GenerateLampe(GLint prog_GLid)
+    Material* GenerateLampe(glimac::Arena& arena, GLint prog_GLid)
     {
-        Material* my_lampe = new Material(prog_GLid);
+        Material* my_lampe = arena.create<Material>(prog_GLid);
         my_lampe->color = color;
         my_lampe->hasTexture = false;
         my_lampe->isLamp = true;
@@ -157,11 +230,6 @@ public:
 };
 
 struct DirLight {
-private:
-    GLint direction_gl;
-    GLint intensity_gl;
-    GLint color_gl;
-
 public:
     glm::vec3 direction;
     float intensity;
@@ -169,38 +237,124 @@ public:
 
     DirLight() {}
 
-    DirLight(GLint prog_GLid, int i)
+    DirLightUniforms GetUniforms() const
     {
-        char        varname[50] = "";
-        sprintf(varname, "uDirLights[%d].direction", i);
-        direction_gl = glGetUniformLocation(prog_GLid, varname);
-
-        sprintf(varname, "uDirLights[%d].intensity", i);
-        intensity_gl = glGetUniformLocation(prog_GLid, varname);
-
-        sprintf(varname, "uDirLights[%d].color", i);
-        color_gl = glGetUniformLocation(prog_GLid, varname);
-    }
-
-    void ChargeGLints()
-    {
-        glUniform3f(direction_gl, direction.x, direction.y, direction.z);
-        glUniform3f(color_gl, color.x, color.y, color.z);
-        glUniform1f(intensity_gl, intensity);
+        DirLightUniforms uniforms;
+        uniforms.direction = direction;
+        uniforms.intensity = intensity;
+        uniforms.color     = color;
+        uniforms.padding   = 0.f;
+        return uniforms;
     }
 };
 
 struct Circuit{
 public:
+    // à modifier via SetParts, pour que la table des tronçons soit recalculée
     std::vector<glm::vec3> CircuitParts;
     std::vector<glm::vec3> CircuitColors;
     Material*              CircuitMaterial;
     int                    NbCircuitPoints = 0;
 
-    Circuit(GLint prog_GLid)
+    float                  TubeRadius = .03f;
+
+    // un tronçon = une instance du cylindre, un buffer d'instances par niveau de détail
+    std::vector<std::unique_ptr<glimac::InstanceBuffer>> Instances;
+
+    // incrémentée à chaque modification des points
+    unsigned int Version = 0;
+
+    Circuit(glimac::Arena& arena, GLint prog_GLid)
+    {
+        CircuitMaterial = arena.create<Material>(prog_GLid);
+        CircuitMaterial->isInstanced = true;
+    }
+
+    void SetParts(const std::vector<glm::vec3>& parts, const std::vector<glm::vec3>& colors)
+    {
+        CircuitParts    = parts;
+        CircuitColors   = colors;
+        NbCircuitPoints = parts.size();
+        ++Version;
+    }
+
+    // Table des matrices modèle (sans la vue) et des couleurs des tronçons,
+    // recalculée seulement si les points ont changé depuis le dernier appel
+    const std::vector<glimac::InstanceData>& GetSegments()
+    {
+        return Segments.get(CircuitParts, CircuitColors, Version);
+    }
+
+    // Renvoie la table au GPU uniquement si elle a changé depuis le dernier envoi
+    void UpdateInstances()
+    {
+        if (UploadedVersion != Version) {
+            for (auto& instances : Instances) {
+                instances->upload(GetSegments());
+            }
+            UploadedVersion = Version;
+        }
+    }
+
+    // Distance entre un point (repère monde) et le tronçon le plus proche, cherchée dans la hiérarchie
+    // des tronçons plutôt qu'en les parcourant tous
+    float NearestDistance(glm::vec3 point)
+    {
+        const Circuit* circuit = this;
+        return GetSegmentTree().nearestDistance(point, [circuit](uint32_t i, const glm::vec3& p) {
+            return circuit->SegmentDistance(i, p);
+        });
+    }
+
+    float SegmentDistance(int i, glm::vec3 point) const
     {
-        CircuitMaterial = new Material(prog_GLid);
+        glm::vec3 Pstart  = CircuitParts[i];
+        glm::vec3 Pend    = (NbCircuitPoints - 1 == i) ? CircuitParts[0] : CircuitParts[i + 1];
+        glm::vec3 segment = Pend - Pstart;
+        float     length2 = glm::dot(segment, segment);
+        float     t       = (length2 > 0.f) ? glm::clamp(glm::dot(point - Pstart, segment) / length2, 0.f, 1.f) : 0.f;
+        return glm::length(point - (Pstart + t * segment));
     }
+
+    // Hiérarchie des boîtes des tronçons (une primitive par tronçon), reconstruite si les points ont changé
+    const glimac::BVH& GetSegmentTree()
+    {
+        if (SegmentTreeVersion != Version) {
+            std::vector<glimac::BBox3f> boxes;
+            boxes.reserve(NbCircuitPoints);
+            for (int i = 0; i < NbCircuitPoints; i++) {
+                glm::vec3 Pstart = CircuitParts[i];
+                glm::vec3 Pend   = (NbCircuitPoints - 1 == i) ? CircuitParts[0] : CircuitParts[i + 1];
+                boxes.push_back(glimac::BBox3f(glm::min(Pstart, Pend), glm::max(Pstart, Pend)));
+            }
+            SegmentTree        = glimac::BVH(boxes);
+            SegmentTreeVersion = Version;
+        }
+        return SegmentTree;
+    }
+
+    // Boîte englobante de tout le circuit (repère monde): il est dessiné en un seul appel, donc testé d'un bloc.
+    // Recalculée seulement si les points ont changé
+    const glimac::BBox3f& GetBounds()
+    {
+        if (BoundsVersion != Version) {
+            Bounds = glimac::BBox3f::emptyBox();
+            if (NbCircuitPoints > 0) {
+                glimac::BBox3f points = glimac::BBox3f::fromPoints(CircuitParts.data(), NbCircuitPoints);
+                Bounds = glimac::BBox3f(points.lower - glm::vec3(TubeRadius), points.upper + glm::vec3(TubeRadius));
+            }
+            BoundsVersion = Version;
+        }
+        return Bounds;
+    }
+
+private:
+    glimac::SegmentCache Segments;
+    unsigned int UploadedVersion = 0;
+    glimac::BVH  SegmentTree;
+    unsigned int SegmentTreeVersion = 0;
+    glimac::BBox3f Bounds = glimac::BBox3f::emptyBox();
+    unsigned int BoundsVersion = 0;
 };
 
 struct Wagon{
@@ -218,15 +372,15 @@ public:
     float minSpeed;
     float maxSpeed;
 
-    Wagon(GLint prog_GLid)
+    Wagon(glimac::Arena& arena, GLint prog_GLid)
     {
-        WagonObject = new glimac::Geometry();
+        WagonObject = arena.create<glimac::Geometry>();
         bool res    = WagonObject->loadOBJ("./assets/models/Wagon.obj", "./assets/models/Wagon.mtl", false);
         if (!res) {
             printf("ERROR chargement du Wagon! \n");
             exit(-1);
         }
-        WagonMaterial = new Material(prog_GLid);
+        WagonMaterial = arena.create<Material>(prog_GLid);
         isActif = false;
         timeSinceSwitchingIndex = 0.f;
         indexPos = 0;
@@ -248,13 +402,16 @@ public:
 struct Rectangle {
 public:
     std::vector<glimac::ShapeVertex> vertices;
-    std::vector<int>                 indices;
+    std::vector<unsigned int>        indices;
     unsigned int                     numVertices;
     unsigned int                     numIndices;
 
+    // boîte englobante dans le repère du rectangle
+    glimac::BBox3f Bounds;
+
     Material* material;
 
-    Rectangle(GLint prog_GLid, float width_vertex_nb, float length_vertex_nb, bool randomize_elevation, glm::vec3 color = glm::vec3(1, 1, 1))
+    Rectangle(glimac::Arena& arena, GLint prog_GLid, float width_vertex_nb, float length_vertex_nb, bool randomize_elevation, glm::vec3 color = glm::vec3(1, 1, 1))
     {
         float     decW   = 1 / (width_vertex_nb - 1);
         float     decL   = 1 / (length_vertex_nb - 1);
@@ -279,8 +436,9 @@ public:
 
         numVertices = vertices.size();
         numIndices  = indices.size();
+        Bounds      = glimac::BBox3f::fromPoints(&vertices[0].position, numVertices, sizeof(glimac::ShapeVertex));
 
-        material                    = new Material(prog_GLid);
+        material                    = arena.create<Material>(prog_GLid);
         material->color             = color;
         material->isLamp            = false;
         material->hasTexture        = false;
@@ -289,14 +447,17 @@ public:
     }
 };
 
-struct GeneralInfos {
-private:
-    GLint AmbiantLight_gl;
-    GLint ViewPos_gl;
+// identifiants des composants maillage et matériau des entités de la scène
+enum SceneMesh { MESH_CIRCUIT, MESH_FLOOR, MESH_SKY, MESH_WAGON, MESH_LAMP };
 
-    GLint NbLights_gl;
+// les lampes ont chacune leur matériau: MATERIAL_LAMP + indice dans GeneralInfos::Lampes
+enum SceneMaterial { MATERIAL_CIRCUIT, MATERIAL_FLOOR, MATERIAL_SKY, MATERIAL_WAGON, MATERIAL_LAMP };
 
+struct GeneralInfos {
 public:
+    // possède tous les objets de la scène (lumières, matériaux, circuit, wagon...): détruits avec GeneralInfos
+    glimac::Arena arena;
+
     // matrices
     glm::mat4 globalMVMatrix;
     glm::mat4 projMatrix;
@@ -312,8 +473,6 @@ public:
     std::vector<PointLight*> PointLights;
     std::vector<Material*> Lampes;
 
-    glm::vec2 NbLights = glm::vec2(0, 0);
-
     // objects
     Circuit* circuit;
 
@@ -345,59 +504,208 @@ public:
     // state
     bool mounting = false;
 
-    // basic objects
-    glimac::Sphere* sphere;
-    glimac::Cylindre* cylindre;
+    // maillages envoyés une seule fois au GPU
+    glimac::MeshRegistry meshes;
+
+    // une entité par objet dessiné, les pivots portant les mouvements partagés (voir BuildScene)
+    glimac::Scene               scene;
+    glimac::Entity              circuitEntity, floorEntity, skyEntity, wagonPivot, wagonEntity, lampPivot;
+    std::vector<glimac::Entity> lampEntities;
+
+    // version du circuit dont la boîte a été donnée à circuitEntity
+    unsigned int circuitBoundsVersion = 0;
+
+    // résultat du frustum culling de la dernière frame, indexé par l'entité
+    std::vector<unsigned char> visible;
+
+    // matériau de chaque identifiant SceneMaterial, rempli par BuildScene
+    std::vector<Material*> Materials;
+
+    // commandes de dessin de la frame, triées pour limiter les changements d'état
+    glimac::RenderQueue renderQueue;
+
+    // blocs FrameData et LightData: un seul envoi chacun par frame, partagé par tous les draws
+    FrameUniforms         frameUniforms;
+    LightUniforms         lightUniforms;
+    glimac::UniformBuffer frameBuffer;
+    glimac::UniformBuffer lightBuffer;
+
+    // éclairage par clusters: les lumières ponctuelles sont rangées chaque frame dans la grille, que le
+    // fragment shader lit dans trois textures de données
+    glimac::LightClusters         lightClusters;
+    std::vector<PointLightTexels> pointLightTexels;
+    std::vector<glm::vec4>        pointLightSpheres; // centre (repère de la vue) et rayon
+    glimac::DataTexture           pointLightTexture;
+    glimac::DataTexture           clusterTexture;
+    glimac::DataTexture           lightIndexTexture;
 
     GeneralInfos(GLint prog_GLid, glimac::FilePath applicationPath)
+        : frameBuffer(sizeof(FrameUniforms), FRAME_UNIFORMS_BINDING), lightBuffer(sizeof(LightUniforms), LIGHT_UNIFORMS_BINDING),
+          pointLightTexture(GL_RGBA32F, GL_RGBA, GL_FLOAT, sizeof(glm::vec4), DATA_TEXTURE_WIDTH, POINT_LIGHT_TEXTURE_UNIT),
+          clusterTexture(GL_RG32UI, GL_RG_INTEGER, GL_UNSIGNED_INT, sizeof(glimac::LightClusters::Cluster),
+                         lightClusters.getTileCountX() * lightClusters.getTileCountY(), CLUSTER_TEXTURE_UNIT),
+          lightIndexTexture(GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, sizeof(uint32_t), DATA_TEXTURE_WIDTH, LIGHT_INDEX_TEXTURE_UNIT)
     {
-        AmbiantLight_gl = glGetUniformLocation(prog_GLid, "uAmbiantLight");
-        ViewPos_gl = glGetUniformLocation(prog_GLid, "uViewPos");
+        glimac::UniformBuffer::bindBlock(prog_GLid, "FrameData", FRAME_UNIFORMS_BINDING);
+        glimac::UniformBuffer::bindBlock(prog_GLid, "LightData", LIGHT_UNIFORMS_BINDING);
 
-        NbLights_gl = glGetUniformLocation(prog_GLid, "NbLights");
+        // le programme est déjà utilisé: les samplers des données d'éclairage ne changent plus d'unité
+        glUniform1i(glGetUniformLocation(prog_GLid, "uPointLightTexture"), POINT_LIGHT_TEXTURE_UNIT);
+        glUniform1i(glGetUniformLocation(prog_GLid, "uClusterTexture"), CLUSTER_TEXTURE_UNIT);
+        glUniform1i(glGetUniformLocation(prog_GLid, "uLightIndexTexture"), LIGHT_INDEX_TEXTURE_UNIT);
 
         ViewPos         = glm::vec3(0, 0, 0);
         AmbiantLight    = glm::vec3(0, 0, 0);
         NbMoons         = 0;
 
-        floor = new Rectangle(prog_GLid, 20.f, 20.f, true, glm::vec3(0, 1, 0));
-        sky = new Rectangle(prog_GLid, 2, 2, false, glm::vec3(0, 0, 1));
+        floor = arena.create<Rectangle>(arena, prog_GLid, 20.f, 20.f, true, glm::vec3(0, 1, 0));
+        sky = arena.create<Rectangle>(arena, prog_GLid, 2, 2, false, glm::vec3(0, 0, 1));
+
+        // chargement texture: les images sont décodées en parallèle pendant la suite de l'initialisation
+        glimac::AssetLoader loader;
+        auto herbe    = loader.loadImage(applicationPath.dirPath() + "./assets/textures/herbe.jpg", glimac::PixelFormat::RGBA8);
+        auto blueSky  = loader.loadImage(applicationPath.dirPath() + "./assets/textures/BlueSky.jpg", glimac::PixelFormat::RGBA8);
+        auto cloudMap = loader.loadImage(applicationPath.dirPath() + "./assets/textures/CloudMap.jpg", glimac::PixelFormat::RGBA8);
 
-        // chargement texture
-        floor->material->uTextures[0] = glimac::loadImage(applicationPath.dirPath() + "./assets/textures/herbe.jpg");
         floor->material->hasTexture   = true;
         floor->material->NbTextures   = 1;
 
-        sky->material->uTextures[0] = glimac::loadImage(applicationPath.dirPath() + "./assets/textures/BlueSky.jpg");
-        sky->material->uTextures[1]   = glimac::loadImage(applicationPath.dirPath() + "./assets/textures/CloudMap.jpg");
         sky->material->hasTexture     = true;
         sky->material->NbTextures     = 2;
 
-        circuit  = new Circuit(prog_GLid);
-        wagon = new Wagon(prog_GLid);
+        circuit  = arena.create<Circuit>(arena, prog_GLid);
+        wagon = arena.create<Wagon>(arena, prog_GLid);
 
-        t_camera = new glimac::TrackballCamera();
-        f_camera = new glimac::FreeFlyCamera();
+        t_camera = arena.create<glimac::TrackballCamera>();
+        f_camera = arena.create<glimac::FreeFlyCamera>();
         freeView = false;
 
-        // Création d'une sphère
-        sphere = new glimac::Sphere(1, 64, 32);
+        floor->material->uTextures[0] = herbe.get();
+        sky->material->uTextures[0]   = blueSky.get();
+        sky->material->uTextures[1]   = cloudMap.get();
+
+        // Envoi des maillages au GPU
+        // sphère (lampes) et cylindre (tronçons): 4 niveaux de détail, choisis d'après la taille à l'écran
+        meshes.addLOD("sphere", glimac::Sphere::createLODChain(1, 64, 32));
+        const glimac::MeshLOD& cylindreLOD = meshes.addLOD("cylindre", glimac::Cylindre::createLODChain(1, circuit->TubeRadius, 20, 20));
+        // sol, ciel et wagon en sommets compressés (16 octets au lieu de 32, voir glimac::PackedVertex)
+        meshes.add("floor", floor->vertices, floor->indices, glimac::VertexFormat::Packed);
+        meshes.add("sky", sky->vertices, sky->indices, glimac::VertexFormat::Packed);
+        meshes.add("wagon", *wagon->WagonObject, glimac::VertexFormat::Packed);
+
+        for (size_t i = 0; i < cylindreLOD.getLevelCount(); i++) {
+            circuit->Instances.emplace_back(new glimac::InstanceBuffer(cylindreLOD.getLevel(i)));
+        }
+    }
 
-        // Création d'un cylindre
-        cylindre = new glimac::Cylindre(1, .03, 20, 20);
+    // Crée les entités de la scène, une fois les lampes générées: les matrices locales constantes sont
+    // données ici, celles qui bougent sont mises à jour à chaque frame
+    void BuildScene()
+    {
+        scene.reserve(6 + Lampes.size());
+
+        Materials.resize(MATERIAL_LAMP + Lampes.size());
+        Materials[MATERIAL_CIRCUIT] = circuit->CircuitMaterial;
+        Materials[MATERIAL_FLOOR]   = floor->material;
+        Materials[MATERIAL_SKY]     = sky->material;
+        Materials[MATERIAL_WAGON]   = wagon->WagonMaterial;
+        for (size_t i = 0; i < Lampes.size(); i++) {
+            Materials[MATERIAL_LAMP + i] = Lampes[i];
+        }
+
+        circuitEntity = scene.create();
+        scene.setMesh(circuitEntity, MESH_CIRCUIT);
+        scene.setMaterial(circuitEntity, MATERIAL_CIRCUIT);
+
+        floorEntity = scene.create(glimac::NO_ENTITY, glm::translate(glm::mat4(1.f), glm::vec3(-10, floorElevation, -10)));
+        scene.setMesh(floorEntity, MESH_FLOOR);
+        scene.setMaterial(floorEntity, MATERIAL_FLOOR);
+        scene.setLocalBounds(floorEntity, floor->Bounds);
+
+        glm::mat4 skyMatrix = glm::translate(glm::mat4(1.f), glm::vec3(-50, floorElevation + skyElevation, -50));
+        skyEntity = scene.create(glimac::NO_ENTITY, glm::scale(skyMatrix, glm::vec3(100, 1, 100)));
+        scene.setMesh(skyEntity, MESH_SKY);
+        scene.setMaterial(skyEntity, MATERIAL_SKY);
+        scene.setLocalBounds(skyEntity, sky->Bounds);
+
+        // pivot: position et orientation sur le circuit, le modèle est recentré et réduit par rapport à lui
+        wagonPivot = scene.create();
+        glm::mat4 wagonMatrix = glm::translate(glm::mat4(1.f), glm::vec3(-0.2, 0.09f, -0.1f));
+        wagonEntity = scene.create(wagonPivot, glm::scale(wagonMatrix, glm::vec3(0.1f)));
+        scene.setMesh(wagonEntity, MESH_WAGON);
+        scene.setMaterial(wagonEntity, MATERIAL_WAGON);
+        scene.setLocalBounds(wagonEntity, wagon->WagonObject->getBoundingBox());
+
+        // pivot: rotation commune des lampes autour de l'axe y
+        lampPivot = scene.create();
+        float lampRadius = meshes.getLOD("sphere").getBoundingRadius();
+        for (size_t i = 0; i < Lampes.size(); i++) {
+            glimac::Entity lamp = scene.create(lampPivot);
+            scene.setMesh(lamp, MESH_LAMP);
+            scene.setMaterial(lamp, MATERIAL_LAMP + i);
+            scene.setLocalBounds(lamp, glimac::BBox3f(glm::vec3(-lampRadius), glm::vec3(lampRadius)));
+            lampEntities.push_back(lamp);
+        }
     }
 
-    void ChargeGLints()
+    // Viewport, projection et grille de clusters suivent la taille du framebuffer (en pixels), ensemble
+    void Resize(int width, int height)
     {
-        glUniform3f(AmbiantLight_gl, AmbiantLight.x, AmbiantLight.y, AmbiantLight.z);
-        glUniform3f(ViewPos_gl, ViewPos.x, ViewPos.y, ViewPos.z);
-        glUniform2f(NbLights_gl, NbLights.x, NbLights.y);
+        glViewport(0, 0, width, height);
+        projMatrix = glm::perspective(glm::radians(70.f), float(width) / float(height), zNear, zFar);
+        lightClusters.setProjection(projMatrix, zNear, zFar);
+    }
+
+    // Matrices de vue et de projection, position de la caméra et lumière ambiante: un seul envoi
+    void ChargeFrameUniforms()
+    {
+        frameUniforms.ViewMatrix   = globalMVMatrix;
+        frameUniforms.ProjMatrix   = projMatrix;
+        frameUniforms.ViewPos      = glm::vec4(ViewPos, 1);
+        frameUniforms.AmbiantLight = glm::vec4(AmbiantLight, 1);
+        frameBuffer.update(&frameUniforms, sizeof(FrameUniforms));
+    }
+
+    // Range les lumières ponctuelles dans les clusters et envoie toutes les données d'éclairage (bloc LightData
+    // et textures des lumières, des clusters et des indices). lightMVMatrix place les positions des lumières
+    // ponctuelles dans le repère de la vue
+    void ChargeLights(const glm::mat4& lightMVMatrix, const std::vector<glm::vec3>& pointLightPositions)
+    {
+        pointLightTexels.clear();
+        pointLightSpheres.clear();
+        for (size_t i = 0; i < PointLights.size(); i++) {
+            PointLightTexels texels = PointLights[i]->GetTexels(glm::vec3(lightMVMatrix * glm::vec4(pointLightPositions[i], 1)));
+            pointLightTexels.push_back(texels);
+            pointLightSpheres.push_back(glm::vec4(texels.position, texels.radius));
+        }
+
+        // la projection de la grille est mise à jour par Resize
+        lightClusters.build(pointLightSpheres.data(), pointLightSpheres.size());
+
+        // une texture vide n'est pas valide: au moins un texel. Chaque texture reste bindée sur son unité
+        const glm::vec4 noTexels[2] = {};
+        const uint32_t  noIndex     = 0;
+        pointLightTexture.upload(pointLightTexels.empty() ? noTexels : (const void*)pointLightTexels.data(), std::max<size_t>(2 * pointLightTexels.size(), 2));
+        clusterTexture.upload(lightClusters.getClusters().data(), lightClusters.getClusterCount());
+        lightIndexTexture.upload(lightClusters.getLightIndices().empty() ? &noIndex : lightClusters.getLightIndices().data(),
+                                 std::max<size_t>(lightClusters.getLightIndices().size(), 1));
+
+        size_t nbDirLights         = std::min(DirLights.size(), size_t(MAX_DIR_LIGHTS));
+        glm::vec2 depthScale       = lightClusters.getDepthScale();
+        lightUniforms.Count        = glm::ivec4(nbDirLights, PointLights.size(), 0, 0);
+        lightUniforms.ClusterScale = glm::vec4(float(lightClusters.getTileCountX()) / framebuffer_width, float(lightClusters.getTileCountY()) / framebuffer_height,
+                                               depthScale.x, depthScale.y);
+        lightUniforms.ClusterGrid  = glm::ivec4(lightClusters.getTileCountX(), lightClusters.getTileCountY(), lightClusters.getSliceCount(), 0);
+        for (size_t i = 0; i < nbDirLights; i++) {
+            lightUniforms.DirLights[i] = DirLights[i]->GetUniforms();
+        }
+        lightBuffer.update(&lightUniforms, offsetof(LightUniforms, DirLights) + nbDirLights * sizeof(DirLightUniforms));
     }
 };
 
 /* GENERAL POINTERS */
-GLFWwindow*   window;
-GeneralInfos* generalInfos;
+GLFWwindow*                   window;
+std::unique_ptr<GeneralInfos> generalInfos;
 
 /* METHODS */
 
@@ -477,6 +785,17 @@ static void size_callback(GLFWwindow* /*window*/, int width, int height)
     window_height = height;
 }
 
+static void framebuffer_size_callback(GLFWwindow* /*window*/, int width, int height)
+{
+    // fenêtre réduite: taille nulle, on garde la projection précédente
+    if (width <= 0 || height <= 0)
+        return;
+    framebuffer_width  = width;
+    framebuffer_height = height;
+    if (generalInfos)
+        generalInfos->Resize(width, height);
+}
+
 void HandleContinuousEvents()
 {
 
@@ -529,46 +848,20 @@ void HandleContinuousEvents()
     }
 }
 
-void CircuitGeneration(GLuint vbo)
+// Dessine le circuit, chaque tronçon étant une instance du cylindre
+void DrawCircuit()
 {
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, generalInfos->cylindre->getVertexCount() * sizeof(glimac::ShapeVertex), generalInfos->cylindre->getDataPointer(), GL_STATIC_DRAW);
-
     Circuit * circuit = generalInfos->circuit;
 
-    for (int i = 0; i < circuit->NbCircuitPoints; i++) {
-        circuit->CircuitMaterial->color = circuit->CircuitColors[i];
-
-        glm::vec3 Pstart = circuit->CircuitParts[i];
-        glm::vec3 Pend   = (circuit->NbCircuitPoints - 1 == i) ? circuit->CircuitParts[0] : circuit->CircuitParts[i + 1];
-
-        glm::vec3 direction = glm::normalize(Pend - Pstart);
-        glm::vec3 cylinderDirection = glm::vec3(0, 0, 1);
-
-        float angle = glm::radians(180.f); // set a 180 au cas ou parallele et opposés
-        glm::vec3 axis = glm::cross(cylinderDirection, direction); // axis around which to turn
-        if (glm::length(axis) > 0.01f)
-            angle = glm::acos(glm::dot(cylinderDirection, direction));
-        else{ // si les vecteurs sont paralleles
-            // si dans le meme sens, pas de changement
-            if (glm::dot(glm::normalize(cylinderDirection), glm::normalize(direction)) >= 0.f) angle = 0.f;
-            axis = glm::vec3(0, 1, 0); // on prend un axe qulconque a 90° de l'axe du cylindre (0,0,1)
-        }
-
-        glm::mat4 circuitMVMatrix = generalInfos->globalMVMatrix;
-        circuitMVMatrix           = glm::translate(circuitMVMatrix, Pstart); // move to start
-        circuitMVMatrix           = glm::rotate(circuitMVMatrix, angle, axis); // rotate towards end
-        circuitMVMatrix           = glm::scale(circuitMVMatrix, glm::vec3(1, 1, glm::length(Pend - Pstart))); // scale to length
-
-        circuit->CircuitMaterial->ChargeMatrices(circuitMVMatrix, generalInfos->projMatrix);
-        circuit->CircuitMaterial->ChargeGLints();
-
-        glDrawArrays(GL_TRIANGLES, 0, generalInfos->cylindre->getVertexCount());
-    }
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // tous les tronçons sont dessinés au même niveau de détail, celui du plus proche de la caméra:
+    // c'est le diamètre du tube qui compte à l'écran, pas la longueur du tronçon
+    glm::vec3 cameraPosition(glm::inverse(generalInfos->globalMVMatrix)[3]);
+    float     screenSize = glimac::computeScreenSize(circuit->TubeRadius, circuit->NearestDistance(cameraPosition), generalInfos->projMatrix, window_height);
+    circuit->Instances[generalInfos->meshes.getLOD("cylindre").selectLevel(screenSize)]->draw();
 }
 
-void DrawWagon(GLuint vbo){
+// Avance le wagon sur le circuit et calcule sa matrice monde (même s'il n'est pas dessiné)
+void UpdateWagon(){
     // préparations
     Wagon* wagon = generalInfos->wagon;
     Circuit* circuit = generalInfos->circuit;
@@ -616,54 +909,79 @@ void DrawWagon(GLuint vbo){
         axis = glm::vec3(0, 1, 0); // on prend un axe qulconque a 90° de l'axe du wagon
     }
 
-    // matrice de mouvement
-    glm::mat4 wagonMVMatrix = generalInfos->globalMVMatrix;
-    wagonMVMatrix           = glm::translate(wagonMVMatrix, wagon->Position);
-    wagonMVMatrix           = glm::rotate(wagonMVMatrix, angle, axis); // rotate towards end
-    wagonMVMatrix           = glm::translate(wagonMVMatrix, glm::vec3(-0.2, 0.09f, -0.1f));
-    wagonMVMatrix           = glm::scale(wagonMVMatrix, glm::vec3(0.1f));
-
-    // chargement des infos
-    wagon->WagonMaterial->ChargeMatrices(wagonMVMatrix, generalInfos->projMatrix);
-    wagon->WagonMaterial->ChargeGLints();
-
-    // dessin
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, wagon->WagonObject->getVertexCount() * sizeof(unsigned int), wagon->WagonObject->getVertexBuffer(), GL_STATIC_DRAW);
-    glDrawElements(GL_TRIANGLES, wagon->WagonObject->getIndexCount(), GL_UNSIGNED_INT, wagon->WagonObject->getIndexBuffer());
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // matrice de mouvement du pivot
+    glm::mat4 wagonPivotMatrix = glm::translate(glm::mat4(1.f), wagon->Position);
+    wagonPivotMatrix           = glm::rotate(wagonPivotMatrix, angle, axis); // rotate towards end
+    generalInfos->scene.setLocalMatrix(generalInfos->wagonPivot, wagonPivotMatrix);
 }
 
-void DrawFloor(GLuint vbo){
-    glm::mat4 floorMVMatrix = generalInfos->globalMVMatrix;
-    floorMVMatrix           = glm::translate(floorMVMatrix, glm::vec3(-10, generalInfos->floorElevation, -10));
-
-    // charge les infos
-    generalInfos->floor->material->ChargeMatrices(floorMVMatrix, generalInfos->projMatrix);
-    generalInfos->floor->material->ChargeGLints();
-
-    // dessin
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, generalInfos->floor->numVertices * sizeof(glimac::ShapeVertex), &generalInfos->floor->vertices[0], GL_STATIC_DRAW);
-    glDrawElements(GL_TRIANGLES, generalInfos->floor->numIndices, GL_UNSIGNED_INT, generalInfos->floor->indices.data());
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+// Dessine un maillage de la scène, les uniformes du matériau étant déjà chargés
+void DrawMesh(uint32_t mesh, const glm::mat4& MVMatrix)
+{
+    switch (mesh) {
+    case MESH_CIRCUIT:
+        // la matrice modèle de chaque tronçon est dans le buffer d'instances
+        DrawCircuit();
+        break;
+    case MESH_FLOOR:
+        generalInfos->meshes.get("floor").draw();
+        break;
+    case MESH_SKY:
+        generalInfos->meshes.get("sky").draw();
+        break;
+    case MESH_WAGON:
+        generalInfos->meshes.get("wagon").draw();
+        break;
+    case MESH_LAMP: {
+        const glimac::MeshLOD& sphereLOD = generalInfos->meshes.getLOD("sphere");
+        sphereLOD.select(glimac::computeScreenSize(sphereLOD.getBoundingRadius(), MVMatrix, generalInfos->projMatrix, window_height)).draw();
+        break;
+    }
+    }
+}
 
+// Une commande par entité visible: la clé regroupe les entités de même matériau, texture et maillage,
+// puis les trie de l'avant vers l'arrière
+void SubmitVisibleEntities()
+{
+    glimac::Scene&       scene   = generalInfos->scene;
+    glimac::RenderQueue& queue   = generalInfos->renderQueue;
+    const auto&          visible = generalInfos->visible;
+
+    queue.clear();
+    for (glimac::Entity entity = 0; entity < scene.size(); entity++) {
+        if (!visible[entity])
+            continue;
+
+        uint32_t material = scene.getMaterial(entity);
+        glm::vec3 center  = (scene.getWorldBounds(entity).lower + scene.getWorldBounds(entity).upper) * 0.5f;
+        float     depth   = -(generalInfos->globalMVMatrix * glm::vec4(center, 1)).z / zFar;
+        queue.submit(glimac::RenderQueue::makeKey(0, material, generalInfos->Materials[material]->GetTextureKey(), scene.getMesh(entity), depth), entity);
+    }
+    queue.sort();
 }
 
-void DrawSky(GLuint vbo){
-    glm::mat4 SkyMVMatrix = generalInfos->globalMVMatrix;
-    SkyMVMatrix           = glm::translate(SkyMVMatrix, glm::vec3(-50, generalInfos->floorElevation + generalInfos->skyElevation, -50));
-    SkyMVMatrix           = glm::scale(SkyMVMatrix, glm::vec3(100, 1, 100));
+// Exécute les commandes dans l'ordre des clés: les uniformes d'un matériau ne sont envoyés qu'à son
+// premier draw, les binds redondants de VAO et de textures sont sautés par GLState
+void ExecuteRenderQueue()
+{
+    glimac::Scene& scene        = generalInfos->scene;
+    uint32_t       lastMaterial = std::numeric_limits<uint32_t>::max();
+
+    for (const glimac::RenderCommand& command : generalInfos->renderQueue.getCommands()) {
+        glimac::Entity entity   = command.payload;
+        uint32_t       material = scene.getMaterial(entity);
+        Material*      data     = generalInfos->Materials[material];
 
-    // charge les infos
-    generalInfos->sky->material->ChargeMatrices(SkyMVMatrix, generalInfos->projMatrix);
-    generalInfos->sky->material->ChargeGLints();
+        if (material != lastMaterial) {
+            data->ChargeGLints();
+            lastMaterial = material;
+        }
 
-    // dessin
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, generalInfos->sky->numVertices * sizeof(glimac::ShapeVertex), &generalInfos->sky->vertices[0], GL_STATIC_DRAW);
-    glDrawElements(GL_TRIANGLES, generalInfos->sky->numIndices, GL_UNSIGNED_INT, generalInfos->sky->indices.data());
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glm::mat4 MVMatrix = generalInfos->globalMVMatrix * scene.getWorldMatrix(entity);
+        data->ChargeMatrices(MVMatrix);
+        DrawMesh(scene.getMesh(entity), MVMatrix);
+    }
 }
 
 /* MAIN */
@@ -701,6 +1019,8 @@ int main(int argc, char* argv[])
     glfwSetKeyCallback(window, &key_callback);
     glfwSetCursorPosCallback(window, &cursor_position_callback);
     glfwSetWindowSizeCallback(window, &size_callback);
+    glfwSetFramebufferSizeCallback(window, &framebuffer_size_callback);
+    glfwGetFramebufferSize(window, &framebuffer_width, &framebuffer_height);
 
     glimac::FilePath applicationPath(argv[0]);
 
@@ -714,39 +1034,35 @@ int main(int argc, char* argv[])
     /* CREATE ALL THINGS */
 
     // infos générales
-    generalInfos = new GeneralInfos(program.getGLId(), applicationPath);
+    generalInfos.reset(new GeneralInfos(program.getGLId(), applicationPath));
 
     // les lumieres
     // set ambiant light infos and charge in shaders
     generalInfos->AmbiantLight = glm::vec3(0.2, 0.2, 0.2);
 
     // set dirlight info
-    generalInfos->DirLights.push_back(new DirLight(program.getGLId(), 0));
+    generalInfos->DirLights.push_back(generalInfos->arena.create<DirLight>());
     DirLight* dirlight1     = generalInfos->DirLights[0];
     dirlight1->direction     = glm::vec3(-1, -1, -1);
     dirlight1->intensity    = 1.f;
     dirlight1->color        = glm::vec3(1, 1, 1);
 
     // set point light infos
-    generalInfos->PointLights.push_back(new PointLight(program.getGLId(), 0));
+    generalInfos->PointLights.push_back(generalInfos->arena.create<PointLight>());
     PointLight* pointlight1 = generalInfos->PointLights[0];
     pointlight1->position   = glm::vec3(2, 10, 3);
     pointlight1->intensity  = 2.f;
     pointlight1->color      = glm::vec3(1, 0, 0);
 
-    generalInfos->PointLights.push_back(new PointLight(program.getGLId(), 1));
+    generalInfos->PointLights.push_back(generalInfos->arena.create<PointLight>());
     PointLight* pointlight2 = generalInfos->PointLights[1];
     pointlight2->position   = glm::vec3(2, 10, -3);
     pointlight2->intensity  = 2.f;
     pointlight2->color      = glm::vec3(0, 0, 1);
 
     //Material* myLamp = ;
-    generalInfos->Lampes.push_back(pointlight1->GenerateLampe(program.getGLId()));
-    generalInfos->Lampes.push_back(pointlight2->GenerateLampe(program.getGLId()));
-
-    generalInfos->NbLights = glm::vec2(1, 2); // nb dirlights / nb pointlights
-
-    generalInfos->ChargeGLints();
+    generalInfos->Lampes.push_back(pointlight1->GenerateLampe(generalInfos->arena, program.getGLId()));
+    generalInfos->Lampes.push_back(pointlight2->GenerateLampe(generalInfos->arena, program.getGLId()));
 
     // set circuit  infos
     std::vector<glm::vec3> circuit;
@@ -777,14 +1093,15 @@ int main(int argc, char* argv[])
 
     circuit.push_back(glm::vec3(7, 0, 0));
 
-    generalInfos->circuit->CircuitParts    = circuit;
-    generalInfos->circuit->NbCircuitPoints = circuit.size();
-
-    for (int i = 0; i < generalInfos->circuit->NbCircuitPoints; i++)
+    std::vector<glm::vec3> circuitColors;
+    for (size_t i = 0; i < circuit.size(); i++)
     {
-        generalInfos->circuit->CircuitColors.push_back(glm::vec3(randomFloat(1.f), randomFloat(1.f), randomFloat(1.f)));
+        circuitColors.push_back(glm::vec3(randomFloat(1.f), randomFloat(1.f), randomFloat(1.f)));
     }
 
+    // les matrices des tronçons ne seront recalculées que si SetParts est rappelé
+    generalInfos->circuit->SetParts(circuit, circuitColors);
+
     Material* circuitMaterial          = generalInfos->circuit->CircuitMaterial;
     circuitMaterial->color             = glm::vec3(1, 0, 0);
     circuitMaterial->specularIntensity = 1.f;
@@ -800,46 +1117,25 @@ int main(int argc, char* argv[])
     wagonMaterial->hasTexture          = false;
     wagonMaterial->isLamp              = false;
 
+    generalInfos->BuildScene();
+
     /* CALCULATE MATRICES */
-    glm::mat4 projMatrix     = glm::perspective(glm::radians(70.f), float(window_width) / float(window_height), 0.1f, 100.f);
     glm::mat4 globalMVMatrix = glm::translate(glm::mat4(), glm::vec3(0, 0, -5));
 
-    generalInfos->projMatrix = projMatrix;
+    generalInfos->Resize(framebuffer_width, framebuffer_height);
     generalInfos->globalMVMatrix = globalMVMatrix;
 
     /* VBO + VAO */
-    // création du VBO
-    GLuint vbo;
-    glGenBuffers(1, &vbo);
-
-    // Création du VAO
-    GLuint vao;
-    glGenVertexArrays(1, &vao);
-
-    // Binding du VAO
-    glBindVertexArray(vao);
-    const GLint VERTEX_ATTR_POSITION = 0;
-    const GLint VERTEX_ATTR_NORMAL   = 1;
-    const GLint VERTEX_ATTR_TEXCOORDS   = 2;
-    glEnableVertexAttribArray(VERTEX_ATTR_POSITION);
-    glEnableVertexAttribArray(VERTEX_ATTR_NORMAL);
-    glEnableVertexAttribArray(VERTEX_ATTR_TEXCOORDS);
-
-    // Spécification de l'attribut de sommet et de normal
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glVertexAttribPointer(VERTEX_ATTR_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(glimac::ShapeVertex), (const GLvoid*)offsetof(glimac::ShapeVertex, position));
-    glVertexAttribPointer(VERTEX_ATTR_NORMAL, 3, GL_FLOAT, GL_FALSE, sizeof(glimac::ShapeVertex), (const GLvoid*)offsetof(glimac::ShapeVertex, normal));
-    glVertexAttribPointer(VERTEX_ATTR_TEXCOORDS, 2, GL_FLOAT, GL_FALSE, sizeof(glimac::ShapeVertex), (const GLvoid*)offsetof(glimac::ShapeVertex, texCoords));
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    // Débinding du VAO
-    glBindVertexArray(0);
-
+    // chaque maillage a déjà son VBO / IBO / VAO (voir GeneralInfos::meshes)
 
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
+    double lastStatsTime = glfwGetTime();
+
     /* Loop until the user closes the window */
     while (!glfwWindowShouldClose(window)) {
+        glimac::RenderStats::beginFrame();
+
         /* EVENTS */
         glfwPollEvents();
         HandleContinuousEvents();
@@ -853,89 +1149,84 @@ int main(int argc, char* argv[])
             ViewMatrix = generalInfos->f_camera->getViewMatrix();
 
         generalInfos->ViewPos = glm::vec3(ViewMatrix[0][0], ViewMatrix[0][1], ViewMatrix[0][2]);
-        generalInfos->ChargeGLints();
 
         // clear window
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         // get camera matrix
         generalInfos->globalMVMatrix = ViewMatrix;
-
-        // send Matrixes values to shader
-        circuitMaterial->ChargeMatrices(generalInfos->globalMVMatrix, generalInfos->projMatrix);
-
-        glBindVertexArray(vao);
+        generalInfos->ChargeFrameUniforms();
 
         /* GESTION LUMIERE */
 
-        DirLight* dirlight1 = generalInfos->DirLights[0];
-
         PointLight* pointLight1 = generalInfos->PointLights[0];
         PointLight* pointLight2 = generalInfos->PointLights[1];
 
-        glm::vec3 light1Pos(pointLight1->position.x, (pointLight1->position.y * glm::cos((float)glfwGetTime()) * glm::sin((float)glfwGetTime()) < generalInfos->floorElevation) ? generalInfos->floorElevation + 0.1f : pointLight1->position.y * glm::cos((float)glfwGetTime()) * glm::sin((float)glfwGetTime()), pointLight1->position.z);
-        glm::mat4 light1MVMatrix = glm::rotate(generalInfos->globalMVMatrix, (float)glfwGetTime(), glm::vec3(0, 1, 0));
-        glm::vec3 light1Pos_vs(light1MVMatrix * glm::vec4(light1Pos, 1));
+        glimac::Scene& scene = generalInfos->scene;
 
+        glm::vec3 light1Pos(pointLight1->position.x, (pointLight1->position.y * glm::cos((float)glfwGetTime()) * glm::sin((float)glfwGetTime()) < generalInfos->floorElevation) ? generalInfos->floorElevation + 0.1f : pointLight1->position.y * glm::cos((float)glfwGetTime()) * glm::sin((float)glfwGetTime()), pointLight1->position.z);
         glm::vec3 light2Pos(pointLight1->position.x, (pointLight2->position.y * glm::cos((float)glfwGetTime()) * glm::sin((float)glfwGetTime()) < generalInfos->floorElevation) ? generalInfos->floorElevation + 0.1f : pointLight2->position.y * glm::cos((float)glfwGetTime()) * glm::sin((float)glfwGetTime()), pointLight2->position.z);
-        glm::mat4 light2MVMatrix = glm::rotate(generalInfos->globalMVMatrix, (float)glfwGetTime(), glm::vec3(0, 1, 0));
-        glm::vec3 light2Pos_vs(light2MVMatrix * glm::vec4(light2Pos, 1));
-
-        // /* CHARGEMENT LUMIERE */
-        dirlight1->ChargeGLints();
-        pointLight1->ChargeGLints(light1Pos_vs);
-        pointLight2->ChargeGLints(light2Pos_vs);
 
-        /* GENERATION OF CIRCUIT */
-        CircuitGeneration(vbo);
+        // Positionnement des sphères représentant les lumières, qui tournent avec leur pivot
+        scene.setLocalMatrix(generalInfos->lampPivot, glm::rotate(glm::mat4(1.f), (float)glfwGetTime(), glm::vec3(0, 1, 0)));
+        scene.setLocalMatrix(generalInfos->lampEntities[0], glm::scale(glm::translate(glm::mat4(1.f), light1Pos), glm::vec3(.04, .04, .04)));
+        scene.setLocalMatrix(generalInfos->lampEntities[1], glm::scale(glm::translate(glm::mat4(1.f), light2Pos), glm::vec3(.04, .04, .04)));
 
-        // Dessin du sol et ciel
-        DrawFloor(vbo);
-        DrawSky(vbo);
+        // Le wagon avance même quand il n'est pas visible
+        UpdateWagon();
 
-        // Dessin du Wagon
-        DrawWagon(vbo);
-
-        // Positionnement de la sphère représentant la lumière 1
-        light1MVMatrix = glm::translate(light1MVMatrix, glm::vec3(light1Pos));
-        light1MVMatrix = glm::scale(light1MVMatrix, glm::vec3(.04, .04, .04));
-
-        Material* lamp1 = generalInfos->Lampes[0];
-        lamp1->ChargeMatrices(light1MVMatrix, generalInfos->projMatrix);
-
-        /* CHARGEMENT DE LA LAMPE */
-        lamp1->ChargeGLints();
-
-        // Dessin de la sphère représentant la lumière 1
-        glBindBuffer(GL_ARRAY_BUFFER, vbo);
-        glBufferData(GL_ARRAY_BUFFER, generalInfos->sphere->getVertexCount() * sizeof(glimac::ShapeVertex), generalInfos->sphere->getDataPointer(), GL_STATIC_DRAW);
-        glDrawArrays(GL_TRIANGLES, 0, generalInfos->sphere->getVertexCount());
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        // les parties du circuit sont déjà dans le repère monde, leur boîte ne change qu'avec les points
+        if (generalInfos->circuitBoundsVersion != generalInfos->circuit->Version) {
+            scene.setLocalBounds(generalInfos->circuitEntity, generalInfos->circuit->GetBounds());
+            generalInfos->circuitBoundsVersion = generalInfos->circuit->Version;
+        }
 
-        // Positionnement de la sphère représentant la lumière 2
-        light2MVMatrix = glm::translate(light2MVMatrix, glm::vec3(light2Pos));
-        light2MVMatrix = glm::scale(light2MVMatrix, glm::vec3(.04, .04, .04));
+        /* MISE A JOUR DE LA SCENE */
+        scene.updateWorldMatrices();
 
-        Material* lamp2 = generalInfos->Lampes[1];
-        lamp2->ChargeMatrices(light2MVMatrix, generalInfos->projMatrix);
+        // /* CHARGEMENT LUMIERE */
+        // les lumières ponctuelles tournent avec le pivot des lampes
+        std::vector<glm::vec3> pointLightPositions;
+        pointLightPositions.push_back(light1Pos);
+        pointLightPositions.push_back(light2Pos);
+        generalInfos->ChargeLights(generalInfos->globalMVMatrix * scene.getWorldMatrix(generalInfos->lampPivot), pointLightPositions);
 
-        /* CHARGEMENT DE LA LAMPE */
-        lamp2->ChargeGLints();
+        /* FRUSTUM CULLING */
+        // boîtes englobantes monde de toutes les entités, testées ensemble contre la pyramide de vue
+        std::vector<unsigned char>& visible = generalInfos->visible;
+        size_t visibleCount = scene.cull(glimac::Frustum(generalInfos->projMatrix * ViewMatrix), visible);
+        glimac::RenderStats::addCulling(visibleCount, scene.getDrawableCount() - visibleCount);
 
-        // Dessin de la sphère représentant la lumière 2
-        glBindBuffer(GL_ARRAY_BUFFER, vbo);
-        glBufferData(GL_ARRAY_BUFFER, generalInfos->sphere->getVertexCount() * sizeof(glimac::ShapeVertex), generalInfos->sphere->getDataPointer(), GL_STATIC_DRAW);
-        glDrawArrays(GL_TRIANGLES, 0, generalInfos->sphere->getVertexCount());
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        // la table des tronçons n'est renvoyée au GPU que si le circuit a changé
+        generalInfos->circuit->UpdateInstances();
 
-        glBindVertexArray(0);
+        /* DESSIN */
+        SubmitVisibleEntities();
+        ExecuteRenderQueue();
 
         /* Swap front and back buffers */
         glfwSwapBuffers(window);
+
+        // statistiques de la dernière frame, affichées dans le titre une fois par seconde
+        if (glfwGetTime() - lastStatsTime >= 1.) {
+            char title[256];
+            sprintf(title, "Projet - %zu triangles, %zu draw calls, %zu objets visibles, %zu hors champ, %zu changements d'état (%zu matériaux, %zu VAO, %zu textures)",
+                    glimac::RenderStats::getTriangleCount(), glimac::RenderStats::getDrawCallCount(),
+                    glimac::RenderStats::getVisibleObjectCount(), glimac::RenderStats::getCulledObjectCount(), glimac::RenderStats::getStateChangeCount(),
+                    glimac::RenderStats::getStateChangeCount(glimac::RenderStats::MATERIAL_CHANGE),
+                    glimac::RenderStats::getStateChangeCount(glimac::RenderStats::VERTEX_ARRAY_CHANGE),
+                    glimac::RenderStats::getStateChangeCount(glimac::RenderStats::TEXTURE_CHANGE));
+            glfwSetWindowTitle(window, title);
+            lastStatsTime = glfwGetTime();
+        }
     }
 
-    glDeleteBuffers(1, &vbo);
-    glDeleteVertexArrays(1, &vao);
+    generalInfos->circuit->Instances.clear();
+    generalInfos->meshes.clear();
+    glimac::TextureManager::clear();
+
+    // détruit tous les objets de l'arène
+    generalInfos.reset();
 
     glfwTerminate();
 
@@ -5,21 +5,65 @@ layout(location = 0) in vec3 aVertexPosition;
 layout(location = 1) in vec3 aVertexNormal;
 layout(location = 2) in vec2 aVertexTexCoords;
 
-uniform mat4 uMVPMatrix;
+// attributs par instance (rendu instancié du circuit)
+layout(location = 3) in mat4 aInstanceModel;
+layout(location = 7) in mat3 aInstanceNormal;
+layout(location = 10) in vec3 aInstanceColor;
+
+// décodage des sommets compressés (glimac::PackedVertex), constants pour tout un maillage:
+// si aPositionScale.w vaut 1, la position est dans [0, 1] relativement à la boîte englobante
+// et la normale est en projection octaédrique dans aVertexNormal.xy
+layout(location = 11) in vec4 aPositionScale;
+layout(location = 12) in vec3 aPositionOffset;
+
+// même bloc que dans lights.fs.glsl
+layout(std140) uniform FrameData {
+    mat4 uViewMatrix;
+    mat4 uProjMatrix;
+    vec4 uViewPos;
+    vec4 uAmbiantLight;
+};
+
 uniform mat4 uMVMatrix;
 uniform mat4 uNormalMatrix;
 
+// si vrai, les matrices uniformes ne contiennent que la vue et le modèle vient de l'instance
+uniform bool uInstanced;
+
 out vec3 vPosition_vs;
 out vec3 vNormal_vs;
 out vec2 vTexCoords;
+out vec3 vInstanceColor;
+
+vec3 decodeOctahedral(vec2 e){
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
 
 void main(){
-    vec4 vertexPosition = vec4(aVertexPosition, 1);
-    vec4 vertexNormal = vec4(aVertexNormal, 0);
+    vec3 position = aVertexPosition;
+    vec3 normal = aVertexNormal;
+    if(aPositionScale.w > 0.5){
+        position = aPositionOffset + aVertexPosition * aPositionScale.xyz;
+        normal = decodeOctahedral(aVertexNormal.xy);
+    }
+
+    vec4 vertexPosition = vec4(position, 1);
+    vec4 vertexNormal = vec4(normal, 0);
+    vInstanceColor = vec3(0);
+
+    if(uInstanced){
+        vertexPosition = aInstanceModel * vertexPosition;
+        vertexNormal = vec4(aInstanceNormal * normal, 0);
+        vInstanceColor = aInstanceColor;
+    }
 
     vPosition_vs = vec3(uMVMatrix * vertexPosition);
     vNormal_vs = vec3(uNormalMatrix * vertexNormal);
     vTexCoords = aVertexTexCoords;
 
-    gl_Position =  uMVPMatrix * vertexPosition;
+    gl_Position =  uProjMatrix * vec4(vPosition_vs, 1);
 };
\ No newline at end of file
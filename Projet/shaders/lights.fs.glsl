@@ -1,8 +1,10 @@
 #version 300 es
 precision mediump float;
+precision highp int; // indices de lumières et de clusters
 
 /* STRUCTURES */
-#define MAX_LIGHTS 10
+// doit correspondre à MAX_DIR_LIGHTS dans main.cpp (taille du bloc LightData)
+#define MAX_DIR_LIGHTS 16
 #define MAX_TEXTURES 2
 
 struct Material {
@@ -22,28 +24,43 @@ struct DirLight {
 
 struct PointLight {
     vec3 position;
-    float intensity; // lamp intensity
+    float radius; // au-delà, la lumière n'éclaire plus (elle n'est rangée que dans les clusters qu'elle touche)
     vec3 color; // lamp color
+    float intensity; // lamp intensity
 };
 
 /* IN VARIABLES */
 in vec3 vPosition_vs;
 in vec3 vNormal_vs;
 in vec2 vTexCoords; // Coordonnées de texture du sommet
+in vec3 vInstanceColor; // couleur de l'instance (rendu instancié)
 
 /* UNIFORM VARIABLES */
-uniform vec3 uViewPos; // position camera
-
-uniform Material uMaterial;
+// blocs std140 envoyés une fois par frame (un UBO chacun)
+layout(std140) uniform FrameData {
+    mat4 uViewMatrix;
+    mat4 uProjMatrix;
+    vec4 uViewPos; // position camera (xyz)
+    vec4 uAmbiantLight; // xyz
+};
 
 // LIGHTS
-uniform DirLight[MAX_LIGHTS] uDirLights;
+layout(std140) uniform LightData {
+    ivec4 uLightCount; // x dir lights, y point lights
+    highp vec4 uClusterScale; // xy: tuiles par pixel, zw: tranche = log(profondeur) * z + w
+    ivec4 uClusterGrid; // x, y: nombre de tuiles, z: nombre de tranches
+    DirLight uDirLights[MAX_DIR_LIGHTS];
+};
 
-uniform PointLight[MAX_LIGHTS] uPointLights;
+// lumières ponctuelles (repère de la vue) et clusters, lus avec texelFetch: l'élément i d'une texture
+// de largeur w est le texel (i % w, i / w)
+uniform highp sampler2D uPointLightTexture; // 2 texels par lumière: position + rayon, couleur + intensité
+uniform highp usampler2D uClusterTexture; // un texel par cluster: début et nombre de ses lumières dans uLightIndexTexture
+uniform highp usampler2D uLightIndexTexture; // indices des lumières, cluster par cluster
 
-uniform vec2 NbLights; // x dir lights, y point lights
+uniform Material uMaterial;
 
-uniform vec3 uAmbiantLight;
+uniform bool uInstanced;
 
 /* OUT VARIABLES */
 out vec3 fFragColor;
@@ -59,7 +76,7 @@ vec3 CalcDirLight(DirLight light){
 	if(diff > 0.f){
 		diffColor = vec3(light.color * light.intensity * diff);
 
-		vec3 vertToEye = normalize(uViewPos - vPosition_vs);
+		vec3 vertToEye = normalize(uViewPos.xyz - vPosition_vs);
 		vec3 lightReflect = normalize(reflect(-lightdir, vNormal_vs));
 		float spec = dot(vertToEye, lightReflect);
 
@@ -73,9 +90,22 @@ vec3 CalcDirLight(DirLight light){
 	return diffColor + specColor;
 }
 
+ivec2 texelCoords(int index, int width) {
+	return ivec2(index % width, index / width);
+}
+
+PointLight FetchPointLight(int index) {
+	int width = textureSize(uPointLightTexture, 0).x;
+	vec4 positionRadius = texelFetch(uPointLightTexture, texelCoords(2 * index, width), 0);
+	vec4 colorIntensity = texelFetch(uPointLightTexture, texelCoords(2 * index + 1, width), 0);
+	return PointLight(positionRadius.xyz, positionRadius.w, colorIntensity.rgb, colorIntensity.a);
+}
+
 vec3 CalcPointLight(PointLight light) {
 	float d = distance(light.position, vPosition_vs);
-	float Li = light.intensity / (d * d);
+	// atténuation ramenée à 0 au rayon, pour que la coupure aux bords des clusters ne se voie pas
+	float window = clamp(1.0 - pow(d / light.radius, 4.0), 0.0, 1.0);
+	float Li = light.intensity / (d * d) * window * window;
 
 	vec3 lightdir = normalize(light.position - vPosition_vs);
 
@@ -86,7 +116,7 @@ vec3 CalcPointLight(PointLight light) {
 	if(diff > 0.f){
 		diffColor = vec3(light.color * light.intensity * diff);
 
-		vec3 vertToEye = normalize(uViewPos - vPosition_vs);
+		vec3 vertToEye = normalize(uViewPos.xyz - vPosition_vs);
 		vec3 lightReflect = normalize(reflect(-lightdir, vNormal_vs));
 		float spec = dot(vertToEye, lightReflect);
 
@@ -103,19 +133,29 @@ vec3 CalcPointLight(PointLight light) {
 void main() {
 	vec3 result = vec3(1);
 
-	vec3 colorMat = uMaterial.color;
+	vec3 colorMat = uInstanced ? vInstanceColor : uMaterial.color;
 	if(uMaterial.hasTexture){
 		colorMat = texture(uMaterial.textures[0], vTexCoords).rgb + texture(uMaterial.textures[1], vTexCoords).rgb;
 	}
 
 	if(!uMaterial.isLamp){
-		result = uAmbiantLight;
+		result = uAmbiantLight.xyz;
 
-		for(int i = 0; i<int(NbLights.x); i++)
+		for(int i = 0; i<uLightCount.x; i++)
 			result += CalcDirLight(uDirLights[i]);
 
-		for(int i = 0; i<int(NbLights.y); i++)
-			result += CalcPointLight(uPointLights[i]);
+		// seulement les lumières ponctuelles du cluster du fragment
+		highp vec2 tile = gl_FragCoord.xy * uClusterScale.xy;
+		highp float slice = log(-vPosition_vs.z) * uClusterScale.z + uClusterScale.w;
+		ivec3 cluster = clamp(ivec3(ivec2(tile), int(floor(slice))), ivec3(0), uClusterGrid.xyz - 1);
+		int clusterIndex = cluster.x + uClusterGrid.x * (cluster.y + uClusterGrid.y * cluster.z);
+		uvec2 range = texelFetch(uClusterTexture, texelCoords(clusterIndex, textureSize(uClusterTexture, 0).x), 0).xy;
+
+		int indexWidth = textureSize(uLightIndexTexture, 0).x;
+		for(int i = 0; i<int(range.y); i++){
+			int lightIndex = int(texelFetch(uLightIndexTexture, texelCoords(int(range.x) + i, indexWidth), 0).r);
+			result += CalcPointLight(FetchPointLight(lightIndex));
+		}
 	}
 
 	fFragColor = result * colorMat;
@@ -0,0 +1,47 @@
+#include <algorithm>
+#include <thread>
+#include <glimac/AssetLoader.hpp>
+#include "Benchmark.hpp"
+
+// Chargement de quelques dizaines de textures: l'une après l'autre sur le thread principal, contre
+// en parallèle sur un ThreadPool (AssetLoader) de 1 à hardware_concurrency threads
+
+int main() {
+    // les textures du projet, chacune chargée COPY_COUNT fois comme autant d'images distinctes
+    const char* textures[] = { "herbe.jpg", "BlueSky.jpg", "CloudMap.jpg" };
+    const int COPY_COUNT = 16;
+    std::vector<glimac::FilePath> filepaths;
+    for (int copy = 0; copy < COPY_COUNT; ++copy) {
+        for (const char* texture : textures) {
+            filepaths.push_back(glimac::FilePath(GLIMAC_ASSETS_DIR) + "textures/" + texture);
+        }
+    }
+    const unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("%zu images, %u hardware threads\n", filepaths.size(), hardwareThreads);
+
+    double serial = bench::measure([&]() {
+        for (const auto& filepath : filepaths) {
+            bench::doNotOptimize(glimac::loadImage(filepath, glimac::PixelFormat::RGBA8));
+        }
+    });
+    bench::report("serial loadImage", serial);
+
+    for (unsigned int threadCount = 1; threadCount <= hardwareThreads; ++threadCount) {
+        glimac::ThreadPool pool(threadCount);
+        glimac::AssetLoader loader(pool);
+        double parallel = bench::measure([&]() {
+            std::vector<std::future<std::unique_ptr<glimac::Image>>> images;
+            for (const auto& filepath : filepaths) {
+                images.push_back(loader.loadImage(filepath, glimac::PixelFormat::RGBA8));
+            }
+            for (auto& image : images) {
+                bench::doNotOptimize(image.get());
+            }
+        });
+        char name[64];
+        std::snprintf(name, sizeof(name), "AssetLoader, %u thread(s)", threadCount);
+        bench::report(name, parallel);
+        std::printf("  speedup over serial: %.2fx\n", serial / parallel);
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <thread>
+#include <glimac/BBox.hpp>
+#include <glimac/ThreadPool.hpp>
+#include "Benchmark.hpp"
+
+// Boîte englobante de 1M, 10M et 100M points: BBox3f::grow point par point, BBox3f::fromPoints
+// (réduction SSE), puis fromPoints réparti sur un ThreadPool de 1 à hardware_concurrency threads
+
+int main() {
+    const unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t pointCount : { size_t(1000000), size_t(10000000), size_t(100000000) }) {
+        std::vector<glm::vec3> points(pointCount);
+        for (size_t i = 0; i < pointCount; ++i) {
+            points[i] = glm::vec3(float(i % 1013), float(i % 1019) - 500.f, float(i % 1021) * 0.5f);
+        }
+        const double gigabytes = pointCount * sizeof(glm::vec3) / 1e9;
+        std::printf("%zu points (%.1f MB)\n", pointCount, gigabytes * 1000);
+
+        glimac::BBox3f scalar;
+        double milliseconds = bench::measure([&]() {
+            glimac::BBox3f box = glimac::BBox3f::emptyBox();
+            for (const glm::vec3& point : points) {
+                box.grow(point);
+            }
+            bench::doNotOptimize(box);
+            scalar = box;
+        }, 5);
+        bench::report("  scalar grow", milliseconds);
+        std::printf("    %.2f GB/s\n", gigabytes / milliseconds * 1000);
+
+        glimac::BBox3f reduced;
+        milliseconds = bench::measure([&]() {
+            reduced = glimac::BBox3f::fromPoints(points.data(), pointCount);
+            bench::doNotOptimize(reduced);
+        }, 5);
+        bench::report("  fromPoints (SSE)", milliseconds);
+        std::printf("    %.2f GB/s\n", gigabytes / milliseconds * 1000);
+        CHECK(reduced == scalar);
+
+        for (unsigned int threadCount = 1; threadCount <= hardwareThreads; ++threadCount) {
+            glimac::ThreadPool pool(threadCount);
+            milliseconds = bench::measure([&]() {
+                reduced = glimac::BBox3f::fromPoints(points.data(), pointCount, sizeof(glm::vec3), pool);
+                bench::doNotOptimize(reduced);
+            }, 5);
+            char name[64];
+            std::snprintf(name, sizeof(name), "  fromPoints, pool of %u thread(s)", threadCount);
+            bench::report(name, milliseconds);
+            std::printf("    %.2f GB/s\n", gigabytes / milliseconds * 1000);
+            CHECK(reduced == scalar);
+        }
+    }
+    return test::result();
+}
@@ -0,0 +1,105 @@
+#include <cmath>
+#include <random>
+#include <glimac/BVH.hpp>
+#include "Benchmark.hpp"
+
+// BVH de 1k, 100k et 1M petits triangles répartis dans un cube: construction (SAH), puis requêtes depuis
+// des caméras au hasard: queryRay (feuilles traversées par le rayon), closestTriangle (triangle le plus
+// proche, comparé au test de tous les triangles) et queryFrustum (feuilles visibles)
+
+int main() {
+    const int QUERY_COUNT = 1000;
+    const float EXTENT = 100.f;
+    for (size_t triangleCount : { size_t(1000), size_t(100000), size_t(1000000) }) {
+        // La taille des triangles suit leur espacement moyen: le remplissage du cube reste le même
+        std::mt19937 rng(1);
+        const float spacing = 2 * EXTENT / std::cbrt(float(triangleCount));
+        std::uniform_real_distribution<float> position(-EXTENT, EXTENT), offset(-spacing, spacing);
+        std::vector<glm::vec3> positions;
+        std::vector<unsigned int> indices;
+        positions.reserve(3 * triangleCount);
+        indices.reserve(3 * triangleCount);
+        for (size_t i = 0; i < triangleCount; ++i) {
+            glm::vec3 center(position(rng), position(rng), position(rng));
+            for (int corner = 0; corner < 3; ++corner) {
+                indices.push_back(unsigned(positions.size()));
+                positions.push_back(center + glm::vec3(offset(rng), offset(rng), offset(rng)));
+            }
+        }
+        std::printf("%zu triangles\n", triangleCount);
+
+        glimac::BVH bvh;
+        bench::report("  build", bench::measure([&]() {
+            bvh = glimac::BVH::fromTriangles(positions.data(), sizeof(glm::vec3), indices.data(), triangleCount);
+        }, 3));
+        std::printf("    %zu nodes\n", bvh.getNodes().size());
+
+        // Caméras placées au hasard dans le cube, regardant dans une direction quelconque
+        std::vector<glimac::Ray> rays;
+        std::vector<glimac::Frustum> frustums;
+        std::uniform_real_distribution<float> angle(0.f, 6.2831853f);
+        for (int i = 0; i < QUERY_COUNT; ++i) {
+            glm::vec3 eye(position(rng), position(rng), position(rng));
+            glm::vec3 direction(std::cos(angle(rng)), std::sin(angle(rng)) * 0.5f, std::sin(angle(rng)));
+            rays.push_back(glimac::Ray(eye, direction));
+            frustums.push_back(glimac::Frustum(glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.5f, 50.f) *
+                                               glm::lookAt(eye, eye + direction, glm::vec3(0, 1, 0))));
+        }
+
+        std::vector<uint32_t> result;
+        size_t resultCount = 0;
+        double milliseconds = bench::measure([&]() {
+            resultCount = 0;
+            for (const glimac::Ray& ray : rays) {
+                result.clear();
+                bvh.queryRay(ray, result);
+                resultCount += result.size();
+            }
+        });
+        bench::report("  queryRay", milliseconds);
+        std::printf("    %.2f us per ray, %zu candidates per ray\n", milliseconds * 1000 / QUERY_COUNT, resultCount / QUERY_COUNT);
+
+        size_t hitCount = 0;
+        milliseconds = bench::measure([&]() {
+            hitCount = 0;
+            for (const glimac::Ray& ray : rays) {
+                glimac::RayHit hit;
+                hitCount += bvh.closestTriangle(ray, positions.data(), sizeof(glm::vec3), indices.data(), hit);
+            }
+        });
+        bench::report("  closestTriangle", milliseconds);
+        std::printf("    %.2f us per ray, %zu of %d rays hit\n", milliseconds * 1000 / QUERY_COUNT, hitCount, QUERY_COUNT);
+
+        // Référence: chaque rayon testé contre tous les triangles (sur une partie des rayons au-delà de 1k triangles)
+        const int bruteForceCount = triangleCount > 1000 ? 10 : QUERY_COUNT;
+        milliseconds = bench::measure([&]() {
+            for (int i = 0; i < bruteForceCount; ++i) {
+                float nearest = rays[i].tMax;
+                for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+                    float t;
+                    if (glimac::intersectTriangle(rays[i], positions[3 * triangle], positions[3 * triangle + 1], positions[3 * triangle + 2], t) &&
+                        t >= rays[i].tMin && t < nearest) {
+                        nearest = t;
+                    }
+                }
+                bench::doNotOptimize(nearest);
+            }
+        }, 3);
+        char name[64];
+        std::snprintf(name, sizeof(name), "  brute force, scaled from %d rays", bruteForceCount);
+        bench::report(name, milliseconds * QUERY_COUNT / bruteForceCount);
+        std::printf("    %.2f us per ray\n", milliseconds * 1000 / bruteForceCount);
+
+        milliseconds = bench::measure([&]() {
+            resultCount = 0;
+            for (const glimac::Frustum& frustum : frustums) {
+                result.clear();
+                bvh.queryFrustum(frustum, result);
+                resultCount += result.size();
+            }
+        });
+        bench::report("  queryFrustum", milliseconds);
+        std::printf("    %.2f us per frustum, %zu candidates per frustum\n", milliseconds * 1000 / QUERY_COUNT, resultCount / QUERY_COUNT);
+    }
+    return 0;
+}
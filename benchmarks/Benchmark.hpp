@@ -0,0 +1,45 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "TestCommon.hpp"
+
+namespace bench {
+
+// Millisecondes écoulées depuis start
+inline double elapsed(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline double median(std::vector<double> times) {
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+// Médiane en millisecondes de repetitionCount exécutions de function (après une exécution de chauffe)
+template<typename Function>
+double measure(Function&& function, int repetitionCount = 10) {
+    function();
+    std::vector<double> times;
+    times.reserve(repetitionCount);
+    for (int i = 0; i < repetitionCount; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        times.push_back(elapsed(start));
+    }
+    return median(times);
+}
+
+inline void report(const char* name, double milliseconds) {
+    std::printf("%-48s %10.3f ms\n", name, milliseconds);
+}
+
+// Empêche le compilateur de supprimer un calcul dont le résultat n'est pas utilisé
+template<typename T>
+void doNotOptimize(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+}
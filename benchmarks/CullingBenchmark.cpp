@@ -0,0 +1,45 @@
+#include <random>
+#include <glimac/Frustum.hpp>
+#include "Benchmark.hpp"
+
+// Test de 1M boîtes contre le frustum de la caméra: Frustum::testBoxes (plans 4 par 4 avec SSE) contre
+// Frustum::intersects appelé boîte par boîte
+
+int main(int argc, char* argv[]) {
+    const size_t BOX_COUNT = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-100.f, 100.f), size(0.f, 2.f);
+    std::vector<glimac::BBox3f> boxes;
+    boxes.reserve(BOX_COUNT);
+    for (size_t i = 0; i < BOX_COUNT; ++i) {
+        glm::vec3 lower(position(rng), position(rng), position(rng));
+        boxes.push_back(glimac::BBox3f(lower, lower + glm::vec3(size(rng), size(rng), size(rng))));
+    }
+    glimac::Frustum frustum(glm::perspective(glm::radians(70.f), 16.f / 9.f, 0.1f, 100.f) *
+                            glm::lookAt(glm::vec3(0, 5, 0), glm::vec3(1, 5, 1), glm::vec3(0, 1, 0)));
+    std::vector<unsigned char> visible(BOX_COUNT);
+
+    size_t visibleCount = 0;
+    double milliseconds = bench::measure([&]() {
+        visibleCount = frustum.testBoxes(boxes.data(), BOX_COUNT, visible.data());
+    });
+    std::printf("%zu boxes, %zu visible\n", BOX_COUNT, visibleCount);
+    bench::report("testBoxes", milliseconds);
+    std::printf("  %.1f Mboxes/s\n", BOX_COUNT / milliseconds / 1000.);
+
+    size_t intersectCount = 0;
+    milliseconds = bench::measure([&]() {
+        intersectCount = 0;
+        for (size_t i = 0; i < BOX_COUNT; ++i) {
+            visible[i] = frustum.intersects(boxes[i]);
+            intersectCount += visible[i];
+        }
+    });
+    bench::report("intersects, one box at a time", milliseconds);
+    std::printf("  %.1f Mboxes/s\n", BOX_COUNT / milliseconds / 1000.);
+    if (intersectCount != visibleCount) {
+        std::fprintf(stderr, "testBoxes found %zu visible boxes, intersects %zu\n", visibleCount, intersectCount);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,324 @@
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <glimac/Image.hpp>
+#include "Benchmark.hpp"
+
+// Chargement des textures du projet, puis de JPEG 4K et 8K générés: conversion en flottants (RGBA32F)
+// contre buffer décodé gardé tel quel (RGBA8)
+
+static bool benchmarkImage(const glimac::FilePath& filepath, const char* name) {
+    std::unique_ptr<glimac::Image> image;
+    std::printf("%s\n", name);
+
+    double floatTime = bench::measure([&]() {
+        image = glimac::loadImage(filepath, glimac::PixelFormat::RGBA32F);
+    }, 5);
+    if (!image) {
+        return false;
+    }
+    size_t floatSize = image->getByteSize();
+    image.reset();
+    double byteTime = bench::measure([&]() {
+        image = glimac::loadImage(filepath, glimac::PixelFormat::RGBA8);
+    }, 5);
+    size_t byteSize = image->getByteSize();
+
+    std::printf("  %u x %u, %zu KiB as RGBA32F, %zu KiB as RGBA8\n", image->getWidth(), image->getHeight(), floatSize / 1024, byteSize / 1024);
+    bench::report("  loadImage RGBA32F", floatTime);
+    bench::report("  loadImage RGBA8", byteTime);
+    return true;
+}
+
+// Encodeur JPEG baseline minimal (YCbCr 4:4:4, tables de Huffman standard de l'annexe K): le
+// stb_image_write fourni avec GLFW est trop ancien pour écrire du JPEG
+namespace jpeg {
+
+const uint8_t ZIGZAG[64] = { 0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,  12, 19, 26, 33, 40, 48,
+                             41, 34, 27, 20, 13, 6,  7,  14, 21, 28, 35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23,
+                             30, 37, 44, 51, 58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63 };
+
+const uint8_t LUMA_QUANT[64] = { 16, 11, 10, 16, 24,  40,  51,  61,  12, 12, 14, 19, 26,  58,  60,  55,
+                                 14, 13, 16, 24, 40,  57,  69,  56,  14, 17, 22, 29, 51,  87,  80,  62,
+                                 18, 22, 37, 56, 68,  109, 103, 77,  24, 35, 55, 64, 81,  104, 113, 92,
+                                 49, 64, 78, 87, 103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103, 99 };
+
+const uint8_t CHROMA_QUANT[64] = { 17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99, 99, 99, 99, 24, 26, 56, 99, 99, 99,
+                                   99, 99, 47, 66, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+                                   99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99 };
+
+const uint8_t DC_LUMA_BITS[16]   = { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 };
+const uint8_t DC_CHROMA_BITS[16] = { 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 };
+const uint8_t DC_VALUES[12]      = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+
+const uint8_t AC_LUMA_BITS[16] = { 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d };
+const uint8_t AC_LUMA_VALUES[162] = {
+    0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81,
+    0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18,
+    0x19, 0x1a, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+    0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75,
+    0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99,
+    0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3,
+    0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5,
+    0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa
+};
+
+const uint8_t AC_CHROMA_BITS[16] = { 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 };
+const uint8_t AC_CHROMA_VALUES[162] = {
+    0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13, 0x22, 0x32, 0x81, 0x08,
+    0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0, 0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25,
+    0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47,
+    0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74,
+    0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97,
+    0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba,
+    0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe2, 0xe3, 0xe4,
+    0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa
+};
+
+// Code et longueur de chaque symbole, construits à partir du nombre de codes par longueur
+struct HuffmanTable {
+    uint16_t codes[256] = {};
+    uint8_t lengths[256] = {};
+
+    HuffmanTable(const uint8_t bits[16], const uint8_t* values) {
+        uint16_t code = 0;
+        for (int length = 1, k = 0; length <= 16; ++length, code <<= 1) {
+            for (int i = 0; i < bits[length - 1]; ++i, ++k, ++code) {
+                codes[values[k]] = code;
+                lengths[values[k]] = uint8_t(length);
+            }
+        }
+    }
+};
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out): m_Out(out) {}
+
+    void write(uint32_t bits, int count) {
+        m_nBuffer = (m_nBuffer << count) | (bits & ((1u << count) - 1));
+        m_nCount += count;
+        while (m_nCount >= 8) {
+            uint8_t byte = uint8_t(m_nBuffer >> (m_nCount - 8));
+            m_Out.push_back(byte);
+            if (byte == 0xFF) {
+                m_Out.push_back(0); // octet de bourrage
+            }
+            m_nCount -= 8;
+        }
+    }
+
+    // Complète le dernier octet avec des 1
+    void flush() {
+        if (m_nCount > 0) {
+            write(0x7F, 8 - m_nCount);
+        }
+    }
+
+private:
+    std::vector<uint8_t>& m_Out;
+    uint32_t m_nBuffer = 0;
+    int m_nCount = 0;
+};
+
+static void writeMarker(std::vector<uint8_t>& out, uint8_t marker, const std::vector<uint8_t>& payload) {
+    out.push_back(0xFF);
+    out.push_back(marker);
+    out.push_back(uint8_t((payload.size() + 2) >> 8));
+    out.push_back(uint8_t(payload.size() + 2));
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+static void writeHuffmanTable(std::vector<uint8_t>& out, uint8_t classAndId, const uint8_t bits[16], const uint8_t* values) {
+    std::vector<uint8_t> payload(1, classAndId);
+    int count = 0;
+    for (int i = 0; i < 16; ++i) {
+        payload.push_back(bits[i]);
+        count += bits[i];
+    }
+    payload.insert(payload.end(), values, values + count);
+    writeMarker(out, 0xC4, payload);
+}
+
+// Catégorie (nombre de bits) et bits d'une valeur, comme les code les coefficients JPEG
+static void writeValue(BitWriter& writer, const HuffmanTable& table, uint8_t symbolPrefix, int value) {
+    int magnitude = value < 0 ? -value : value, category = 0;
+    while (magnitude >> category) {
+        ++category;
+    }
+    uint8_t symbol = uint8_t(symbolPrefix | category);
+    writer.write(table.codes[symbol], table.lengths[symbol]);
+    if (category) {
+        writer.write(uint32_t(value < 0 ? value - 1 : value), category);
+    }
+}
+
+static void encodeBlock(BitWriter& writer, float block[64], const float quant[64], int& previousDC, const HuffmanTable& dc, const HuffmanTable& ac) {
+    // DCT 2D séparable (lignes puis colonnes), directe: O(8) par coefficient
+    static float cosines[8][8];
+    static bool initialized = false;
+    if (!initialized) {
+        for (int u = 0; u < 8; ++u) {
+            for (int x = 0; x < 8; ++x) {
+                cosines[u][x] = (u ? 0.5f : 0.5f / std::sqrt(2.f)) * std::cos((2 * x + 1) * u * 3.14159265f / 16);
+            }
+        }
+        initialized = true;
+    }
+    float rows[64];
+    for (int y = 0; y < 8; ++y) {
+        for (int u = 0; u < 8; ++u) {
+            float sum = 0;
+            for (int x = 0; x < 8; ++x) {
+                sum += cosines[u][x] * block[y * 8 + x];
+            }
+            rows[y * 8 + u] = sum;
+        }
+    }
+    int coefficients[64];
+    for (int v = 0; v < 8; ++v) {
+        for (int u = 0; u < 8; ++u) {
+            float sum = 0;
+            for (int y = 0; y < 8; ++y) {
+                sum += cosines[v][y] * rows[y * 8 + u];
+            }
+            coefficients[v * 8 + u] = int(std::lround(sum / quant[v * 8 + u]));
+        }
+    }
+
+    writeValue(writer, dc, 0, coefficients[0] - previousDC);
+    previousDC = coefficients[0];
+    int zeroRun = 0;
+    for (int k = 1; k < 64; ++k) {
+        int value = coefficients[ZIGZAG[k]];
+        if (value == 0) {
+            ++zeroRun;
+            continue;
+        }
+        for (; zeroRun >= 16; zeroRun -= 16) {
+            writer.write(ac.codes[0xF0], ac.lengths[0xF0]); // 16 zéros
+        }
+        writeValue(writer, ac, uint8_t(zeroRun << 4), value);
+        zeroRun = 0;
+    }
+    if (zeroRun) {
+        writer.write(ac.codes[0x00], ac.lengths[0x00]); // fin de bloc
+    }
+}
+
+// rgb: width * height pixels de 3 octets
+static bool write(const std::filesystem::path& filename, int width, int height, const std::vector<uint8_t>& rgb, int quality) {
+    int scale = quality < 50 ? 5000 / quality : 200 - 2 * quality;
+    uint8_t quants[2][64];
+    float quantFloats[2][64];
+    for (int i = 0; i < 64; ++i) {
+        quants[0][i] = uint8_t(std::min(std::max((LUMA_QUANT[i] * scale + 50) / 100, 1), 255));
+        quants[1][i] = uint8_t(std::min(std::max((CHROMA_QUANT[i] * scale + 50) / 100, 1), 255));
+        quantFloats[0][i] = quants[0][i];
+        quantFloats[1][i] = quants[1][i];
+    }
+
+    std::vector<uint8_t> out = { 0xFF, 0xD8 };
+    std::vector<uint8_t> dqt;
+    for (int t = 0; t < 2; ++t) {
+        dqt.push_back(uint8_t(t));
+        for (int k = 0; k < 64; ++k) {
+            dqt.push_back(quants[t][ZIGZAG[k]]);
+        }
+    }
+    writeMarker(out, 0xDB, dqt);
+    writeMarker(out, 0xC0, { 8, uint8_t(height >> 8), uint8_t(height), uint8_t(width >> 8), uint8_t(width), 3,
+                             1, 0x11, 0, 2, 0x11, 1, 3, 0x11, 1 });
+    writeHuffmanTable(out, 0x00, DC_LUMA_BITS, DC_VALUES);
+    writeHuffmanTable(out, 0x10, AC_LUMA_BITS, AC_LUMA_VALUES);
+    writeHuffmanTable(out, 0x01, DC_CHROMA_BITS, DC_VALUES);
+    writeHuffmanTable(out, 0x11, AC_CHROMA_BITS, AC_CHROMA_VALUES);
+    writeMarker(out, 0xDA, { 3, 1, 0x00, 2, 0x11, 3, 0x11, 0, 63, 0 });
+
+    const HuffmanTable dcTables[2] = { HuffmanTable(DC_LUMA_BITS, DC_VALUES), HuffmanTable(DC_CHROMA_BITS, DC_VALUES) };
+    const HuffmanTable acTables[2] = { HuffmanTable(AC_LUMA_BITS, AC_LUMA_VALUES), HuffmanTable(AC_CHROMA_BITS, AC_CHROMA_VALUES) };
+    BitWriter writer(out);
+    int previousDC[3] = {};
+    for (int blockY = 0; blockY < height; blockY += 8) {
+        for (int blockX = 0; blockX < width; blockX += 8) {
+            float blocks[3][64];
+            for (int i = 0; i < 64; ++i) {
+                // les blocs du bord répètent la dernière ligne / colonne
+                int x = std::min(blockX + i % 8, width - 1), y = std::min(blockY + i / 8, height - 1);
+                const uint8_t* pixel = &rgb[(size_t(y) * width + x) * 3];
+                float r = pixel[0], g = pixel[1], b = pixel[2];
+                blocks[0][i] = 0.299f * r + 0.587f * g + 0.114f * b - 128;
+                blocks[1][i] = -0.168736f * r - 0.331264f * g + 0.5f * b;
+                blocks[2][i] = 0.5f * r - 0.418688f * g - 0.081312f * b;
+            }
+            for (int c = 0; c < 3; ++c) {
+                int t = c ? 1 : 0;
+                encodeBlock(writer, blocks[c], quantFloats[t], previousDC[c], dcTables[t], acTables[t]);
+            }
+        }
+    }
+    writer.flush();
+    out.push_back(0xFF);
+    out.push_back(0xD9);
+
+    std::ofstream file(filename, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(out.data()), out.size());
+    return bool(file);
+}
+
+}
+
+// Dégradés et motifs pour que le JPEG ne soit pas trivial à décoder
+static std::vector<uint8_t> generatePixels(int width, int height) {
+    std::vector<uint8_t> pixels(size_t(width) * height * 3);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            uint8_t* pixel = &pixels[(size_t(y) * width + x) * 3];
+            pixel[0] = uint8_t(255 * x / width);
+            pixel[1] = uint8_t(255 * y / height);
+            pixel[2] = uint8_t(127.5f + 127.5f * std::sin(x * 0.05f) * std::cos(y * 0.07f));
+        }
+    }
+    return pixels;
+}
+
+// Écart moyen (sur 255) entre l'image décodée et la source: vérifie l'encodeur
+static double meanError(const glimac::Image& image, const std::vector<uint8_t>& rgb) {
+    double error = 0;
+    size_t pixelCount = size_t(image.getWidth()) * image.getHeight();
+    for (size_t i = 0; i < pixelCount; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            error += std::abs(int(image.getBytes()[i * 4 + c]) - int(rgb[i * 3 + c]));
+        }
+    }
+    return error / (3 * pixelCount);
+}
+
+int main() {
+    const char* textures[] = { "herbe.jpg", "BlueSky.jpg", "CloudMap.jpg" };
+    for (const char* texture : textures) {
+        if (!benchmarkImage(glimac::FilePath(GLIMAC_ASSETS_DIR) + "textures/" + texture, texture)) {
+            return 1;
+        }
+    }
+
+    struct { const char* name; int width, height; } sizes[] = { { "generated 4K JPEG", 3840, 2160 }, { "generated 8K JPEG", 7680, 4320 } };
+    for (const auto& size : sizes) {
+        std::filesystem::path filename = std::filesystem::temp_directory_path() / "glimac_image_loading_benchmark.jpg";
+        std::vector<uint8_t> rgb = generatePixels(size.width, size.height);
+        if (!jpeg::write(filename, size.width, size.height, rgb, 90)) {
+            return 1;
+        }
+        std::unique_ptr<glimac::Image> decoded = glimac::loadImage(filename.string(), glimac::PixelFormat::RGBA8);
+        double error = decoded ? meanError(*decoded, rgb) : 255;
+        decoded.reset();
+        std::printf("%s: %zu KiB, mean decoding error %.2f / 255\n", size.name, size_t(std::filesystem::file_size(filename)) / 1024, error);
+        bool loaded = error < 4 && benchmarkImage(filename.string(), size.name);
+        std::filesystem::remove(filename);
+        if (!loaded) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,168 @@
+#include "GLTestContext.hpp"
+#include <glimac/Cylindre.hpp>
+#include <glimac/InstanceBuffer.hpp>
+#include <glimac/MeshBuffer.hpp>
+#include <glimac/Program.hpp>
+#include <glimac/RenderStats.hpp>
+#include "Benchmark.hpp"
+
+// Dessin des tronçons du circuit: un appel par tronçon, avec le travail qu'il faisait à chaque frame
+// (segmentMatrix, matrice normale par glm::inverse, matrices et uniformes du matériau), contre un seul
+// appel instancié. Le temps de soumission (CPU) est affiché à part du total qui attend glFinish
+
+static const char* VERTEX_SHADER = R"(#version 330 core
+layout(location = 0) in vec3 aVertexPosition;
+layout(location = 1) in vec3 aVertexNormal;
+layout(location = 3) in mat4 aInstanceModel;
+layout(location = 7) in mat3 aInstanceNormal;
+layout(location = 10) in vec3 aInstanceColor;
+uniform mat4 uMVPMatrix;
+uniform mat4 uMVMatrix;
+uniform mat4 uNormalMatrix;
+uniform bool uInstanced;
+out vec3 vPosition;
+out vec3 vNormal;
+out vec3 vInstanceColor;
+void main() {
+    vec4 position = vec4(aVertexPosition, 1);
+    vec4 normal = vec4(aVertexNormal, 0);
+    vInstanceColor = vec3(0);
+    if (uInstanced) {
+        position = aInstanceModel * position;
+        normal = vec4(aInstanceNormal * aVertexNormal, 0);
+        vInstanceColor = aInstanceColor;
+    }
+    vPosition = vec3(uMVMatrix * position);
+    vNormal = vec3(uNormalMatrix * normal);
+    gl_Position = uMVPMatrix * position;
+}
+)";
+
+static const char* FRAGMENT_SHADER = R"(#version 330 core
+struct Material {
+    vec3 color;
+    float specularIntensity;
+    float shininess;
+    float hasTexture;
+    float isLamp;
+};
+uniform Material uMaterial;
+uniform bool uInstanced;
+in vec3 vPosition;
+in vec3 vNormal;
+in vec3 vInstanceColor;
+out vec4 fColor;
+void main() {
+    vec3 color = uInstanced ? vInstanceColor : uMaterial.color;
+    color *= 1.0 - 0.5 * uMaterial.hasTexture;
+    float specular = pow(max(dot(normalize(vNormal), normalize(-vPosition)), 0.0), uMaterial.shininess);
+    fColor = vec4(uMaterial.isLamp > 0.5 ? vec3(1) : color * (0.5 + uMaterial.specularIntensity * specular), 1);
+}
+)";
+
+// Emplacements des uniformes, chargés comme Material::ChargeMatrices / ChargeGLints de main.cpp
+struct Uniforms {
+    GLint mvpMatrix, mvMatrix, normalMatrix, instanced;
+    GLint color, specularIntensity, shininess, hasTexture, isLamp;
+
+    explicit Uniforms(GLuint program) {
+        mvpMatrix         = glGetUniformLocation(program, "uMVPMatrix");
+        mvMatrix          = glGetUniformLocation(program, "uMVMatrix");
+        normalMatrix      = glGetUniformLocation(program, "uNormalMatrix");
+        instanced         = glGetUniformLocation(program, "uInstanced");
+        color             = glGetUniformLocation(program, "uMaterial.color");
+        specularIntensity = glGetUniformLocation(program, "uMaterial.specularIntensity");
+        shininess         = glGetUniformLocation(program, "uMaterial.shininess");
+        hasTexture        = glGetUniformLocation(program, "uMaterial.hasTexture");
+        isLamp            = glGetUniformLocation(program, "uMaterial.isLamp");
+    }
+
+    void chargeMatrices(const glm::mat4& mvMatrix, const glm::mat4& projMatrix) const {
+        glm::mat4 normal = glm::transpose(glm::inverse(mvMatrix));
+        glUniformMatrix4fv(mvpMatrix, 1, GL_FALSE, glm::value_ptr(projMatrix * mvMatrix));
+        glUniformMatrix4fv(this->mvMatrix, 1, GL_FALSE, glm::value_ptr(mvMatrix));
+        glUniformMatrix4fv(normalMatrix, 1, GL_FALSE, glm::value_ptr(normal));
+    }
+
+    void chargeMaterial(const glm::vec3& c, bool isInstanced) const {
+        glUniform3f(color, c.x, c.y, c.z);
+        glUniform1f(specularIntensity, 1.f);
+        glUniform1f(shininess, 32.f);
+        glUniform1f(hasTexture, 0.f);
+        glUniform1f(isLamp, 0.f);
+        glUniform1i(instanced, isInstanced);
+    }
+};
+
+int main() {
+    test::GLTestContext context;
+    if (!context.isValid()) {
+        return TEST_SKIPPED;
+    }
+
+    glimac::Program program = glimac::buildProgram(VERTEX_SHADER, FRAGMENT_SHADER);
+    program.use();
+    Uniforms uniforms(program.getGLId());
+
+    glimac::Cylindre cylindre(1, 0.03f, 12, 1);
+    glimac::MeshBuffer mesh(cylindre.getDataPointer(), cylindre.getVertexCount());
+
+    const glm::mat4 viewMatrix = glm::lookAt(glm::vec3(0, 15, 25), glm::vec3(0), glm::vec3(0, 1, 0));
+    const glm::mat4 projMatrix = glm::perspective(glm::radians(70.f), 16.f / 9.f, 0.1f, 100.f);
+
+    for (int segmentCount : {100, 1000, 10000, 100000}) {
+        std::vector<glm::vec3> points;
+        std::vector<glm::vec3> colors;
+        for (int i = 0; i < segmentCount; ++i) {
+            float angle = 6.2831853f * i / segmentCount;
+            points.push_back(glm::vec3(10 * glm::cos(angle), glm::sin(3 * angle), 10 * glm::sin(angle)));
+            colors.push_back(glm::vec3(float(i % 7) / 7, float(i % 5) / 5, float(i % 3) / 3));
+        }
+
+        std::printf("%d segments\n", segmentCount);
+
+        // table des instances calculée et envoyée une fois, comme Circuit::UpdateInstances quand le circuit change
+        glimac::InstanceBuffer instances(mesh);
+        bench::report("  instance table build + upload (once)", bench::measure([&]() {
+            std::vector<glimac::InstanceData> segments;
+            segments.reserve(segmentCount);
+            for (int i = 0; i < segmentCount; ++i) {
+                segments.push_back(glimac::InstanceData(glimac::segmentMatrix(points[i], points[(i + 1) % segmentCount]), colors[i]));
+            }
+            instances.upload(segments);
+            glFinish();
+        }));
+
+        std::vector<double> submitTimes;
+        double total = bench::measure([&]() {
+            glimac::RenderStats::beginFrame();
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < segmentCount; ++i) {
+                glm::mat4 model = glimac::segmentMatrix(points[i], points[(i + 1) % segmentCount]);
+                uniforms.chargeMatrices(viewMatrix * model, projMatrix);
+                uniforms.chargeMaterial(colors[i], false);
+                mesh.draw();
+            }
+            submitTimes.push_back(bench::elapsed(start));
+            glFinish();
+        });
+        std::printf("  one draw call per segment (%zu draw calls)\n", glimac::RenderStats::getDrawCallCount());
+        bench::report("    CPU submission", bench::median(submitTimes));
+        bench::report("    total with glFinish", total);
+
+        submitTimes.clear();
+        total = bench::measure([&]() {
+            glimac::RenderStats::beginFrame();
+            auto start = std::chrono::steady_clock::now();
+            uniforms.chargeMatrices(viewMatrix, projMatrix);
+            uniforms.chargeMaterial(glm::vec3(1, 0, 0), true);
+            instances.draw();
+            submitTimes.push_back(bench::elapsed(start));
+            glFinish();
+        });
+        std::printf("  single instanced draw call (%zu draw calls)\n", glimac::RenderStats::getDrawCallCount());
+        bench::report("    CPU submission", bench::median(submitTimes));
+        bench::report("    total with glFinish", total);
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <cmath>
+#include <random>
+#include <glimac/BBox.hpp>
+#include <glimac/LightClusters.hpp>
+#include "Benchmark.hpp"
+
+// Répartition des lumières dans les 16 x 9 x 24 clusters: LightClusters::build (chaque lumière parcourt
+// les clusters de sa boîte à l'écran) contre l'approche directe qui teste chaque lumière contre la boîte
+// de chaque cluster dans le repère de la vue. Affiche aussi le nombre moyen de lumières évaluées par fragment
+
+const float zNear = 0.1f, zFar = 100.f;
+const unsigned TILES_X = 16, TILES_Y = 9, SLICES = 24;
+
+// Boîtes des clusters dans le repère de la vue, dans l'ordre de LightClusters::getClusterIndex
+static std::vector<glimac::BBox3f> clusterBounds(const glm::mat4& projection) {
+    std::vector<glimac::BBox3f> bounds;
+    for (unsigned z = 0; z < SLICES; ++z) {
+        float nearDepth = zNear * std::pow(zFar / zNear, float(z) / SLICES);
+        float farDepth = zNear * std::pow(zFar / zNear, float(z + 1) / SLICES);
+        for (unsigned y = 0; y < TILES_Y; ++y) {
+            for (unsigned x = 0; x < TILES_X; ++x) {
+                glimac::BBox3f box = glimac::BBox3f::emptyBox();
+                for (float depth : { nearDepth, farDepth }) {
+                    for (unsigned corner = 0; corner < 4; ++corner) {
+                        // ndc = P[0][0] x / profondeur - P[2][0], inversé aux coins de la tuile
+                        float ndcX = 2.f * (x + (corner & 1)) / TILES_X - 1.f;
+                        float ndcY = 2.f * (y + (corner >> 1)) / TILES_Y - 1.f;
+                        box.grow(glm::vec3((ndcX + projection[2][0]) * depth / projection[0][0],
+                                           (ndcY + projection[2][1]) * depth / projection[1][1], -depth));
+                    }
+                }
+                bounds.push_back(box);
+            }
+        }
+    }
+    return bounds;
+}
+
+int main() {
+    const glm::mat4 projection = glm::perspective(glm::radians(70.f), 16.f / 9.f, zNear, zFar);
+    const std::vector<glimac::BBox3f> bounds = clusterBounds(projection);
+    glimac::LightClusters clusters(TILES_X, TILES_Y, SLICES);
+    clusters.setProjection(projection, zNear, zFar);
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> side(-1.f, 1.f), depth(0.f, 1.f), radius(0.5f, 4.f);
+    for (size_t lightCount : { size_t(16), size_t(256), size_t(1024), size_t(4096), size_t(10000) }) {
+        std::vector<glm::vec4> lights;
+        for (size_t i = 0; i < lightCount; ++i) {
+            float z = 1.f + depth(rng) * 60.f;
+            lights.push_back(glm::vec4(side(rng) * z, side(rng) * z * 0.6f, -z, radius(rng)));
+        }
+
+        std::printf("%zu lights, %zu clusters\n", lightCount, clusters.getClusterCount());
+        bench::report("  LightClusters::build", bench::measure([&]() {
+            clusters.build(lights.data(), lights.size());
+            bench::doNotOptimize(clusters.getLightIndices().size());
+        }));
+        std::vector<std::vector<uint32_t>> bruteForce(bounds.size());
+        bench::report("  every light against every cluster", bench::measure([&]() {
+            for (size_t c = 0; c < bounds.size(); ++c) {
+                bruteForce[c].clear();
+                for (uint32_t i = 0; i < lights.size(); ++i) {
+                    // distance de la sphère à la boîte
+                    glm::vec3 center(lights[i]);
+                    glm::vec3 nearest = glm::clamp(center, bounds[c].lower, bounds[c].upper);
+                    if (glm::dot(center - nearest, center - nearest) <= lights[i].w * lights[i].w) {
+                        bruteForce[c].push_back(i);
+                    }
+                }
+            }
+            bench::doNotOptimize(bruteForce.back().size());
+        }, 3));
+
+        // La boîte à l'écran est conservative: build range plus de lumières que le test exact
+        size_t exactIndices = 0, occupied = 0;
+        for (const auto& list : bruteForce) {
+            exactIndices += list.size();
+            occupied += !list.empty();
+        }
+        std::printf("  indices: %zu (build), %zu (sphere against cluster box)\n", clusters.getLightIndices().size(), exactIndices);
+        std::printf("  lights per occupied cluster: %.1f instead of %zu\n", occupied ? double(exactIndices) / occupied : 0., lightCount);
+    }
+    return 0;
+}
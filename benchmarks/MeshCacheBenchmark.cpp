@@ -0,0 +1,50 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <glimac/Geometry.hpp>
+#include "Benchmark.hpp"
+
+// Geometry::loadOBJ sur une grosse grille OBJ: à froid (cache supprimé avant chaque chargement, donc analyse,
+// optimisation et écriture du cache) contre à chaud (relecture du cache ".cache")
+
+int main(int argc, char* argv[]) {
+    const int SIZE = argc > 1 ? std::atoi(argv[1]) : 700;
+    std::filesystem::path filename = std::filesystem::temp_directory_path() / "glimac_mesh_cache_benchmark.obj";
+    std::filesystem::path cacheName = filename.string() + ".cache";
+    {
+        std::ofstream obj(filename);
+        for (int y = 0; y <= SIZE; ++y) {
+            for (int x = 0; x <= SIZE; ++x) {
+                obj << "v " << x * 0.01f << " " << (x * y % 13) * 0.001f << " " << y * 0.01f << "\n";
+                obj << "vt " << x / float(SIZE) << " " << y / float(SIZE) << "\n";
+                obj << "vn 0 1 0\n";
+            }
+        }
+        for (int y = 0; y < SIZE; ++y) {
+            for (int x = 0; x < SIZE; ++x) {
+                int i = y * (SIZE + 1) + x + 1;
+                int j = i + SIZE + 1;
+                obj << "f " << i << "/" << i << "/" << i << " " << i + 1 << "/" << i + 1 << "/" << i + 1 << " " << j + 1 << "/" << j + 1 << "/" << j + 1 << "\n";
+                obj << "f " << i << "/" << i << "/" << i << " " << j + 1 << "/" << j + 1 << "/" << j + 1 << " " << j << "/" << j << "/" << j << "\n";
+            }
+        }
+    }
+    std::printf("%d triangles, %ju KiB\n", 2 * SIZE * SIZE, std::uintmax_t(std::filesystem::file_size(filename) / 1024));
+
+    bench::report("cold loadOBJ (parse, optimise, write cache)", bench::measure([&]() {
+        std::filesystem::remove(cacheName);
+        glimac::Geometry geometry;
+        geometry.loadOBJ(filename.string(), "", false);
+        bench::doNotOptimize(geometry.getVertexCount());
+    }, 3));
+    std::printf("cache: %ju KiB\n", std::uintmax_t(std::filesystem::file_size(cacheName) / 1024));
+    bench::report("warm loadOBJ (read cache)", bench::measure([&]() {
+        glimac::Geometry geometry;
+        geometry.loadOBJ(filename.string(), "", false);
+        bench::doNotOptimize(geometry.getVertexCount());
+    }, 3));
+
+    std::filesystem::remove(cacheName);
+    std::filesystem::remove(filename);
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <random>
+#include <glimac/MeshOptimizer.hpp>
+#include <tiny_obj_loader.h>
+#include "Benchmark.hpp"
+
+// Coût de optimizeVertexCache et gain mesuré par le simulateur de cache (ACMR/ATVR avant et après),
+// sur les formes de wagon.obj et sur des grilles dont les triangles ont été mélangés
+
+static std::vector<unsigned int> shuffledGrid(int size) {
+    std::vector<unsigned int> indices;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            unsigned int a = y * (size + 1) + x, b = a + 1, c = a + size + 1, d = c + 1;
+            indices.insert(indices.end(), { a, b, d, a, d, c });
+        }
+    }
+    std::vector<size_t> order(indices.size() / 3);
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+    std::vector<unsigned int> shuffled;
+    shuffled.reserve(indices.size());
+    for (auto triangle : order) {
+        shuffled.insert(shuffled.end(), indices.begin() + 3 * triangle, indices.begin() + 3 * triangle + 3);
+    }
+    return shuffled;
+}
+
+// Mesure l'optimisation sur une copie (les indices d'origine servent à chaque répétition)
+static void benchmark(const char* name, const std::vector<unsigned int>& indices) {
+    std::vector<unsigned int> optimized;
+    double time = bench::measure([&]() {
+        optimized = indices;
+        glimac::optimizeVertexCache(optimized.data(), optimized.size());
+    }, 5);
+    auto before = glimac::simulateVertexCache(indices.data(), indices.size());
+    auto after = glimac::simulateVertexCache(optimized.data(), optimized.size());
+    std::printf("%-32s %8zu triangles %10.3f ms   ACMR %.3f -> %.3f   ATVR %.3f -> %.3f\n", name, indices.size() / 3,
+                time, before.getACMR(), after.getACMR(), before.getATVR(), after.getATVR());
+}
+
+int main() {
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string error = tinyobj::LoadObj(shapes, materials, GLIMAC_ASSETS_DIR "/models/wagon.obj", GLIMAC_ASSETS_DIR "/models/");
+    if (!error.empty()) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return EXIT_FAILURE;
+    }
+    for (const auto& shape : shapes) {
+        benchmark(("wagon.obj: " + shape.name).c_str(), shape.mesh.indices);
+    }
+
+    for (int size : { 100, 300, 600 }) {
+        std::string name = "shuffled grid " + std::to_string(size) + "x" + std::to_string(size);
+        benchmark(name.c_str(), shuffledGrid(size));
+    }
+    return 0;
+}
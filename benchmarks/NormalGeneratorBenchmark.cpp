@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <glimac/NormalGenerator.hpp>
+#include "Benchmark.hpp"
+
+// generateSmoothNormals sur une grande grille ondulée et plissée (arêtes à 90° toutes les 4 colonnes),
+// de 1 à hardware_concurrency threads, sans angle de pli (une somme par tâche puis réduction) et avec
+// un angle de 30° (faces regroupées par sommet, sommets dupliqués le long des arêtes)
+
+int main(int argc, char* argv[]) {
+    const int SIZE = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const int REPETITION_COUNT = 5;
+    std::vector<glm::vec3> positions;
+    for (int y = 0; y <= SIZE; ++y) {
+        for (int x = 0; x <= SIZE; ++x) {
+            positions.push_back(glm::vec3(x, std::sin(x * 0.3f) * std::cos(y * 0.2f) * 3.f + std::abs(x % 8 - 4), y));
+        }
+    }
+    std::vector<unsigned int> grid;
+    grid.reserve(size_t(6) * SIZE * SIZE);
+    for (int y = 0; y < SIZE; ++y) {
+        for (int x = 0; x < SIZE; ++x) {
+            unsigned int a = y * (SIZE + 1) + x, b = a + 1, c = a + SIZE + 1, d = c + 1;
+            grid.insert(grid.end(), { a, c, d, a, d, b });
+        }
+    }
+    const unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("%zu vertices, %zu triangles, %u hardware threads\n", positions.size(), grid.size() / 3, hardwareThreads);
+
+    std::vector<glm::vec3> normals(positions.size());
+    glimac::VertexStream<const glm::vec3> positionStream{ positions.data(), sizeof(glm::vec3), positions.size() };
+    glimac::VertexStream<glm::vec3> normalStream{ normals.data(), sizeof(glm::vec3), normals.size() };
+
+    for (float creaseAngle : { glimac::NO_CREASE_ANGLE, glm::radians(30.f) }) {
+        std::printf("%s\n", creaseAngle == glimac::NO_CREASE_ANGLE ? "no crease angle" : "crease angle 30 degrees");
+        double singleThread = 0;
+        for (unsigned int threadCount = 1; threadCount <= hardwareThreads; ++threadCount) {
+            glimac::ThreadPool pool(threadCount);
+            // les indices sont réécrits en place le long des plis: chaque exécution repart d'une copie, hors mesure
+            std::vector<double> times;
+            size_t splitCount = 0;
+            for (int repetition = 0; repetition <= REPETITION_COUNT; ++repetition) {
+                std::vector<unsigned int> indices = grid;
+                auto start = std::chrono::steady_clock::now();
+                splitCount = glimac::generateSmoothNormals(indices.data(), indices.size(), positionStream, normalStream, 0, positions.size(),
+                                                           creaseAngle, pool).size();
+                if (repetition > 0) {
+                    times.push_back(bench::elapsed(start));
+                }
+            }
+            double milliseconds = bench::median(times);
+            if (threadCount == 1) {
+                singleThread = milliseconds;
+            }
+            char name[64];
+            std::snprintf(name, sizeof(name), "  %u thread(s), %zu split vertices", threadCount, splitCount);
+            bench::report(name, milliseconds);
+            std::printf("    speedup over 1 thread: %.2fx, %.1f Mtriangles/s\n", singleThread / milliseconds, grid.size() / 3 / milliseconds / 1000.);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <filesystem>
+#include <fstream>
+#include <glimac/ThreadPool.hpp>
+#include <tiny_obj_loader.h>
+#include "Benchmark.hpp"
+
+// Chargement d'une grosse grille OBJ (plusieurs groupes): LoadObj (istream), LoadObjMapped (fichier mappé)
+// et LoadObjParallel (morceaux analysés et formes exportées en parallèle)
+
+int main(int argc, char* argv[]) {
+    const int SIZE = argc > 1 ? std::atoi(argv[1]) : 400;
+    const int GROUP_COUNT = 4;
+    std::filesystem::path filename = std::filesystem::temp_directory_path() / "glimac_obj_loading_benchmark.obj";
+    {
+        std::ofstream obj(filename);
+        for (int y = 0; y <= SIZE; ++y) {
+            for (int x = 0; x <= SIZE; ++x) {
+                obj << "v " << x * 0.01f << " " << (x * y % 13) * 0.001f << " " << y * 0.01f << "\n";
+                obj << "vt " << x / float(SIZE) << " " << y / float(SIZE) << "\n";
+                obj << "vn 0 1 0\n";
+            }
+        }
+        for (int y = 0; y < SIZE; ++y) {
+            if (y % (SIZE / GROUP_COUNT) == 0) {
+                obj << "g part" << y << "\n";
+            }
+            for (int x = 0; x < SIZE; ++x) {
+                int i = y * (SIZE + 1) + x + 1;
+                int j = i + SIZE + 1;
+                obj << "f " << i << "/" << i << "/" << i << " " << i + 1 << "/" << i + 1 << "/" << i + 1 << " " << j + 1 << "/" << j + 1 << "/" << j + 1 << "\n";
+                obj << "f " << i << "/" << i << "/" << i << " " << j + 1 << "/" << j + 1 << "/" << j + 1 << " " << j << "/" << j << "/" << j << "\n";
+            }
+        }
+    }
+    std::printf("%d triangles, %ju KiB\n", 2 * SIZE * SIZE, std::uintmax_t(std::filesystem::file_size(filename) / 1024));
+
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    bench::report("LoadObj", bench::measure([&]() {
+        tinyobj::LoadObj(shapes, materials, filename.string().c_str());
+    }, 3));
+    bench::report("LoadObjMapped", bench::measure([&]() {
+        tinyobj::LoadObjMapped(shapes, materials, filename.string().c_str());
+    }, 3));
+    for (unsigned int threadCount : { 1u, 2u, 4u }) {
+        glimac::ThreadPool pool(threadCount);
+        char name[64];
+        std::snprintf(name, sizeof(name), "LoadObjParallel, %u thread(s)", threadCount);
+        bench::report(name, bench::measure([&]() {
+            tinyobj::LoadObjParallel(shapes, materials, filename.string().c_str(), pool);
+        }, 3));
+    }
+    std::printf("(%u hardware threads)\n", std::thread::hardware_concurrency());
+
+    std::filesystem::remove(filename);
+    return 0;
+}
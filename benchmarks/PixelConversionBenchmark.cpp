@@ -0,0 +1,45 @@
+#include <cstring>
+#include <glimac/PixelConversion.hpp>
+#include "Benchmark.hpp"
+
+// Débit des conversions de pixels RGBA (octets <-> flottants) sur des images 4K et 8K, pour chaque
+// noyau disponible (imposé par setPixelConversionKernel)
+
+int main() {
+    const glimac::PixelConversionKernel kernels[] = { glimac::PixelConversionKernel::SCALAR, glimac::PixelConversionKernel::SSE2,
+                                                      glimac::PixelConversionKernel::AVX2 };
+    struct { const char* name; size_t width, height; } sizes[] = { { "4K", 3840, 2160 }, { "8K", 7680, 4320 } };
+
+    for (const auto& size : sizes) {
+        const size_t pixelCount = size.width * size.height, count = 4 * pixelCount;
+        std::vector<unsigned char> bytes(count);
+        for (size_t i = 0; i < count; ++i) {
+            bytes[i] = (unsigned char)(i * 7);
+        }
+        std::vector<float> floats(count);
+        std::vector<unsigned char> roundTrip(count);
+
+        std::printf("%s RGBA (%zu x %zu)\n", size.name, size.width, size.height);
+        for (glimac::PixelConversionKernel kernel : kernels) {
+            if (!glimac::setPixelConversionKernel(kernel)) {
+                continue;
+            }
+            const char* name = glimac::getPixelConversionKernel();
+            double toFloat = bench::measure([&]() {
+                glimac::convertU8ToF32(bytes.data(), floats.data(), count);
+                bench::doNotOptimize(floats.back());
+            });
+            double toByte = bench::measure([&]() {
+                glimac::convertF32ToU8(floats.data(), roundTrip.data(), count);
+                bench::doNotOptimize(roundTrip.back());
+            });
+            if (std::memcmp(bytes.data(), roundTrip.data(), count) != 0) {
+                std::printf("  %s: round trip mismatch\n", name);
+                return 1;
+            }
+            std::printf("  %-6s u8 -> f32 %8.2f ms %8.0f Mpixel/s    f32 -> u8 %8.2f ms %8.0f Mpixel/s\n", name, toFloat,
+                        pixelCount / toFloat / 1000, toByte, pixelCount / toByte / 1000);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <cmath>
+#include <glimac/Cylindre.hpp>
+#include <glimac/Sphere.hpp>
+#include "Benchmark.hpp"
+
+// Construction des primitives: constructeurs actuels (tables de sinus/cosinus, tampons dimensionnés
+// à l'avance) contre l'ancienne construction, recopiée ici, qui appelait sin/cos pour chaque sommet
+// et remplissait ses tableaux par push_back
+
+using glimac::ShapeVertex;
+
+static std::vector<ShapeVertex> oldSphere(GLfloat r, GLsizei discLat, GLsizei discLong) {
+    GLfloat rcpLat = 1.f / discLat, rcpLong = 1.f / discLong;
+    GLfloat dPhi = 2 * glm::pi<float>() * rcpLat, dTheta = glm::pi<float>() * rcpLong;
+    std::vector<ShapeVertex> data;
+    for (GLsizei j = 0; j <= discLong; ++j) {
+        GLfloat cosTheta = cos(-glm::pi<float>() / 2 + j * dTheta);
+        GLfloat sinTheta = sin(-glm::pi<float>() / 2 + j * dTheta);
+        for (GLsizei i = 0; i <= discLat; ++i) {
+            ShapeVertex vertex;
+            vertex.texCoords.x = i * rcpLat;
+            vertex.texCoords.y = 1.f - j * rcpLong;
+            vertex.normal.x = sin(i * dPhi) * cosTheta;
+            vertex.normal.y = sinTheta;
+            vertex.normal.z = cos(i * dPhi) * cosTheta;
+            vertex.position = r * vertex.normal;
+            data.push_back(vertex);
+        }
+    }
+    std::vector<ShapeVertex> vertices;
+    for (GLsizei j = 0; j < discLong; ++j) {
+        GLsizei offset = j * (discLat + 1);
+        for (GLsizei i = 0; i < discLat; ++i) {
+            vertices.push_back(data[offset + i]);
+            vertices.push_back(data[offset + (i + 1)]);
+            vertices.push_back(data[offset + discLat + 1 + (i + 1)]);
+            vertices.push_back(data[offset + i]);
+            vertices.push_back(data[offset + discLat + 1 + (i + 1)]);
+            vertices.push_back(data[offset + i + discLat + 1]);
+        }
+    }
+    return vertices;
+}
+
+static std::vector<ShapeVertex> oldCylindre(GLfloat height, GLfloat r, GLsizei discLat, GLsizei discHeight) {
+    GLfloat rcpLat = 1.f / discLat, rcpH = 1.f / discHeight;
+    GLfloat dPhi = 2 * glm::pi<float>() * rcpLat, dH = height * rcpH;
+    std::vector<ShapeVertex> data;
+    for (GLsizei j = 0; j <= discHeight; ++j) {
+        for (GLsizei i = 0; i < discLat; ++i) {
+            ShapeVertex vertex;
+            vertex.texCoords.x = i * rcpLat;
+            vertex.texCoords.y = j * rcpH;
+            vertex.position.x = r * sin(i * dPhi);
+            vertex.position.y = r * cos(i * dPhi);
+            vertex.position.z = j * dH;
+            vertex.normal = glm::normalize(glm::vec3(sin(i * dPhi), cos(i * dPhi), 0));
+            data.push_back(vertex);
+        }
+    }
+    std::vector<ShapeVertex> vertices;
+    for (GLsizei j = 0; j < discHeight; ++j) {
+        GLsizei offset = j * discLat;
+        for (GLsizei i = 0; i < discLat; ++i) {
+            vertices.push_back(data[offset + i]);
+            vertices.push_back(data[offset + (i + 1) % discLat]);
+            vertices.push_back(data[offset + discLat + (i + 1) % discLat]);
+            vertices.push_back(data[offset + i]);
+            vertices.push_back(data[offset + discLat + (i + 1) % discLat]);
+            vertices.push_back(data[offset + i + discLat]);
+        }
+    }
+    return vertices;
+}
+
+int main() {
+    for (GLsizei disc : { 32, 128, 512 }) {
+        std::printf("Sphere %dx%d\n", disc, disc / 2);
+        bench::report("  old construction", bench::measure([&]() {
+            bench::doNotOptimize(oldSphere(1.f, disc, disc / 2));
+        }));
+        bench::report("  Sphere (trig tables, reserved buffers)", bench::measure([&]() {
+            glimac::Sphere sphere(1.f, disc, disc / 2);
+            bench::doNotOptimize(sphere);
+        }));
+    }
+    for (GLsizei disc : { 32, 128, 512 }) {
+        std::printf("Cylindre %dx%d\n", disc, disc / 4);
+        bench::report("  old construction", bench::measure([&]() {
+            bench::doNotOptimize(oldCylindre(1.f, 1.f, disc, disc / 4));
+        }));
+        bench::report("  Cylindre (shared ring, reserved buffers)", bench::measure([&]() {
+            glimac::Cylindre cylindre(1.f, 1.f, disc, disc / 4);
+            bench::doNotOptimize(cylindre);
+        }));
+    }
+    return 0;
+}
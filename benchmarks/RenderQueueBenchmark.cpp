@@ -0,0 +1,65 @@
+#include <random>
+#include <glimac/RenderQueue.hpp>
+#include "Benchmark.hpp"
+
+// Tri des commandes de dessin: RenderQueue::sort (tri par base) contre std::sort et std::stable_sort sur les
+// mêmes clés, pour des files de tailles croissantes. Affiche aussi les changements de matériau, de texture
+// et de maillage entre commandes consécutives, dans l'ordre de soumission et une fois triées
+
+static void countChanges(const std::vector<glimac::RenderCommand>& commands, size_t& materials, size_t& textures, size_t& meshes) {
+    materials = textures = meshes = 0;
+    for (size_t i = 0; i < commands.size(); ++i) {
+        uint64_t previous = i ? commands[i - 1].key : ~uint64_t(0);
+        materials += glimac::RenderQueue::getMaterial(commands[i].key) != glimac::RenderQueue::getMaterial(previous);
+        textures += glimac::RenderQueue::getTexture(commands[i].key) != glimac::RenderQueue::getTexture(previous);
+        meshes += glimac::RenderQueue::getMesh(commands[i].key) != glimac::RenderQueue::getMesh(previous);
+    }
+}
+
+int main() {
+    std::mt19937 rng(1);
+    // Scène typique: peu de matériaux et de textures, plus de maillages, profondeurs quelconques
+    std::uniform_int_distribution<uint32_t> material(0, 15), texture(0, 7), mesh(0, 63);
+    std::uniform_real_distribution<float> depth(0.f, 1.f);
+
+    for (size_t count : { size_t(100), size_t(1000), size_t(10000), size_t(100000), size_t(1000000) }) {
+        glimac::RenderQueue queue;
+        queue.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            queue.submit(glimac::RenderQueue::makeKey(i % 8 == 0, material(rng), texture(rng), mesh(rng), depth(rng)), uint32_t(i));
+        }
+        const std::vector<glimac::RenderCommand> submitted = queue.getCommands();
+        auto byKey = [](const glimac::RenderCommand& a, const glimac::RenderCommand& b) {
+            return a.key < b.key;
+        };
+
+        std::printf("%zu commands\n", count);
+        std::vector<glimac::RenderCommand> commands;
+        bench::report("  std::sort", bench::measure([&]() {
+            commands = submitted;
+            std::sort(commands.begin(), commands.end(), byKey);
+            bench::doNotOptimize(commands.front());
+        }));
+        bench::report("  std::stable_sort", bench::measure([&]() {
+            commands = submitted;
+            std::stable_sort(commands.begin(), commands.end(), byKey);
+            bench::doNotOptimize(commands.front());
+        }));
+        // Même recopie des commandes que ci-dessus: seul le tri diffère
+        bench::report("  RenderQueue::sort", bench::measure([&]() {
+            queue.clear();
+            for (const auto& command : submitted) {
+                queue.submit(command.key, command.payload);
+            }
+            queue.sort();
+            bench::doNotOptimize(queue.getCommands().front());
+        }));
+
+        size_t materials, textures, meshes;
+        countChanges(submitted, materials, textures, meshes);
+        std::printf("  changes as submitted: %zu materials, %zu textures, %zu meshes\n", materials, textures, meshes);
+        countChanges(queue.getCommands(), materials, textures, meshes);
+        std::printf("  changes once sorted:  %zu materials, %zu textures, %zu meshes\n", materials, textures, meshes);
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <memory>
+#include <random>
+#include <glimac/Arena.hpp>
+#include <glimac/Scene.hpp>
+#include "Benchmark.hpp"
+
+// Graphe de scène: arbre de noeuds alloués un par un et parcouru récursivement (pointeurs vers les enfants)
+// contre glimac::Scene (tableaux contigus, un seul parcours linéaire), pour la mise à jour des matrices monde
+// et le frustum culling. Puis création d'objets avec new / delete contre glimac::Arena
+
+struct Node {
+    glm::mat4 localMatrix = glm::mat4(1.f);
+    glm::mat4 worldMatrix = glm::mat4(1.f);
+    glimac::BBox3f localBounds = glimac::BBox3f::emptyBox(), worldBounds;
+    bool drawable = false;
+    std::vector<std::unique_ptr<Node>> children;
+};
+
+static void updateNode(Node& node, const glm::mat4& parentMatrix) {
+    node.worldMatrix = parentMatrix * node.localMatrix;
+    node.worldBounds = node.localBounds.empty() ? node.localBounds : glimac::transform(node.worldMatrix, node.localBounds);
+    for (auto& child : node.children) {
+        updateNode(*child, node.worldMatrix);
+    }
+}
+
+static size_t cullNode(const Node& node, const glimac::Frustum& frustum) {
+    size_t visibleCount = node.drawable && (node.worldBounds.empty() || frustum.intersects(node.worldBounds));
+    for (const auto& child : node.children) {
+        visibleCount += cullNode(*child, frustum);
+    }
+    return visibleCount;
+}
+
+// Objet typique de la scène: quelques champs et un tableau possédé
+struct Object {
+    glm::vec3 color;
+    float shininess;
+    std::vector<unsigned int> textures;
+
+    Object(): color(1.f), shininess(8.f), textures(2) {}
+};
+
+int main(int argc, char* argv[]) {
+    const size_t PIVOT_COUNT = 1000;
+    const size_t ENTITY_COUNT = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    // Même hiérarchie dans les deux représentations: des pivots tournés, chacun avec ses objets
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-100.f, 100.f), size(0.1f, 2.f);
+    glimac::Scene scene;
+    scene.reserve(PIVOT_COUNT + ENTITY_COUNT);
+    Node root;
+    std::vector<Node*> pivots;
+    for (size_t p = 0; p < PIVOT_COUNT; ++p) {
+        glm::mat4 matrix = glm::rotate(glm::translate(glm::mat4(1.f), glm::vec3(position(rng), 0, position(rng))), float(p), glm::vec3(0, 1, 0));
+        scene.create(glimac::NO_ENTITY, matrix);
+        root.children.emplace_back(new Node());
+        root.children.back()->localMatrix = matrix;
+        pivots.push_back(root.children.back().get());
+    }
+    for (size_t i = 0; i < ENTITY_COUNT; ++i) {
+        glm::mat4 matrix = glm::translate(glm::mat4(1.f), glm::vec3(position(rng), position(rng) * 0.1f, position(rng)));
+        glm::vec3 half(size(rng));
+        glimac::Entity entity = scene.create(i % PIVOT_COUNT, matrix);
+        scene.setMesh(entity, 0);
+        scene.setLocalBounds(entity, glimac::BBox3f(-half, half));
+
+        Node* node = new Node();
+        node->localMatrix = matrix;
+        node->localBounds = glimac::BBox3f(-half, half);
+        node->drawable = true;
+        pivots[i % PIVOT_COUNT]->children.emplace_back(node);
+    }
+    glimac::Frustum frustum(glm::perspective(glm::radians(70.f), 16.f / 9.f, 0.1f, 100.f) *
+                            glm::lookAt(glm::vec3(0, 5, 0), glm::vec3(10, 0, 3), glm::vec3(0, 1, 0)));
+
+    std::printf("%zu entities under %zu pivots\n", ENTITY_COUNT, PIVOT_COUNT);
+    bench::report("  node tree: update world matrices", bench::measure([&]() {
+        updateNode(root, glm::mat4(1.f));
+    }));
+    bench::report("  Scene: updateWorldMatrices", bench::measure([&]() {
+        scene.updateWorldMatrices();
+    }));
+    bench::report("  node tree: cull", bench::measure([&]() {
+        bench::doNotOptimize(cullNode(root, frustum));
+    }));
+    std::vector<unsigned char> visible;
+    bench::report("  Scene: cull", bench::measure([&]() {
+        bench::doNotOptimize(scene.cull(frustum, visible));
+    }));
+
+    std::printf("%zu objects created then destroyed\n", ENTITY_COUNT);
+    bench::report("  new / delete", bench::measure([&]() {
+        std::vector<Object*> objects;
+        objects.reserve(ENTITY_COUNT);
+        for (size_t i = 0; i < ENTITY_COUNT; ++i) {
+            objects.push_back(new Object());
+        }
+        bench::doNotOptimize(objects.back());
+        for (auto object : objects) {
+            delete object;
+        }
+    }));
+    glimac::Arena arena(1024 * 1024);
+    bench::report("  Arena::create / clear", bench::measure([&]() {
+        for (size_t i = 0; i < ENTITY_COUNT; ++i) {
+            bench::doNotOptimize(arena.create<Object>());
+        }
+        arena.clear();
+    }));
+    return 0;
+}
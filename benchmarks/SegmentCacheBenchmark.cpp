@@ -0,0 +1,36 @@
+#include <glimac/SegmentCache.hpp>
+#include "Benchmark.hpp"
+
+// Table des tronçons du circuit (glimac::SegmentCache, utilisée par Circuit::GetSegments): recalculée à
+// chaque frame (normalize, acos, rotate, inverse...) contre la table mise en cache derrière le numéro de
+// version des points. Temps par frame
+
+int main() {
+    const int FRAME_COUNT = 10;
+    for (int pointCount : {1000, 10000, 100000, 1000000}) {
+        std::vector<glm::vec3> points, colors;
+        for (int i = 0; i < pointCount; ++i) {
+            float angle = 6.2831853f * i / pointCount;
+            points.push_back(glm::vec3(10 * glm::cos(angle), glm::sin(3 * angle), 10 * glm::sin(angle)));
+            colors.push_back(glm::vec3(1));
+        }
+        // les points ont été modifiés une fois, puis plus jamais
+        const unsigned int version = 1;
+
+        std::printf("%d segments, per frame\n", pointCount);
+        glimac::SegmentCache recomputed;
+        bench::report("  recomputed every frame", bench::measure([&]() {
+            for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+                recomputed.rebuild(points, colors);
+                bench::doNotOptimize(recomputed.get(points, colors, recomputed.getVersion()).back());
+            }
+        }) / FRAME_COUNT);
+        glimac::SegmentCache cached;
+        bench::report("  cached behind the version", bench::measure([&]() {
+            for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+                bench::doNotOptimize(cached.get(points, colors, version).back());
+            }
+        }) / FRAME_COUNT);
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <cmath>
+#include <map>
+#include <tiny_obj_vertex_map.h>
+#include "Benchmark.hpp"
+
+// Déduplication des coins de faces d'un OBJ (v/vt/vn -> indice de sommet) de 100k à 10M triangles:
+// std::map de l'ancien chargeur contre vertex_index_map, réservée pour tous les coins ou pour un quart
+// (estimation utilisée)
+
+struct VertexIndexLess {
+    bool operator ()(const tinyobj::vertex_index& a, const tinyobj::vertex_index& b) const {
+        if (a.v_idx != b.v_idx) return a.v_idx < b.v_idx;
+        if (a.vn_idx != b.vn_idx) return a.vn_idx < b.vn_idx;
+        return a.vt_idx < b.vt_idx;
+    }
+};
+
+// Coins d'une grille de size x size quads découpés en triangles, dans l'ordre d'un fichier OBJ
+static std::vector<tinyobj::vertex_index> gridCorners(int size) {
+    std::vector<tinyobj::vertex_index> corners;
+    corners.reserve(size_t(size) * size * 6);
+    auto corner = [&](int x, int y) {
+        int index = y * (size + 1) + x;
+        corners.push_back(tinyobj::vertex_index(index, index, index));
+    };
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            corner(x, y); corner(x + 1, y); corner(x + 1, y + 1);
+            corner(x, y); corner(x + 1, y + 1); corner(x, y + 1);
+        }
+    }
+    return corners;
+}
+
+static size_t dedupHashMap(const std::vector<tinyobj::vertex_index>& corners, size_t expected, size_t& capacity) {
+    tinyobj::vertex_index_map cache(expected);
+    size_t vertexCount = 0;
+    for (const auto& corner : corners) {
+        bool inserted;
+        cache.find_or_insert(corner, vertexCount, inserted);
+        vertexCount += inserted;
+    }
+    capacity = cache.capacity();
+    return vertexCount;
+}
+
+int main() {
+    for (int triangleCount : { 100000, 1000000, 10000000 }) {
+        // grille carrée: 2 triangles par quad
+        int size = int(std::lround(std::sqrt(triangleCount / 2.)));
+        auto corners = gridCorners(size);
+        std::printf("%zu triangles, %zu corners, %d unique vertices\n", corners.size() / 3, corners.size(), (size + 1) * (size + 1));
+
+        bench::report("  std::map", bench::measure([&]() {
+            std::map<tinyobj::vertex_index, unsigned int, VertexIndexLess> cache;
+            for (const auto& corner : corners) {
+                cache.insert(std::make_pair(corner, (unsigned int)cache.size()));
+            }
+            bench::doNotOptimize(cache.size());
+        }, 3));
+
+        size_t capacity = 0;
+        double time = bench::measure([&]() {
+            bench::doNotOptimize(dedupHashMap(corners, corners.size(), capacity));
+        }, 3);
+        std::printf("  %-46s %10.3f ms, %zu KiB\n", "vertex_index_map, reserved for every corner", time, capacity * 16 / 1024);
+        time = bench::measure([&]() {
+            bench::doNotOptimize(dedupHashMap(corners, corners.size() / 4, capacity));
+        }, 3);
+        std::printf("  %-46s %10.3f ms, %zu KiB\n", "vertex_index_map, reserved for corners / 4", time, capacity * 16 / 1024);
+    }
+    return 0;
+}
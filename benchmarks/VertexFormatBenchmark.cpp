@@ -0,0 +1,65 @@
+#include "GLTestContext.hpp"
+#include <glimac/MeshBuffer.hpp>
+#include "Benchmark.hpp"
+
+// Maillages statiques de la scène (wagon.obj et le sol 20 x 20 de main.cpp) enregistrés en VertexFormat::Float
+// puis en VertexFormat::Packed: octets réellement envoyés (getUploadedBytes) à côté de ce qu'ils pèseraient en
+// Float (getUnpackedBytes), et temps d'envoi
+
+// Même grille que Rectangle dans main.cpp (élévation pseudo-aléatoire dans [0, 0.4])
+static void buildFloor(int size, std::vector<glimac::ShapeVertex>& vertices, std::vector<unsigned int>& indices) {
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < size; ++j) {
+            float elevation = ((i * 7919 + j * 104729) % 1000) * 0.0004f;
+            vertices.push_back(glimac::ShapeVertex(glm::vec3(i, elevation, j), glm::vec3(0, 1, 0), glm::vec2(i, j) / float(size - 1)));
+        }
+    }
+    for (int j = 0; j < size - 1; ++j) {
+        int offset = j * size;
+        for (int i = 0; i < size - 1; ++i) {
+            indices.insert(indices.end(), { unsigned(i + size + offset), unsigned(i + 1 + offset), unsigned(i + offset) });
+            indices.insert(indices.end(), { unsigned(i + size + offset), unsigned(i + size + 1 + offset), unsigned(i + 1 + offset) });
+        }
+    }
+}
+
+static void printBytes(const char* name, const glimac::MeshBuffer& mesh) {
+    std::printf("  %-14s %10zu bytes uploaded, %10zu bytes unpacked (%.0f%%)\n", name, mesh.getUploadedBytes(), mesh.getUnpackedBytes(),
+                100. * mesh.getUploadedBytes() / mesh.getUnpackedBytes());
+}
+
+int main() {
+    test::GLTestContext context;
+    if (!context.isValid()) {
+        return TEST_SKIPPED;
+    }
+
+    glimac::Geometry wagon;
+    if (!wagon.loadOBJ(GLIMAC_ASSETS_DIR "/models/wagon.obj", GLIMAC_ASSETS_DIR "/models/wagon.mtl", false)) {
+        std::fprintf(stderr, "cannot load wagon.obj\n");
+        return 1;
+    }
+    std::vector<glimac::ShapeVertex> floorVertices;
+    std::vector<unsigned int> floorIndices;
+    buildFloor(20, floorVertices, floorIndices);
+    std::printf("wagon: %zu vertices, %zu indices; floor: %zu vertices, %zu indices\n", wagon.getVertexCount(), wagon.getIndexCount(),
+                floorVertices.size(), floorIndices.size());
+
+    for (glimac::VertexFormat format : { glimac::VertexFormat::Float, glimac::VertexFormat::Packed }) {
+        std::printf("%s\n", format == glimac::VertexFormat::Float ? "Float (32 bytes per vertex)" : "Packed (16 bytes per vertex)");
+        glimac::MeshRegistry registry;
+        printBytes("wagon", registry.add("wagon", wagon, format));
+        printBytes("floor", registry.add("floor", floorVertices, floorIndices, format));
+        std::printf("  %-14s %10zu bytes uploaded, %10zu bytes unpacked\n", "registry", registry.getUploadedBytes(), registry.getUnpackedBytes());
+
+        bench::report("  wagon + floor upload", bench::measure([&]() {
+            glimac::MeshRegistry uploads;
+            uploads.add("wagon", wagon, format);
+            uploads.add("floor", floorVertices, floorIndices, format);
+            glFinish();
+            uploads.clear();
+        }));
+        registry.clear();
+    }
+    return 0;
+}
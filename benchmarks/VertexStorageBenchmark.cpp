@@ -0,0 +1,72 @@
+#include <filesystem>
+#include <fstream>
+#include <glimac/Geometry.hpp>
+#include "Benchmark.hpp"
+
+// Passes qui ne lisent qu'un ou deux attributs, sur le même maillage stocké en AoS (sommets entrelacés)
+// et en SoA (un tableau par attribut): parcours des positions, boîte englobante, recalcul des normales
+
+static float sumPositions(const glimac::Geometry& geometry) {
+    auto positions = geometry.getPositions();
+    glm::vec3 sum(0.f);
+    for (size_t i = 0; i < positions.m_nCount; ++i) {
+        sum += positions[i];
+    }
+    return sum.x + sum.y + sum.z;
+}
+
+int main(int argc, char* argv[]) {
+    const int SIZE = argc > 1 ? std::atoi(argv[1]) : 3162;
+    // Sans normales dans le fichier: loadOBJ les génère, comme recomputeNormals
+    std::filesystem::path filename = std::filesystem::temp_directory_path() / "glimac_vertex_storage_benchmark.obj";
+    {
+        std::ofstream obj(filename);
+        for (int y = 0; y <= SIZE; ++y) {
+            for (int x = 0; x <= SIZE; ++x) {
+                obj << "v " << x * 0.01f << " " << (x * y % 13) * 0.001f << " " << y * 0.01f << "\n";
+                obj << "vt " << x / float(SIZE) << " " << y / float(SIZE) << "\n";
+            }
+        }
+        for (int y = 0; y < SIZE; ++y) {
+            for (int x = 0; x < SIZE; ++x) {
+                int i = y * (SIZE + 1) + x + 1;
+                int j = i + SIZE + 1;
+                obj << "f " << i << "/" << i << " " << i + 1 << "/" << i + 1 << " " << j + 1 << "/" << j + 1 << "\n";
+                obj << "f " << i << "/" << i << " " << j + 1 << "/" << j + 1 << " " << j << "/" << j << "\n";
+            }
+        }
+    }
+
+    glimac::Geometry aos, soa;
+    if (!aos.loadOBJ(filename.string(), "", false) || !soa.loadOBJ(filename.string(), "", false)) {
+        return EXIT_FAILURE;
+    }
+    bench::report("setVertexStorage(SoA)", bench::measure([&]() {
+        glimac::Geometry copy = aos;
+        copy.setVertexStorage(glimac::VertexStorage::SoA);
+        bench::doNotOptimize(copy);
+    }, 3));
+    soa.setVertexStorage(glimac::VertexStorage::SoA);
+    std::printf("%zu vertices, %zu triangles\n", aos.getVertexCount(), aos.getIndexCount() / 3);
+
+    for (auto geometry : { &aos, &soa }) {
+        const char* storage = geometry == &aos ? "AoS" : "SoA";
+        char name[64];
+        std::snprintf(name, sizeof(name), "%s: sum of positions", storage);
+        bench::report(name, bench::measure([&]() {
+            bench::doNotOptimize(sumPositions(*geometry));
+        }));
+        std::snprintf(name, sizeof(name), "%s: computeBoundingBox", storage);
+        bench::report(name, bench::measure([&]() {
+            geometry->computeBoundingBox();
+        }));
+        std::snprintf(name, sizeof(name), "%s: recomputeNormals", storage);
+        bench::report(name, bench::measure([&]() {
+            geometry->recomputeNormals();
+        }, 3));
+    }
+
+    std::filesystem::remove(filename);
+    std::filesystem::remove(filename.string() + ".cache");
+    return 0;
+}
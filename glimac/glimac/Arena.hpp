@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace glimac {
+
+// Allocateur par blocs: les objets sont placés les uns à la suite des autres dans de grands blocs et
+// sont tous détruits avec l'arène, dans l'ordre inverse de leur création. Aucun objet n'est libéré seul
+class Arena {
+public:
+    explicit Arena(size_t blockSize = 64 * 1024);
+
+    ~Arena();
+
+    // Construit un T dans l'arène: le pointeur reste valide jusqu'à clear() ou la destruction de l'arène
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value) {
+            m_Destructors.push_back(Destructor{ object, &destroy<T> });
+        }
+        return object;
+    }
+
+    // Mémoire brute, alignment doit être une puissance de 2
+    void* allocate(size_t size, size_t alignment);
+
+    // Détruit tous les objets et garde le premier bloc pour les allocations suivantes
+    void clear();
+
+    // Octets alloués par create / allocate (sans les pertes dues à l'alignement)
+    size_t getAllocatedBytes() const {
+        return m_nAllocatedBytes;
+    }
+
+    size_t getBlockCount() const {
+        return m_Blocks.size();
+    }
+
+private:
+    Arena(const Arena&);
+    Arena& operator =(const Arena&);
+
+    struct Destructor {
+        void* object;
+        void (*destroy)(void*);
+    };
+
+    template<typename T>
+    static void destroy(void* object) {
+        static_cast<T*>(object)->~T();
+    }
+
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> m_Blocks;
+    std::vector<Destructor> m_Destructors;
+    size_t m_nBlockSize;
+    size_t m_nUsed = 0; // dans le dernier bloc
+    size_t m_nAllocatedBytes = 0;
+};
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <future>
+#include <memory>
+#include "FilePath.hpp"
+#include "Image.hpp"
+#include "ThreadPool.hpp"
+
+namespace glimac {
+
+// Charge les assets en parallèle sur un ThreadPool. Seul le décodage est fait sur les threads de
+// travail: l'envoi au GPU (TextureManager, MeshRegistry) reste sur le thread du contexte GL.
+class AssetLoader {
+public:
+    explicit AssetLoader(ThreadPool& pool = ThreadPool::getDefault()):
+        m_Pool(pool) {
+    }
+
+    // Décode une image; le future contient un pointeur nul en cas d'erreur
+    std::future<std::unique_ptr<Image>> loadImage(const FilePath& filepath, PixelFormat format = PixelFormat::RGBA32F);
+
+    // Même chose en passant par le cache d'ImageManager
+    std::future<const Image*> loadManagedImage(const FilePath& filepath);
+
+private:
+    ThreadPool& m_Pool;
+};
+
+}
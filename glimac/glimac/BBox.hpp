@@ -1,10 +1,13 @@
 #pragma once
 
 #include "glm.hpp"
+#include <cstddef>
 #include <iostream>
 
 namespace glimac {
 
+class ThreadPool;
+
 struct BBox3f
 {
     static const auto dim = 3;
@@ -23,6 +26,18 @@ struct BBox3f
     bool empty() const { for (auto i = 0u; i < dim; i++) if (lower[i] > upper[i]) return true; return false; }
 
     glm::vec3 size() const { return upper - lower; }
+
+    /*! empty box (lower = +inf, upper = -inf), neutral element of grow and merge */
+    static BBox3f emptyBox();
+
+    /*! bounds of count points separated by stride bytes, computed with SSE min/max reductions when
+     *  available. Exact for finite and infinite coordinates: same result as growing a box one point at
+     *  a time. Empty box if count is 0. The result is undefined if a coordinate is NaN (_mm_min_ps and
+     *  glm::min do not propagate it the same way, so it depends on the path and on the point's position) */
+    static BBox3f fromPoints(const glm::vec3* points, size_t count, size_t stride = sizeof(glm::vec3));
+
+    /*! same, large arrays being split between the threads of pool */
+    static BBox3f fromPoints(const glm::vec3* points, size_t count, size_t stride, ThreadPool& pool);
 };
 
 /*! tests if box is empty */
@@ -89,6 +104,20 @@ inline bool subset( const BBox3f& a, const BBox3f& b )
   return true;
 }
 
+/*! bounds of a box transformed by an affine matrix (Arvo: each column widens the box by its
+ *  contribution to the lower and upper corners, without transforming the 8 corners) */
+inline BBox3f transform(const glm::mat4& m, const BBox3f& box) {
+  glm::vec3 lower(m[3]), upper(m[3]);
+  for (auto i = 0; i < 3; i++) {
+    const glm::vec3 column(m[i]);
+    const glm::vec3 a = column * box.lower[i];
+    const glm::vec3 b = column * box.upper[i];
+    lower += glm::min(a, b);
+    upper += glm::max(a, b);
+  }
+  return BBox3f(lower, upper);
+}
+
 /*! output operator */
 inline std::ostream& operator<<(std::ostream& cout, const BBox3f& box) {
   return cout << "[" << box.lower << "; " << box.upper << "]";
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "BBox.hpp"
+#include "Frustum.hpp"
+#include "glm.hpp"
+
+namespace glimac {
+
+// Demi-droite origin + t * direction, limitée à [tMin, tMax] (direction n'a pas besoin d'être normalisée)
+struct Ray {
+    glm::vec3 origin;
+    glm::vec3 direction;
+    float tMin;
+    float tMax;
+
+    Ray(const glm::vec3& o, const glm::vec3& d, float minT = 0.f, float maxT = std::numeric_limits<float>::infinity()):
+        origin(o), direction(d), tMin(minT), tMax(maxT) {
+    }
+};
+
+struct RayHit {
+    uint32_t primitive; // indice donné à la construction (numéro de boîte ou de triangle)
+    float t;
+};
+
+// Test des plans de la boîte (slabs), invDirection = 1 / direction. En cas de succès, tEntry reçoit
+// le paramètre d'entrée dans la boîte, borné par tMin
+inline bool intersectBox(const BBox3f& box, const glm::vec3& origin, const glm::vec3& invDirection, float tMin, float tMax, float& tEntry) {
+    glm::vec3 t0 = (box.lower - origin) * invDirection;
+    glm::vec3 t1 = (box.upper - origin) * invDirection;
+    glm::vec3 tNear = glm::min(t0, t1);
+    glm::vec3 tFar = glm::max(t0, t1);
+    tEntry = glm::max(glm::max(tNear.x, tNear.y), glm::max(tNear.z, tMin));
+    float tExit = glm::min(glm::min(tFar.x, tFar.y), glm::min(tFar.z, tMax));
+    return tEntry <= tExit;
+}
+
+// Distance d'un point à une boîte (0 s'il est dedans)
+inline float distanceToBox(const BBox3f& box, const glm::vec3& point) {
+    return glm::length(glm::max(glm::max(box.lower - point, point - box.upper), glm::vec3(0.f)));
+}
+
+// Möller-Trumbore, sans élimination des faces arrières
+bool intersectTriangle(const Ray& ray, const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, float& t);
+
+// Hiérarchie de boîtes englobantes construite par SAH (surface area heuristic) sur des intervalles.
+// Les noeuds sont rangés en profondeur d'abord dans un seul tableau: l'enfant gauche suit son parent,
+// seul l'indice de l'enfant droit est stocké, et les primitives d'une feuille sont contiguës
+class BVH {
+public:
+    struct Node {
+        BBox3f bounds;
+        uint32_t offset; // feuille: première entrée de getPrimitives(), noeud interne: indice de l'enfant droit
+        uint32_t count;  // nombre de primitives de la feuille, 0 pour un noeud interne
+
+        bool isLeaf() const {
+            return count > 0;
+        }
+    };
+
+    // Profondeur maximale de l'arbre, et donc de la pile des parcours
+    static const size_t MAX_DEPTH = 64;
+
+    BVH() {}
+
+    // Une primitive par boîte (objets de la scène, triangles...), numérotée par sa position dans boxes
+    explicit BVH(const std::vector<BBox3f>& boxes);
+
+    // Une primitive par triangle (indices[3 * i], indices[3 * i + 1], indices[3 * i + 2]),
+    // les positions étant séparées de stride octets
+    static BVH fromTriangles(const glm::vec3* positions, size_t stride, const unsigned int* indices, size_t triangleCount);
+
+    const std::vector<Node>& getNodes() const {
+        return m_Nodes;
+    }
+
+    // Primitives dans l'ordre des feuilles
+    const std::vector<uint32_t>& getPrimitives() const {
+        return m_Primitives;
+    }
+
+    bool empty() const {
+        return m_Nodes.empty();
+    }
+
+    BBox3f getBounds() const {
+        return m_Nodes.empty() ? BBox3f::emptyBox() : m_Nodes[0].bounds;
+    }
+
+    // Ajoute à result les primitives des feuilles dont la boîte touche la requête: c'est un sur-ensemble
+    // des primitives touchées, à tester ensuite par l'appelant. L'ordre n'est pas défini
+    void queryBox(const BBox3f& box, std::vector<uint32_t>& result) const;
+
+    void queryFrustum(const Frustum& frustum, std::vector<uint32_t>& result) const;
+
+    void queryRay(const Ray& ray, std::vector<uint32_t>& result) const;
+
+    // Intersection la plus proche: intersect(primitive, ray, t) teste une primitive et renvoit true en
+    // remplissant t s'il y a intersection. Les noeuds sont visités du plus proche au plus lointain et
+    // ceux qui commencent après la meilleure intersection trouvée sont ignorés
+    template<typename Intersect>
+    bool closestHit(const Ray& ray, RayHit& hit, Intersect intersect) const;
+
+    // Distance de point à la primitive la plus proche: distance(primitive, point) renvoit la distance exacte
+    // à une primitive, qui doit être contenue dans sa boîte. Les noeuds sont visités du plus proche au plus
+    // lointain et ceux dont la boîte est plus loin que la meilleure distance trouvée sont ignorés.
+    // Renvoit l'infini pour un arbre vide
+    template<typename Distance>
+    float nearestDistance(const glm::vec3& point, Distance distance) const;
+
+    // closestHit sur les triangles donnés à fromTriangles (mêmes positions, stride et indices)
+    bool closestTriangle(const Ray& ray, const glm::vec3* positions, size_t stride, const unsigned int* indices, RayHit& hit) const;
+
+private:
+    struct BuildPrimitive {
+        BBox3f bounds;
+        glm::vec3 centroid;
+        uint32_t index;
+    };
+
+    void build(std::vector<BuildPrimitive>& primitives);
+
+    uint32_t buildNode(std::vector<BuildPrimitive>& primitives, uint32_t begin, uint32_t end, size_t depth);
+
+    std::vector<Node> m_Nodes;
+    std::vector<uint32_t> m_Primitives;
+};
+
+template<typename Intersect>
+bool BVH::closestHit(const Ray& ray, RayHit& hit, Intersect intersect) const {
+    if (m_Nodes.empty()) {
+        return false;
+    }
+    const glm::vec3 invDirection = 1.f / ray.direction;
+    Ray current = ray;
+    bool found = false;
+
+    // Chaque entrée garde le paramètre d'entrée dans la boîte pour être ignorée une fois dépassée
+    std::pair<uint32_t, float> stack[MAX_DEPTH + 1];
+    size_t top = 0;
+    float tEntry;
+    if (intersectBox(m_Nodes[0].bounds, ray.origin, invDirection, ray.tMin, ray.tMax, tEntry)) {
+        stack[top++] = std::make_pair(0u, tEntry);
+    }
+    while (top > 0) {
+        auto entry = stack[--top];
+        if (entry.second > current.tMax) {
+            continue;
+        }
+        const Node& node = m_Nodes[entry.first];
+        if (node.isLeaf()) {
+            for (auto i = node.offset; i < node.offset + node.count; ++i) {
+                float t;
+                if (intersect(m_Primitives[i], current, t) && t >= current.tMin && t <= current.tMax) {
+                    current.tMax = t;
+                    hit.primitive = m_Primitives[i];
+                    hit.t = t;
+                    found = true;
+                }
+            }
+            continue;
+        }
+        uint32_t left = entry.first + 1, right = node.offset;
+        float tLeft, tRight;
+        bool hitLeft = intersectBox(m_Nodes[left].bounds, ray.origin, invDirection, current.tMin, current.tMax, tLeft);
+        bool hitRight = intersectBox(m_Nodes[right].bounds, ray.origin, invDirection, current.tMin, current.tMax, tRight);
+        // Le plus proche est empilé en dernier pour être visité en premier
+        if (hitLeft && hitRight) {
+            if (tLeft < tRight) {
+                stack[top++] = std::make_pair(right, tRight);
+                stack[top++] = std::make_pair(left, tLeft);
+            }
+            else {
+                stack[top++] = std::make_pair(left, tLeft);
+                stack[top++] = std::make_pair(right, tRight);
+            }
+        }
+        else if (hitLeft) {
+            stack[top++] = std::make_pair(left, tLeft);
+        }
+        else if (hitRight) {
+            stack[top++] = std::make_pair(right, tRight);
+        }
+    }
+    return found;
+}
+
+template<typename Distance>
+float BVH::nearestDistance(const glm::vec3& point, Distance distance) const {
+    float nearest = std::numeric_limits<float>::infinity();
+    if (m_Nodes.empty()) {
+        return nearest;
+    }
+
+    // Chaque entrée garde la distance à sa boîte pour être ignorée si une primitive plus proche a été trouvée
+    std::pair<uint32_t, float> stack[MAX_DEPTH + 1];
+    size_t top = 0;
+    stack[top++] = std::make_pair(0u, distanceToBox(m_Nodes[0].bounds, point));
+    while (top > 0) {
+        auto entry = stack[--top];
+        if (entry.second >= nearest) {
+            continue;
+        }
+        const Node& node = m_Nodes[entry.first];
+        if (node.isLeaf()) {
+            for (auto i = node.offset; i < node.offset + node.count; ++i) {
+                nearest = std::min(nearest, float(distance(m_Primitives[i], point)));
+            }
+            continue;
+        }
+        uint32_t left = entry.first + 1, right = node.offset;
+        float distanceLeft = distanceToBox(m_Nodes[left].bounds, point);
+        float distanceRight = distanceToBox(m_Nodes[right].bounds, point);
+        // Le plus proche est empilé en dernier pour être visité en premier
+        if (distanceLeft < distanceRight) {
+            stack[top++] = std::make_pair(right, distanceRight);
+            stack[top++] = std::make_pair(left, distanceLeft);
+        }
+        else {
+            stack[top++] = std::make_pair(left, distanceLeft);
+            stack[top++] = std::make_pair(right, distanceRight);
+        }
+    }
+    return nearest;
+}
+
+}
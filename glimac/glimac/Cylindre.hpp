@@ -14,10 +14,27 @@ class Cylindre {
 public:
     // Constructeur: alloue le tableau de données et construit les attributs des vertex
     Cylindre(GLfloat height, GLfloat radius, GLsizei discLat, GLsizei discHeight):
-        m_nVertexCount(0) {
+        m_nVertexCount(0), m_fHeight(height), m_fRadius(radius) {
         build(height, radius, discLat, discHeight); // Construction (voir le .cpp)
     }
 
+    // Niveaux de détail: le premier est discrétisé en (discLat, discHeight), chaque niveau suivant
+    // divise la discrétisation par deux
+    static std::vector<Cylindre> createLODChain(GLfloat height, GLfloat radius, GLsizei discLat, GLsizei discHeight, unsigned int levelCount = 4);
+
+    GLfloat getHeight() const {
+        return m_fHeight;
+    }
+
+    GLfloat getRadius() const {
+        return m_fRadius;
+    }
+
+    // Rayon de la sphère englobante, centrée au milieu de l'axe
+    GLfloat getBoundingRadius() const {
+        return glm::sqrt(m_fRadius * m_fRadius + .25f * m_fHeight * m_fHeight);
+    }
+
     // Renvoit le pointeur vers les données
     const ShapeVertex* getDataPointer() const {
         return &m_Vertices[0];
@@ -28,9 +45,31 @@ public:
         return m_nVertexCount;
     }
 
+    // Version indexée: chaque sommet n'apparaît qu'une fois, les triangles sont décrits par le tableau d'index
+    // (le triangle k est formé des mêmes sommets que les vertex 3k, 3k + 1 et 3k + 2 de getDataPointer())
+    const ShapeVertex* getIndexedDataPointer() const {
+        return m_IndexedVertices.data();
+    }
+
+    GLsizei getIndexedVertexCount() const {
+        return m_IndexedVertices.size();
+    }
+
+    const unsigned int* getIndexPointer() const {
+        return m_Indices.data();
+    }
+
+    GLsizei getIndexCount() const {
+        return m_Indices.size();
+    }
+
 private:
     std::vector<ShapeVertex> m_Vertices;
     GLsizei m_nVertexCount; // Nombre de sommets
+    std::vector<ShapeVertex> m_IndexedVertices; // Sommets uniques
+    std::vector<unsigned int> m_Indices;
+    GLfloat m_fHeight;
+    GLfloat m_fRadius;
 };
     
 }
@@ -0,0 +1,62 @@
+#pragma once
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+#include <cstddef>
+
+namespace glimac {
+
+// Tableau de données lu par les shaders avec texelFetch (GLSL ES 3.0 n'a pas de buffer textures):
+// texture 2D de largeur fixe remplie ligne par ligne, l'élément i étant le texel (i % largeur, i / largeur).
+// La hauteur grandit avec le nombre de texels envoyés. Filtrage GL_NEAREST (obligatoire pour les formats entiers).
+// Chaque texture a son unité de texture, où elle reste bindée: le shader la lit sans autre bind
+class DataTexture {
+public:
+    // internalFormat / format / type: par exemple GL_RGBA32F / GL_RGBA / GL_FLOAT ou GL_R32UI / GL_RED_INTEGER /
+    // GL_UNSIGNED_INT. texelSize en octets. unit: unité de texture réservée à cette texture
+    DataTexture(GLenum internalFormat, GLenum format, GLenum type, size_t texelSize, GLsizei width, GLuint unit);
+
+    ~DataTexture();
+
+    DataTexture(DataTexture&& rvalue);
+
+    DataTexture& operator =(DataTexture&& rvalue);
+
+    // Remplace le contenu par texelCount texels consécutifs (la texture n'est réallouée que si elle est trop petite).
+    // La texture est bindée sur son unité et y reste
+    void upload(const void* texels, size_t texelCount);
+
+    GLuint getGLId() const {
+        return m_nTexture;
+    }
+
+    GLuint getUnit() const {
+        return m_nUnit;
+    }
+
+    GLsizei getWidth() const {
+        return m_nWidth;
+    }
+
+    GLsizei getHeight() const {
+        return m_nHeight;
+    }
+
+private:
+    DataTexture(const DataTexture&);
+    DataTexture& operator =(const DataTexture&);
+
+    void release();
+
+    GLuint m_nTexture = 0;
+    GLenum m_InternalFormat;
+    GLenum m_Format;
+    GLenum m_Type;
+    size_t m_nTexelSize;
+    GLsizei m_nWidth;
+    GLsizei m_nHeight = 0;
+    GLuint m_nUnit;
+};
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include "BBox.hpp"
+#include "glm.hpp"
+
+namespace glimac {
+
+// Pyramide de vue: 6 plans (a, b, c, d) dont la normale pointe vers l'intérieur, un point p étant
+// à l'intérieur quand a.x + b.y + c.z + d >= 0 pour les 6 plans
+struct Frustum {
+    enum Side {
+        OUTSIDE,
+        INTERSECTS,
+        INSIDE
+    };
+
+    glm::vec4 planes[6]; // gauche, droite, bas, haut, proche, lointain
+
+    Frustum() {}
+
+    // Extrait les plans d'une matrice projection * vue (* modèle): ils sont alors exprimés dans le repère
+    // d'origine de la matrice (monde, ou objet si la matrice modèle est incluse)
+    explicit Frustum(const glm::mat4& matrix);
+
+    // Test des sommets p / n: OUTSIDE si la boîte est entièrement derrière un plan, INSIDE si elle est
+    // devant les 6. Conservatif: une boîte près d'un coin peut être classée INTERSECTS sans toucher le frustum
+    Side classify(const BBox3f& box) const;
+
+    bool intersects(const BBox3f& box) const {
+        return classify(box) != OUTSIDE;
+    }
+
+    bool intersects(const glm::vec3& center, float radius) const;
+
+    // Teste count boîtes d'un coup (visible[i] = 0 si boxes[i] est entièrement derrière un plan) et renvoit
+    // le nombre de boîtes visibles. Les plans sont testés 4 par 4 avec SSE quand il est disponible
+    size_t testBoxes(const BBox3f* boxes, size_t count, unsigned char* visible) const;
+};
+
+}
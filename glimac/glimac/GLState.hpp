@@ -0,0 +1,36 @@
+#pragma once
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+
+namespace glimac {
+
+// Cache de l'état GL le plus souvent modifié entre deux draw calls (programme, VAO, textures 2D): un bind
+// vers l'objet déjà bindé n'est pas envoyé au driver. Les changements effectifs sont comptés dans
+// RenderStats. Tout le code qui binde ces objets doit passer par ici, sinon appeler invalidate()
+class GLState {
+public:
+    static const GLuint MAX_TEXTURE_UNITS = 16;
+
+    static void useProgram(GLuint program);
+
+    static void bindVertexArray(GLuint vertexArray);
+
+    // Binde la texture sur GL_TEXTURE_2D de l'unité donnée (change l'unité active si besoin)
+    static void bindTexture(GLuint unit, GLuint texture);
+
+    // Détruit le VAO: s'il était bindé, le VAO 0 le remplace
+    static void deleteVertexArray(GLuint vertexArray);
+
+    // Oublie l'état connu: le prochain bind de chaque type sera envoyé au driver
+    static void invalidate();
+
+private:
+    static GLuint m_nProgram;
+    static GLuint m_nVertexArray;
+    static GLuint m_nActiveUnit;
+    static GLuint m_BoundTextures[MAX_TEXTURE_UNITS];
+};
+
+}
@@ -1,14 +1,43 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <type_traits>
 #include "Image.hpp"
 #include "FilePath.hpp"
 #include "BBox.hpp"
 
 namespace glimac {
 
+// How Geometry stores its vertices: one interleaved Vertex array (AoS), or one array per
+// attribute (SoA) so that passes reading a single attribute only touch that attribute's memory
+enum class VertexStorage {
+    AoS,
+    SoA
+};
+
+// Zero-copy view on one vertex attribute, whatever the storage: the stride is sizeof(Vertex)
+// in AoS and sizeof(T) in SoA. T may be const for a read-only view.
+template<typename T>
+struct VertexStream {
+    typedef typename std::conditional<std::is_const<T>::value, const char, char>::type Byte;
+
+    T* m_pData;
+    size_t m_nStride; // In bytes
+    size_t m_nCount;
+
+    T& operator [](size_t i) const {
+        return *reinterpret_cast<T*>(reinterpret_cast<Byte*>(m_pData) + i * m_nStride);
+    }
+
+    // True when the elements are tightly packed, so the stream can be uploaded or copied as is
+    bool isContiguous() const {
+        return m_nStride == sizeof(T);
+    }
+};
+
 class Geometry {
 public:
     struct Vertex {
@@ -44,23 +73,79 @@ public:
     };
 
 private:
-    std::vector<Vertex> m_VertexBuffer;
+    VertexStorage m_Storage = VertexStorage::AoS;
+    std::vector<Vertex> m_VertexBuffer; // AoS storage
+    std::vector<glm::vec3> m_Positions; // SoA storage
+    std::vector<glm::vec3> m_Normals;
+    std::vector<glm::vec2> m_TexCoords;
     std::vector<unsigned int> m_IndexBuffer;
     std::vector<Mesh> m_MeshBuffer;
     std::vector<Material> m_Materials;
     BBox3f m_BBox;
+    float m_fCreaseAngle = 3.14159265f; // pi: no crease, every vertex is smoothed
+
+    // Smooth normals for the triangles [indexOffset, indexOffset + indexCount), whose vertices are in
+    // [firstVertex, firstVertex + vertexCount). Vertices split along creases are appended to the geometry
+    void generateNormals(size_t indexOffset, size_t indexCount, size_t firstVertex, size_t vertexCount);
+
+    VertexStream<glm::vec3> getMutablePositions();
+    VertexStream<glm::vec3> getMutableNormals();
+
+    // Parsing, cache and optimization always work on the AoS buffer, loadOBJ converts around it
+    bool loadOBJData(const FilePath& filepath, const FilePath& mtlBasePath, bool loadTextures);
+
+    // Size and modification time of a source file, used to invalidate its cache
+    struct SourceStamp {
+        uint64_t m_nSize;
+        int64_t m_nTime;
+    };
+
+    // A .mtl library read by the .obj ("mtllib" lines), with its stamp when the .obj was parsed
+    struct MaterialLibrary {
+        std::string m_sPath;
+        SourceStamp m_Stamp;
+    };
+
+    static std::vector<MaterialLibrary> findMaterialLibraries(const FilePath& filepath, const FilePath& mtlBasePath);
 
-    void generateNormals(unsigned int meshIndex);
+    // Appends the content of the .obj, textureNames receives 4 names per material (Ka, Kd, Ks, normal)
+    bool parseOBJ(const FilePath& filepath, const FilePath& mtlBasePath, std::vector<std::string>& textureNames);
+
+    // Reorders the triangles of the meshes [meshOffset, end) for the post-transform vertex cache, then
+    // the vertices [vertexOffset, end) in order of first use. Nothing is logged: simulateVertexCache
+    // gives the ACMR / ATVR (see MeshOptimizerBenchmark)
+    void optimizeMeshes(size_t vertexOffset, size_t meshOffset);
+
+    // Binary cache written next to the .obj after it has been parsed once (see Geometry.cpp). It is only used
+    // with the same mtlBasePath, and while the .obj and every .mtl it reads keep the same stamps.
+    // Both work on the data appended by the current loadOBJ call, starting at the given offsets.
+    bool loadCache(const FilePath& cachePath, const SourceStamp& stamp, const FilePath& mtlBasePath, std::vector<std::string>& textureNames);
+    void writeCache(const FilePath& cachePath, const SourceStamp& stamp, const FilePath& mtlBasePath,
+                    const std::vector<MaterialLibrary>& libraries, const std::vector<std::string>& textureNames,
+                    size_t vertexOffset, size_t indexOffset, size_t meshOffset, size_t materialOffset) const;
 
 public:
+    VertexStorage getVertexStorage() const {
+        return m_Storage;
+    }
+
+    // Converts the vertices already loaded; the following loadOBJ calls append in the new storage
+    void setVertexStorage(VertexStorage storage);
+
+    // nullptr in SoA storage, use the streams below instead
     const Vertex* getVertexBuffer() const {
-        return m_VertexBuffer.data();
+        return m_Storage == VertexStorage::AoS ? m_VertexBuffer.data() : nullptr;
     }
 
     size_t getVertexCount() const {
-        return m_VertexBuffer.size();
+        return m_Storage == VertexStorage::AoS ? m_VertexBuffer.size() : m_Positions.size();
     }
 
+    // Views on each attribute, contiguous in SoA storage (valid until the next load or conversion)
+    VertexStream<const glm::vec3> getPositions() const;
+    VertexStream<const glm::vec3> getNormals() const;
+    VertexStream<const glm::vec2> getTexCoords() const;
+
     const unsigned int* getIndexBuffer() const {
         return m_IndexBuffer.data();
     }
@@ -77,11 +162,37 @@ public:
         return m_MeshBuffer.size();
     }
 
+    const Material* getMaterialBuffer() const {
+        return m_Materials.data();
+    }
+
+    size_t getMaterialCount() const {
+        return m_Materials.size();
+    }
+
+    // Uses filepath + ".cache" instead of parsing the text file when it is up to date (same size and
+    // modification time as filepath and its .mtl files, same mtlBasePath), and writes it otherwise.
     bool loadOBJ(const FilePath& filepath, const FilePath& mtlBasePath, bool loadTextures = true);
 
     const BBox3f& getBoundingBox() const {
         return m_BBox;
     }
+
+    // Recomputes the bounding box from the positions only
+    void computeBoundingBox();
+
+    // Maximum angle (in radians) between two faces smoothed together when normals are generated: vertices
+    // are split along sharper edges. Used by loadOBJ for the meshes without normals, and by recomputeNormals
+    void setCreaseAngle(float creaseAngle) {
+        m_fCreaseAngle = creaseAngle;
+    }
+
+    float getCreaseAngle() const {
+        return m_fCreaseAngle;
+    }
+
+    // Replaces the normals of every mesh by smooth normals computed from the positions and indices
+    void recomputeNormals();
 };
 
 }
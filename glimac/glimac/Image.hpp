@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include "glm.hpp"
@@ -9,14 +10,32 @@
 
 namespace glimac {
 
+// Stockage des pixels d'une Image
+enum class PixelFormat {
+    RGBA8,  // 4 octets par pixel, tels que décodés (compact, à privilégier pour les textures)
+    RGBA32F // un glm::vec4 (16 octets) par pixel, composantes dans [0, 1]
+};
+
 class Image {
+public:
+    using ByteDeleter = void (*)(unsigned char*);
+
 private:
     unsigned int m_nWidth = 0u;
     unsigned int m_nHeight = 0u;
+    PixelFormat m_Format = PixelFormat::RGBA32F;
     std::unique_ptr<glm::vec4[]> m_Pixels;
+    std::unique_ptr<unsigned char[], ByteDeleter> m_Bytes;
 public:
     Image(unsigned int width, unsigned int height):
-        m_nWidth(width), m_nHeight(height), m_Pixels(new glm::vec4[width * height]) {
+        m_nWidth(width), m_nHeight(height), m_Pixels(new glm::vec4[width * height]), m_Bytes(nullptr, nullptr) {
+    }
+
+    Image(unsigned int width, unsigned int height, PixelFormat format);
+
+    // Adopte sans copie un buffer RGBA8 de width * height pixels, libéré par deleter
+    Image(unsigned int width, unsigned int height, unsigned char* bytes, ByteDeleter deleter):
+        m_nWidth(width), m_nHeight(height), m_Format(PixelFormat::RGBA8), m_Bytes(bytes, deleter) {
     }
 
     unsigned int getWidth() const {
@@ -27,6 +46,11 @@ public:
         return m_nHeight;
     }
 
+    PixelFormat getFormat() const {
+        return m_Format;
+    }
+
+    // Pixels flottants: nullptr si l'image est stockée en RGBA8
     const glm::vec4* getPixels() const {
         return m_Pixels.get();
     }
@@ -34,12 +58,32 @@ public:
     glm::vec4* getPixels() {
         return m_Pixels.get();
     }
+
+    // Pixels RGBA8: nullptr si l'image est stockée en flottants
+    const unsigned char* getBytes() const {
+        return m_Bytes.get();
+    }
+
+    unsigned char* getBytes() {
+        return m_Bytes.get();
+    }
+
+    // Taille en mémoire des pixels
+    size_t getByteSize() const {
+        return size_t(m_nWidth) * m_nHeight * (m_Format == PixelFormat::RGBA8 ? 4 : sizeof(glm::vec4));
+    }
+
+    // Convertit les pixels dans le format demandé (ne fait rien si c'est déjà le cas)
+    void convert(PixelFormat format);
 };
 
-std::unique_ptr<Image> loadImage(const FilePath& filepath);
+// Par défaut l'image est convertie en flottants, PixelFormat::RGBA8 garde le buffer décodé sans copie
+std::unique_ptr<Image> loadImage(const FilePath& filepath, PixelFormat format = PixelFormat::RGBA32F);
 
+// Cache d'images partagé, utilisable depuis plusieurs threads
 class ImageManager {
 private:
+    static std::mutex m_Mutex;
     static std::unordered_map<FilePath, std::unique_ptr<Image>> m_ImageMap;
 public:
     static const Image* loadImage(const FilePath& filepath);
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include "MeshBuffer.hpp"
+#include "glm.hpp"
+
+namespace glimac {
+
+// Attributs propres à chaque instance d'un maillage dessiné en une seule fois
+struct InstanceData {
+    glm::mat4 model;  // matrice monde de l'instance (sans la matrice de vue)
+    glm::mat3 normal; // transposée de l'inverse de la matrice monde
+    glm::vec3 color;
+
+    InstanceData() {}
+
+    InstanceData(const glm::mat4& m, const glm::vec3& c)
+        : model(m), normal(glm::transpose(glm::inverse(glm::mat3(m)))), color(c) {
+    }
+};
+
+// Matrice modèle d'un tronçon: le cylindre unitaire (axe z) est placé en Pstart, orienté et étiré jusqu'à Pend
+glm::mat4 segmentMatrix(glm::vec3 Pstart, glm::vec3 Pend);
+
+// Dessine un MeshBuffer plusieurs fois en un seul appel: le VAO réutilise le VBO / IBO du maillage
+// et y ajoute un buffer d'instances dont les attributs avancent d'un cran par instance
+class InstanceBuffer {
+public:
+    enum {
+        INSTANCE_ATTR_MODEL  = 3, // 4 emplacements (3 à 6)
+        INSTANCE_ATTR_NORMAL = 7, // 3 emplacements (7 à 9)
+        INSTANCE_ATTR_COLOR  = 10
+    };
+
+    // Le maillage doit rester en vie aussi longtemps que l'InstanceBuffer
+    explicit InstanceBuffer(const MeshBuffer& mesh);
+
+    ~InstanceBuffer();
+
+    InstanceBuffer(InstanceBuffer&& rvalue);
+
+    InstanceBuffer& operator =(InstanceBuffer&& rvalue);
+
+    // Remplace toutes les instances (un seul glBufferData)
+    void upload(const std::vector<InstanceData>& instances);
+
+    GLsizei getInstanceCount() const {
+        return m_nInstanceCount;
+    }
+
+    // Nombre total d'octets envoyés au GPU depuis la création
+    size_t getUploadedBytes() const {
+        return m_nUploadedBytes;
+    }
+
+    // Un seul appel glDraw*Instanced quel que soit le nombre d'instances
+    void draw() const;
+
+private:
+    InstanceBuffer(const InstanceBuffer&);
+    InstanceBuffer& operator =(const InstanceBuffer&);
+
+    void release();
+
+    const MeshBuffer* m_pMesh = nullptr;
+    GLuint m_nVAO = 0;
+    GLuint m_nInstanceVBO = 0;
+    GLsizei m_nVertexCount = 0;
+    GLsizei m_nIndexCount = 0;
+    GLsizei m_nInstanceCount = 0;
+    size_t m_nUploadedBytes = 0;
+};
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "glm.hpp"
+
+namespace glimac {
+
+// Répartition des lumières ponctuelles dans une grille de clusters (froxels) du repère de la vue:
+// tilesX x tilesY tuiles à l'écran, découpées en slices tranches de profondeur exponentielles entre
+// zNear et zFar. Chaque fragment n'évalue ensuite que les lumières de son cluster.
+// Les lumières sont des sphères d'influence (centre dans le repère de la vue, rayon): une lumière est
+// rangée dans tous les clusters que sa boîte englobante touche, ce qui est conservatif
+class LightClusters {
+public:
+    // Plage de la liste d'indices (getLightIndices) occupée par un cluster
+    struct Cluster {
+        uint32_t offset;
+        uint32_t count;
+    };
+
+    LightClusters(unsigned tilesX = 16, unsigned tilesY = 9, unsigned slices = 24);
+
+    // Projection perspective (glm::perspective ou glm::frustum) et ses plans proche / lointain
+    void setProjection(const glm::mat4& projMatrix, float zNear, float zFar);
+
+    // lights[i] = (centre dans le repère de la vue, rayon). Remplace le contenu de la grille
+    void build(const glm::vec4* lights, size_t count);
+
+    unsigned getTileCountX() const {
+        return m_nTilesX;
+    }
+
+    unsigned getTileCountY() const {
+        return m_nTilesY;
+    }
+
+    unsigned getSliceCount() const {
+        return m_nSlices;
+    }
+
+    size_t getClusterCount() const {
+        return m_Clusters.size();
+    }
+
+    // Indice de cluster: la tuile varie le plus vite, puis la ligne de tuiles, puis la tranche
+    size_t getClusterIndex(unsigned tileX, unsigned tileY, unsigned slice) const {
+        return tileX + m_nTilesX * (tileY + m_nTilesY * size_t(slice));
+    }
+
+    // Tranche contenant la profondeur (distance positive devant la caméra), bornée à [0, slices - 1].
+    // Le shader fait le même calcul avec getDepthScale: slice = log(depth) * scale.x + scale.y
+    unsigned getSlice(float depth) const;
+
+    glm::vec2 getDepthScale() const {
+        return glm::vec2(m_fSliceScale, m_fSliceBias);
+    }
+
+    const std::vector<Cluster>& getClusters() const {
+        return m_Clusters;
+    }
+
+    const std::vector<uint32_t>& getLightIndices() const {
+        return m_LightIndices;
+    }
+
+    // Lumières du cluster: count indices à partir de offset dans getLightIndices
+    const Cluster& getCluster(size_t clusterIndex) const {
+        return m_Clusters[clusterIndex];
+    }
+
+private:
+    // Clusters touchés par une lumière (bornes incluses); empty si elle est hors du frustum
+    struct ClusterRange {
+        uint16_t minX, maxX, minY, maxY, minSlice, maxSlice;
+        bool empty;
+    };
+
+    ClusterRange computeRange(const glm::vec4& light) const;
+
+    unsigned m_nTilesX;
+    unsigned m_nTilesY;
+    unsigned m_nSlices;
+
+    // x_ndc = m_Projection.x * x / profondeur - m_Projection.z (idem pour y)
+    glm::vec4 m_Projection = glm::vec4(1.f, 1.f, 0.f, 0.f);
+    float m_fNear = 0.1f;
+    float m_fFar = 100.f;
+    float m_fSliceScale = 0.f;
+    float m_fSliceBias = 0.f;
+
+    std::vector<Cluster> m_Clusters;
+    std::vector<uint32_t> m_LightIndices;
+    std::vector<ClusterRange> m_Ranges;
+};
+
+}
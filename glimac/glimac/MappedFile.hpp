@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace glimac {
+
+// Projection en lecture seule d'un fichier en mémoire (mmap / MapViewOfFile):
+// les pages sont lues par le système à la demande, sans copie dans un buffer
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    ~MappedFile();
+
+    // Renvoit false si le fichier ne peut pas être ouvert ou projeté. Un fichier vide
+    // s'ouvre sans erreur, data() vaut alors nullptr
+    bool open(const std::string& filepath);
+
+    void close();
+
+    const char* data() const {
+        return m_pData;
+    }
+
+    size_t size() const {
+        return m_nSize;
+    }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator =(const MappedFile&);
+
+    const char* m_pData = nullptr;
+    size_t m_nSize = 0;
+#ifdef _WIN32
+    void* m_hFile = nullptr;
+    void* m_hMapping = nullptr;
+#endif
+};
+
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Cylindre.hpp"
+#include "Geometry.hpp"
+#include "MeshLOD.hpp"
+#include "PackedVertex.hpp"
+#include "Sphere.hpp"
+#include "common.hpp"
+
+namespace glimac {
+
+// Représente un maillage résidant sur le GPU: son VBO, son IBO (optionnel) et son VAO
+// sont créés et remplis une seule fois à la construction, dessiner ne fait que binder le VAO
+class MeshBuffer {
+public:
+    enum {
+        VERTEX_ATTR_POSITION  = 0,
+        VERTEX_ATTR_NORMAL    = 1,
+        VERTEX_ATTR_TEXCOORDS = 2,
+        // Attributs constants (sans buffer) décrivant le décodage des positions, voir setDecodeAttributes
+        VERTEX_ATTR_POSITION_SCALE  = 11,
+        VERTEX_ATTR_POSITION_OFFSET = 12
+    };
+
+    // Envoie les données au GPU (si indexCount vaut 0, le maillage est dessiné avec glDrawArrays).
+    // En VertexFormat::Packed, les sommets sont compressés avant l'envoi (voir PackedVertex)
+    MeshBuffer(const ShapeVertex* vertices, GLsizei vertexCount, const unsigned int* indices = nullptr, GLsizei indexCount = 0,
+               VertexFormat format = VertexFormat::Float);
+
+    // Un VBO par attribut, remplis directement depuis les tableaux (stockage SoA de Geometry)
+    MeshBuffer(const glm::vec3* positions, const glm::vec3* normals, const glm::vec2* texCoords, GLsizei vertexCount,
+               const unsigned int* indices = nullptr, GLsizei indexCount = 0);
+
+    ~MeshBuffer();
+
+    MeshBuffer(MeshBuffer&& rvalue);
+
+    MeshBuffer& operator =(MeshBuffer&& rvalue);
+
+    GLuint getVAO() const {
+        return m_nVAO;
+    }
+
+    // VBO des positions quand les attributs sont dans des VBO séparés
+    GLuint getVBO() const {
+        return m_nVBO;
+    }
+
+    // 0 si les attributs sont entrelacés dans getVBO()
+    GLuint getNormalVBO() const {
+        return m_nNormalVBO;
+    }
+
+    GLuint getTexCoordsVBO() const {
+        return m_nTexCoordsVBO;
+    }
+
+    GLuint getIBO() const {
+        return m_nIBO;
+    }
+
+    GLsizei getVertexCount() const {
+        return m_nVertexCount;
+    }
+
+    GLsizei getIndexCount() const {
+        return m_nIndexCount;
+    }
+
+    // Nombre d'octets envoyés au GPU à la création
+    size_t getUploadedBytes() const {
+        return m_nUploadedBytes;
+    }
+
+    // Ce qu'aurait pesé le même maillage en VertexFormat::Float (égal à getUploadedBytes() hors Packed)
+    size_t getUnpackedBytes() const {
+        return m_nUploadedBytes + (m_Format == VertexFormat::Packed ? m_nVertexCount * (sizeof(ShapeVertex) - sizeof(PackedVertex)) : 0);
+    }
+
+    VertexFormat getVertexFormat() const {
+        return m_Format;
+    }
+
+    // Taille d'un sommet dans le VBO
+    size_t getVertexSize() const {
+        return m_Format == VertexFormat::Packed ? sizeof(PackedVertex) : sizeof(ShapeVertex);
+    }
+
+    GLsizei getTriangleCount() const {
+        return (m_nIndexCount > 0 ? m_nIndexCount : m_nVertexCount) / 3;
+    }
+
+    // Décrit les attributs de sommet dans le VAO actuellement bindé (VBO et IBO compris)
+    void setupVertexAttributes() const;
+
+    // Valeurs des attributs constants lus par le vertex shader pour décoder les positions et normales:
+    // (taille de la boîte englobante, 1) et son coin inférieur en Packed, (1, 1, 1, 0) et 0 en Float.
+    // Ce ne sont pas des états du VAO: à refaire avant chaque dessin
+    void setDecodeAttributes() const;
+
+    void draw() const;
+
+private:
+    MeshBuffer(const MeshBuffer&);
+    MeshBuffer& operator =(const MeshBuffer&);
+
+    void release();
+
+    void createVertexArray(const unsigned int* indices);
+
+    GLuint m_nVBO = 0;
+    GLuint m_nNormalVBO = 0;
+    GLuint m_nTexCoordsVBO = 0;
+    GLuint m_nIBO = 0;
+    GLuint m_nVAO = 0;
+    GLsizei m_nVertexCount = 0;
+    GLsizei m_nIndexCount = 0;
+    size_t m_nUploadedBytes = 0;
+    VertexFormat m_Format = VertexFormat::Float;
+    BBox3f m_Bounds; // boîte de quantification des positions en Packed
+};
+
+// Associe un nom à chaque maillage de la scène, chacun étant envoyé une seule fois au GPU au chargement.
+// Enregistrer deux fois le même nom lance std::invalid_argument
+class MeshRegistry {
+public:
+    const MeshBuffer& add(const std::string& name, const Sphere& sphere);
+
+    const MeshBuffer& add(const std::string& name, const Cylindre& cylindre);
+
+    const MeshBuffer& add(const std::string& name, const Geometry& geometry, VertexFormat format = VertexFormat::Float);
+
+    const MeshBuffer& add(const std::string& name, const std::vector<ShapeVertex>& vertices, const std::vector<unsigned int>& indices,
+                          VertexFormat format = VertexFormat::Float);
+
+    // Enregistre chaque niveau sous name#0, name#1... et la chaîne sous name (voir getLOD)
+    const MeshLOD& addLOD(const std::string& name, const std::vector<Sphere>& levels, std::vector<float> minScreenSizes = MeshLOD::getDefaultScreenSizes());
+
+    const MeshLOD& addLOD(const std::string& name, const std::vector<Cylindre>& levels, std::vector<float> minScreenSizes = MeshLOD::getDefaultScreenSizes());
+
+    // Renvoit nullptr si aucun maillage n'a été enregistré sous ce nom
+    const MeshBuffer* find(const std::string& name) const;
+
+    const MeshBuffer& get(const std::string& name) const;
+
+    const MeshLOD& getLOD(const std::string& name) const;
+
+    // Nombre total d'octets envoyés au GPU par le registre depuis sa création
+    size_t getUploadedBytes() const {
+        return m_nUploadedBytes;
+    }
+
+    // Même total si tous les maillages avaient été envoyés en VertexFormat::Float
+    size_t getUnpackedBytes() const {
+        return m_nUnpackedBytes;
+    }
+
+    size_t getMeshCount() const {
+        return m_MeshMap.size();
+    }
+
+    // Détruit les objets GL: doit être appelé tant que le contexte est encore valide
+    void clear();
+
+private:
+    const MeshBuffer& insert(const std::string& name, std::unique_ptr<MeshBuffer> mesh);
+
+    template<typename Shape>
+    const MeshLOD& insertLOD(const std::string& name, const std::vector<Shape>& levels, std::vector<float> minScreenSizes, float boundingRadius);
+
+    std::unordered_map<std::string, std::unique_ptr<MeshBuffer>> m_MeshMap;
+    std::unordered_map<std::string, std::unique_ptr<MeshLOD>> m_LODMap;
+    size_t m_nUploadedBytes = 0;
+    size_t m_nUnpackedBytes = 0;
+};
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "glm.hpp"
+
+namespace glimac {
+
+class MeshBuffer;
+
+// Niveaux de détail d'un même maillage, du plus fin (0) au plus grossier. Le niveau est choisi
+// d'après la taille à l'écran de la sphère englobante
+class MeshLOD {
+public:
+    // minScreenSizes[i]: diamètre à l'écran (en pixels) à partir duquel le niveau i est utilisé,
+    // par ordre décroissant; le dernier niveau est utilisé en dessous du dernier seuil
+    MeshLOD(std::vector<const MeshBuffer*> levels, std::vector<float> minScreenSizes, float boundingRadius);
+
+    size_t getLevelCount() const {
+        return m_Levels.size();
+    }
+
+    const MeshBuffer& getLevel(size_t level) const {
+        return *m_Levels[level];
+    }
+
+    // Rayon de la sphère englobante dans le repère local du maillage
+    float getBoundingRadius() const {
+        return m_fBoundingRadius;
+    }
+
+    size_t selectLevel(float screenSize) const;
+
+    const MeshBuffer& select(float screenSize) const {
+        return *m_Levels[selectLevel(screenSize)];
+    }
+
+    // Seuils par défaut pour 4 niveaux
+    static std::vector<float> getDefaultScreenSizes();
+
+private:
+    std::vector<const MeshBuffer*> m_Levels;
+    std::vector<float> m_MinScreenSizes;
+    float m_fBoundingRadius;
+};
+
+// Diamètre à l'écran (en pixels) d'une sphère de rayon radius dont le centre est à la distance
+// distance de la caméra (approximation valable loin des bords de l'écran)
+float computeScreenSize(float radius, float distance, const glm::mat4& projMatrix, float viewportHeight);
+
+// Même chose pour un objet de rayon englobant radius dans son repère local, centré sur l'origine
+// locale et dessiné avec la matrice MVMatrix (qui peut contenir une mise à l'échelle)
+float computeScreenSize(float radius, const glm::mat4& MVMatrix, const glm::mat4& projMatrix, float viewportHeight);
+
+}
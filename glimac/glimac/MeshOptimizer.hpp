@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace glimac {
+
+// Résultat de la simulation d'un cache de sommets post-transformation (FIFO)
+struct VertexCacheStats {
+    size_t misses = 0;    // sommets transformés par le GPU
+    size_t triangles = 0;
+    size_t vertices = 0;  // sommets distincts référencés
+
+    // Average Cache Miss Ratio: sommets transformés par triangle (entre 0.5 et 3, le plus bas le mieux)
+    float getACMR() const {
+        return triangles ? float(misses) / triangles : 0.f;
+    }
+
+    // Average Transform to Vertex Ratio: nombre de fois où chaque sommet est transformé (1 au mieux)
+    float getATVR() const {
+        return vertices ? float(misses) / vertices : 0.f;
+    }
+
+    VertexCacheStats& operator +=(const VertexCacheStats& other) {
+        misses += other.misses;
+        triangles += other.triangles;
+        vertices += other.vertices;
+        return *this;
+    }
+};
+
+// Taille de cache utilisée par défaut pour la simulation et l'optimisation
+const size_t DEFAULT_VERTEX_CACHE_SIZE = 16;
+
+// Rejoue la liste de triangles dans un cache FIFO de cacheSize sommets
+VertexCacheStats simulateVertexCache(const unsigned int* indices, size_t indexCount, size_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+// Réordonne les triangles (algorithme Tipsify de Sander, Nehab et Barczak) pour qu'un sommet soit
+// réutilisé tant qu'il est encore dans le cache. Les indices peuvent commencer à n'importe quelle valeur
+void optimizeVertexCache(unsigned int* indices, size_t indexCount, size_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+// Renumérote les sommets [firstVertex, firstVertex + vertexCount) dans l'ordre de leur première
+// utilisation par les indices (réécrits en place), les sommets inutilisés étant placés à la fin.
+// Renvoit la table ancienne position -> nouvelle position, relative à firstVertex
+std::vector<unsigned int> optimizeVertexFetch(unsigned int* indices, size_t indexCount, unsigned int firstVertex, size_t vertexCount);
+
+}
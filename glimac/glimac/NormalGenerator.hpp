@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Geometry.hpp"
+#include "ThreadPool.hpp"
+
+namespace glimac {
+
+// Sommet créé par generateSmoothNormals le long d'un pli: copie du sommet source avec sa propre normale
+struct NormalSplit {
+    unsigned int source;
+    glm::vec3 normal;
+};
+
+// Angle de pli qui désactive le découpage: toutes les faces d'un sommet sont lissées ensemble
+const float NO_CREASE_ANGLE = 3.14159265f;
+
+// Calcule des normales lissées pour les triangles indices[0, indexCount): chaque face contribue à ses trois
+// sommets en proportion de son aire et de l'angle du coin. Les indices doivent rester dans
+// [firstVertex, firstVertex + vertexCount), les sommets non référencés gardent leur normale.
+// Quand deux faces d'un même sommet forment un angle supérieur à creaseAngle (en radians), le sommet est
+// dupliqué: les copies sont numérotées à partir de positions.m_nCount dans l'ordre du vecteur renvoyé
+// (l'appelant doit les ajouter) et les indices sont réécrits en place.
+// Le calcul est réparti sur les threads de pool
+std::vector<NormalSplit> generateSmoothNormals(unsigned int* indices, size_t indexCount,
+                                               VertexStream<const glm::vec3> positions, VertexStream<glm::vec3> normals,
+                                               unsigned int firstVertex, size_t vertexCount,
+                                               float creaseAngle, ThreadPool& pool);
+
+}
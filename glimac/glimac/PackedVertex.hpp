@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "BBox.hpp"
+#include "common.hpp"
+
+namespace glimac {
+
+// Format des sommets envoyés au GPU
+enum class VertexFormat {
+    Float, // ShapeVertex: 32 octets
+    Packed // PackedVertex: 16 octets
+};
+
+// Sommet compressé:
+// - position quantifiée sur 16 bits par composante, relativement à la boîte englobante du maillage
+// - normale en projection octaédrique sur 2 x 16 bits signés normalisés
+// - coordonnées de texture en demi-flottants
+struct PackedVertex {
+    uint16_t position[3];
+    uint16_t padding;      // aligne la normale sur 4 octets
+    int16_t normal[2];
+    uint16_t texCoords[2];
+};
+
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must stay 16 bytes");
+
+// La position décodée vaut bounds.lower + q * bounds.size(), q étant la position quantifiée ramenée dans [0, 1]
+PackedVertex packVertex(const ShapeVertex& vertex, const BBox3f& bounds);
+
+ShapeVertex unpackVertex(const PackedVertex& vertex, const BBox3f& bounds);
+
+// Compresse un tableau de sommets, bounds reçoit leur boîte englobante
+std::vector<PackedVertex> packVertices(const ShapeVertex* vertices, size_t count, BBox3f& bounds);
+
+// Projection octaédrique d'une normale unitaire sur le carré [-1, 1]²
+glm::vec2 encodeOctahedral(const glm::vec3& normal);
+
+glm::vec3 decodeOctahedral(const glm::vec2& encoded);
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+namespace glimac {
+
+// Conversions de composantes de pixels entre octets et flottants, vectorisées (SSE2 / AVX2)
+// quand le processeur le permet. Le noyau est choisi une fois, à l'exécution, au premier appel
+// (setPixelConversionKernel peut l'imposer); les résultats sont identiques bit à bit à ceux des
+// versions scalaires.
+
+enum class PixelConversionKernel {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+// dst[i] = src[i] / 255 (multiplié par 1.f / 255)
+void convertU8ToF32(const unsigned char* src, float* dst, size_t count);
+
+// dst[i] = src[i] ramené dans [0, 1] puis arrondi au plus proche sur [0, 255] (NaN donne 0)
+void convertF32ToU8(const float* src, unsigned char* dst, size_t count);
+
+// Versions scalaires de référence
+void convertU8ToF32Scalar(const unsigned char* src, float* dst, size_t count);
+void convertF32ToU8Scalar(const float* src, unsigned char* dst, size_t count);
+
+// Nom du noyau utilisé: "avx2", "sse2" ou "scalar"
+const char* getPixelConversionKernel();
+
+bool isPixelConversionKernelSupported(PixelConversionKernel kernel);
+
+// Impose le noyau des conversions suivantes (tests, benchmarks). Renvoie false, sans rien changer,
+// si le processeur ou la compilation ne le permettent pas. À ne pas appeler pendant une conversion
+bool setPixelConversionKernel(PixelConversionKernel kernel);
+
+}
@@ -4,6 +4,7 @@
 #include <GLFW/glfw3.h>
 #include "Shader.hpp"
 #include "FilePath.hpp"
+#include "GLState.hpp"
 
 namespace glimac {
 
@@ -39,7 +40,7 @@ public:
 	const std::string getInfoLog() const;
 
 	void use() const {
-		glUseProgram(m_nGLId);
+		GLState::useProgram(m_nGLId);
 	}
 
 private:
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace glimac {
+
+// Une soumission de dessin: la clé de tri et une donnée libre (en général l'entité à dessiner)
+struct RenderCommand {
+    uint64_t key;
+    uint32_t payload;
+};
+
+// File de commandes de dessin triée par clé avant exécution. Les champs de la clé vont du plus coûteux
+// à changer au moins coûteux (passe, matériau, texture, maillage) puis à la profondeur: les commandes
+// consécutives partagent ainsi le plus d'état possible et l'exécution peut sauter les changements redondants
+class RenderQueue {
+public:
+    // Bits de chaque champ, du poids fort au poids faible
+    static const unsigned PASS_BITS = 4;
+    static const unsigned MATERIAL_BITS = 12;
+    static const unsigned TEXTURE_BITS = 12;
+    static const unsigned MESH_BITS = 12;
+    static const unsigned DEPTH_BITS = 24;
+
+    // Les identifiants sont tronqués à leur nombre de bits. depth est ramenée dans [0, 1] (0 = la plus
+    // proche, dessinée en premier): passer 1 - depth pour une passe triée de l'arrière vers l'avant
+    static uint64_t makeKey(uint32_t pass, uint32_t material, uint32_t texture, uint32_t mesh, float depth);
+
+    static uint32_t getPass(uint64_t key) {
+        return uint32_t(key >> (MATERIAL_BITS + TEXTURE_BITS + MESH_BITS + DEPTH_BITS));
+    }
+
+    static uint32_t getMaterial(uint64_t key) {
+        return uint32_t(key >> (TEXTURE_BITS + MESH_BITS + DEPTH_BITS)) & ((1u << MATERIAL_BITS) - 1);
+    }
+
+    static uint32_t getTexture(uint64_t key) {
+        return uint32_t(key >> (MESH_BITS + DEPTH_BITS)) & ((1u << TEXTURE_BITS) - 1);
+    }
+
+    static uint32_t getMesh(uint64_t key) {
+        return uint32_t(key >> DEPTH_BITS) & ((1u << MESH_BITS) - 1);
+    }
+
+    void reserve(size_t commandCount);
+
+    // Vide la file (la mémoire est gardée pour la frame suivante)
+    void clear() {
+        m_Commands.clear();
+    }
+
+    void submit(uint64_t key, uint32_t payload) {
+        m_Commands.push_back(RenderCommand{ key, payload });
+    }
+
+    // Tri stable par clé: tri par base (LSD, 16 bits par passe) pour les grandes files, les passes dont le
+    // chiffre est le même pour toutes les commandes étant sautées. Tri par comparaison pour les petites
+    void sort();
+
+    const std::vector<RenderCommand>& getCommands() const {
+        return m_Commands;
+    }
+
+    size_t size() const {
+        return m_Commands.size();
+    }
+
+private:
+    std::vector<RenderCommand> m_Commands;
+    std::vector<RenderCommand> m_Scratch;
+    std::vector<uint32_t> m_Histograms;
+};
+
+}
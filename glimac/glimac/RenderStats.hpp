@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+
+namespace glimac {
+
+// Compteurs de la frame en cours, alimentés par les draw() de MeshBuffer et InstanceBuffer,
+// par GLState pour les changements d'état et par les buffers et textures pour les envois au GPU
+class RenderStats {
+public:
+    enum StateChange {
+        PROGRAM_CHANGE,
+        VERTEX_ARRAY_CHANGE,
+        TEXTURE_CHANGE,
+        MATERIAL_CHANGE, // envoi des uniformes d'un matériau
+        STATE_CHANGE_TYPES
+    };
+
+private:
+    static size_t m_nDrawCalls;
+    static size_t m_nTriangles;
+    static size_t m_nVisibleObjects;
+    static size_t m_nCulledObjects;
+    static size_t m_nUploadedBytes;
+    static size_t m_StateChanges[STATE_CHANGE_TYPES];
+public:
+    // Remet les compteurs à zéro: à appeler au début de chaque frame
+    static void beginFrame();
+
+    static void addDraw(size_t triangleCount);
+
+    // Résultat d'un test de visibilité (frustum culling) sur un ensemble d'objets
+    static void addCulling(size_t visibleCount, size_t culledCount);
+
+    // Octets envoyés au GPU (glBufferData, glTexImage2D...)
+    static void addUpload(size_t byteCount) {
+        m_nUploadedBytes += byteCount;
+    }
+
+    // Un changement d'état effectivement envoyé au driver (les binds redondants ne sont pas comptés)
+    static void addStateChange(StateChange change) {
+        ++m_StateChanges[change];
+    }
+
+    static size_t getDrawCallCount() {
+        return m_nDrawCalls;
+    }
+
+    // Nombre de triangles envoyés au GPU depuis beginFrame (instances comprises)
+    static size_t getTriangleCount() {
+        return m_nTriangles;
+    }
+
+    static size_t getVisibleObjectCount() {
+        return m_nVisibleObjects;
+    }
+
+    static size_t getCulledObjectCount() {
+        return m_nCulledObjects;
+    }
+
+    // Nombre d'octets envoyés au GPU depuis beginFrame
+    static size_t getUploadedByteCount() {
+        return m_nUploadedBytes;
+    }
+
+    static size_t getStateChangeCount(StateChange change) {
+        return m_StateChanges[change];
+    }
+
+    // Tous types confondus
+    static size_t getStateChangeCount();
+};
+
+}
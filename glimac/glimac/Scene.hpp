@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BBox.hpp"
+#include "Frustum.hpp"
+#include "glm.hpp"
+
+namespace glimac {
+
+// Une entité n'est qu'un indice dans les tableaux de composants de sa scène
+typedef uint32_t Entity;
+
+const Entity NO_ENTITY = 0xffffffffu;
+
+// Valeur du composant maillage d'une entité qui n'est pas dessinée (pivot, groupe...)
+const uint32_t NO_MESH = 0xffffffffu;
+
+// Graphe de scène orienté données: chaque composant (parent, matrices locale et monde, maillage, matériau,
+// boîtes englobantes) est un tableau contigu indexé par l'entité. Un parent étant toujours créé avant ses
+// enfants, les matrices monde sont calculées en un seul parcours linéaire, sans récursion ni pointeur.
+// Les identifiants de maillage et de matériau sont choisis par l'application
+class Scene {
+public:
+    // parent doit déjà exister (ou valoir NO_ENTITY): la hiérarchie ne peut pas être modifiée ensuite
+    Entity create(Entity parent = NO_ENTITY, const glm::mat4& localMatrix = glm::mat4(1.f));
+
+    void reserve(size_t entityCount);
+
+    // Détruit toutes les entités
+    void clear();
+
+    size_t size() const {
+        return m_Parents.size();
+    }
+
+    Entity getParent(Entity entity) const {
+        return m_Parents[entity];
+    }
+
+    void setLocalMatrix(Entity entity, const glm::mat4& matrix) {
+        m_LocalMatrices[entity] = matrix;
+    }
+
+    const glm::mat4& getLocalMatrix(Entity entity) const {
+        return m_LocalMatrices[entity];
+    }
+
+    // Valide après updateWorldMatrices
+    const glm::mat4& getWorldMatrix(Entity entity) const {
+        return m_WorldMatrices[entity];
+    }
+
+    void setMesh(Entity entity, uint32_t mesh);
+
+    uint32_t getMesh(Entity entity) const {
+        return m_Meshes[entity];
+    }
+
+    void setMaterial(Entity entity, uint32_t material) {
+        m_Materials[entity] = material;
+    }
+
+    uint32_t getMaterial(Entity entity) const {
+        return m_Materials[entity];
+    }
+
+    // Boîte dans le repère de l'entité. Une entité sans boîte (vide, par défaut) n'est jamais éliminée par cull
+    void setLocalBounds(Entity entity, const BBox3f& bounds) {
+        m_LocalBounds[entity] = bounds;
+    }
+
+    // Valide après updateWorldMatrices
+    const BBox3f& getWorldBounds(Entity entity) const {
+        return m_WorldBounds[entity];
+    }
+
+    // Tableaux complets, indexés par l'entité
+    const glm::mat4* getWorldMatrices() const {
+        return m_WorldMatrices.data();
+    }
+
+    const BBox3f* getWorldBounds() const {
+        return m_WorldBounds.data();
+    }
+
+    // Nombre d'entités ayant un maillage
+    size_t getDrawableCount() const {
+        return m_nDrawableCount;
+    }
+
+    // Matrices monde (parent * locale) et boîtes englobantes monde de toutes les entités, dans l'ordre de création
+    void updateWorldMatrices();
+
+    // visible[e] = 1 si l'entité a un maillage et que sa boîte monde touche le frustum. Renvoit le nombre
+    // d'entités visibles
+    size_t cull(const Frustum& frustum, std::vector<unsigned char>& visible) const;
+
+private:
+    std::vector<Entity> m_Parents;
+    std::vector<glm::mat4> m_LocalMatrices;
+    std::vector<glm::mat4> m_WorldMatrices;
+    std::vector<uint32_t> m_Meshes;
+    std::vector<uint32_t> m_Materials;
+    std::vector<BBox3f> m_LocalBounds;
+    std::vector<BBox3f> m_WorldBounds;
+    size_t m_nDrawableCount = 0;
+};
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+#include "InstanceBuffer.hpp"
+#include "glm.hpp"
+
+namespace glimac {
+
+// Table des tronçons d'une ligne fermée de points (le dernier point rejoint le premier): matrice modèle
+// et couleur de chaque tronçon, prêtes pour un InstanceBuffer. La table n'est recalculée que si le numéro
+// de version des points a changé depuis le dernier appel
+class SegmentCache {
+public:
+    // version: incrémentée par l'appelant à chaque modification des points ou des couleurs
+    const std::vector<InstanceData>& get(const std::vector<glm::vec3>& points, const std::vector<glm::vec3>& colors, unsigned int version);
+
+    // Recalcule la table quelle que soit la version
+    void rebuild(const std::vector<glm::vec3>& points, const std::vector<glm::vec3>& colors);
+
+    unsigned int getVersion() const {
+        return m_nVersion;
+    }
+
+private:
+    std::vector<InstanceData> m_Segments;
+    unsigned int m_nVersion = 0;
+};
+
+}
@@ -15,10 +15,18 @@ class Sphere {
 public:
     // Constructeur: alloue le tableau de données et construit les attributs des vertex
     Sphere(GLfloat radius, GLsizei discLat, GLsizei discLong):
-        m_nVertexCount(0) {
+        m_nVertexCount(0), m_fRadius(radius) {
         build(radius, discLat, discLong); // Construction (voir le .cpp)
     }
 
+    // Niveaux de détail: le premier est discrétisé en (discLat, discLong), chaque niveau suivant
+    // divise la discrétisation par deux
+    static std::vector<Sphere> createLODChain(GLfloat radius, GLsizei discLat, GLsizei discLong, unsigned int levelCount = 4);
+
+    GLfloat getRadius() const {
+        return m_fRadius;
+    }
+
     // Renvoit le pointeur vers les données
     const ShapeVertex* getDataPointer() const {
         return &m_Vertices[0];
@@ -29,9 +37,30 @@ public:
         return m_nVertexCount;
     }
 
+    // Version indexée: chaque sommet n'apparaît qu'une fois, les triangles sont décrits par le tableau d'index
+    // (le triangle k est formé des mêmes sommets que les vertex 3k, 3k + 1 et 3k + 2 de getDataPointer())
+    const ShapeVertex* getIndexedDataPointer() const {
+        return m_IndexedVertices.data();
+    }
+
+    GLsizei getIndexedVertexCount() const {
+        return m_IndexedVertices.size();
+    }
+
+    const unsigned int* getIndexPointer() const {
+        return m_Indices.data();
+    }
+
+    GLsizei getIndexCount() const {
+        return m_Indices.size();
+    }
+
 private:
     std::vector<ShapeVertex> m_Vertices;
     GLsizei m_nVertexCount; // Nombre de sommets
+    std::vector<ShapeVertex> m_IndexedVertices; // Sommets uniques
+    std::vector<unsigned int> m_Indices;
+    GLfloat m_fRadius;
 };
     
 }
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+#include <unordered_map>
+#include "Image.hpp"
+
+namespace glimac {
+
+// Associe à chaque image sa texture GL: la texture est créée et remplie au premier bind,
+// les suivants ne font que la binder. L'image doit rester en vie tant que la texture est utilisée.
+class TextureManager {
+private:
+    static std::unordered_map<const Image*, GLuint> m_TextureMap;
+public:
+    static GLuint getTexture(const Image* image);
+
+    // Binde la texture de l'image sur l'unité de texture donnée (rien n'est envoyé si elle y est déjà)
+    static void bind(const Image* image, GLuint unit);
+
+    // Nombre de textures GL actuellement vivantes
+    static size_t getTextureCount();
+
+    // Détruit toutes les textures: doit être appelé tant que le contexte est encore valide
+    static void clear();
+};
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace glimac {
+
+// Ensemble de threads de travail exécutant des tâches dans leur ordre de soumission
+class ThreadPool {
+public:
+    // 0 thread = autant que de coeurs disponibles
+    explicit ThreadPool(unsigned int threadCount = 0);
+
+    // Termine les tâches déjà soumises puis attend les threads
+    ~ThreadPool();
+
+    unsigned int getThreadCount() const {
+        return m_Threads.size();
+    }
+
+    // Soumet une tâche, son résultat (ou son exception) est récupéré par le future
+    template<typename Function>
+    std::future<decltype(std::declval<Function&>()())> submit(Function&& function) {
+        typedef decltype(std::declval<Function&>()()) Result;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+        std::future<Result> result = task->get_future();
+        enqueue([task]() { (*task)(); });
+        return result;
+    }
+
+    // Pool partagé par glimac, créé au premier appel
+    static ThreadPool& getDefault();
+
+private:
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator =(const ThreadPool&);
+
+    void enqueue(std::function<void()> task);
+
+    void work();
+
+    std::vector<std::thread> m_Threads;
+    std::queue<std::function<void()>> m_Tasks;
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    bool m_bStopping = false;
+};
+
+}
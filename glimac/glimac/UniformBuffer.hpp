@@ -0,0 +1,59 @@
+#pragma once
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+#include <cstddef>
+
+namespace glimac {
+
+// Buffer de blocs d'uniformes (UBO) attaché à un point de liaison: tous les programmes dont le bloc est
+// relié au même point (bindBlock) lisent ses données, envoyées en un seul appel quel que soit leur nombre.
+// Les structures envoyées doivent suivre la disposition std140 du bloc GLSL (vec3 alignés sur 16 octets...)
+class UniformBuffer {
+public:
+    UniformBuffer(size_t size, GLuint bindingPoint);
+
+    ~UniformBuffer();
+
+    UniformBuffer(UniformBuffer&& rvalue);
+
+    UniformBuffer& operator =(UniformBuffer&& rvalue);
+
+    // Relie le bloc blockName du programme au point de liaison (GLSL ES 3.0 n'a pas layout(binding)).
+    // Renvoit false si le programme n'a pas de bloc de ce nom
+    static bool bindBlock(GLuint program, const char* blockName, GLuint bindingPoint);
+
+    // Remplace size octets à partir de offset (un seul glBufferSubData)
+    void update(const void* data, size_t size, size_t offset = 0);
+
+    GLuint getGLId() const {
+        return m_nUBO;
+    }
+
+    size_t getSize() const {
+        return m_nSize;
+    }
+
+    GLuint getBindingPoint() const {
+        return m_nBindingPoint;
+    }
+
+    // Nombre total d'octets envoyés au GPU depuis la création
+    size_t getUploadedBytes() const {
+        return m_nUploadedBytes;
+    }
+
+private:
+    UniformBuffer(const UniformBuffer&);
+    UniformBuffer& operator =(const UniformBuffer&);
+
+    void release();
+
+    GLuint m_nUBO = 0;
+    size_t m_nSize = 0;
+    GLuint m_nBindingPoint = 0;
+    size_t m_nUploadedBytes = 0;
+};
+
+}
@@ -0,0 +1,47 @@
+#include "glimac/Arena.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace glimac {
+
+Arena::Arena(size_t blockSize): m_nBlockSize(blockSize) {
+}
+
+Arena::~Arena() {
+    clear();
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    if (!m_Blocks.empty()) {
+        Block& block = m_Blocks.back();
+        uintptr_t address = reinterpret_cast<uintptr_t>(block.data.get()) + m_nUsed;
+        size_t padding = (alignment - address % alignment) % alignment;
+        if (m_nUsed + padding + size <= block.size) {
+            m_nUsed += padding + size;
+            m_nAllocatedBytes += size;
+            return block.data.get() + m_nUsed - size;
+        }
+    }
+    // Nouveau bloc, agrandi pour les objets plus gros qu'un bloc (new[] aligne pour tout type standard)
+    size_t blockSize = std::max(m_nBlockSize, size + alignment);
+    m_Blocks.push_back(Block{ std::unique_ptr<char[]>(new char[blockSize]), blockSize });
+    uintptr_t address = reinterpret_cast<uintptr_t>(m_Blocks.back().data.get());
+    size_t padding = (alignment - address % alignment) % alignment;
+    m_nUsed = padding + size;
+    m_nAllocatedBytes += size;
+    return m_Blocks.back().data.get() + padding;
+}
+
+void Arena::clear() {
+    for (auto it = m_Destructors.rbegin(); it != m_Destructors.rend(); ++it) {
+        (*it).destroy((*it).object);
+    }
+    m_Destructors.clear();
+    if (m_Blocks.size() > 1) {
+        m_Blocks.erase(m_Blocks.begin() + 1, m_Blocks.end());
+    }
+    m_nUsed = 0;
+    m_nAllocatedBytes = 0;
+}
+
+}
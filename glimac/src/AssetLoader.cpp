@@ -0,0 +1,17 @@
+#include "glimac/AssetLoader.hpp"
+
+namespace glimac {
+
+std::future<std::unique_ptr<Image>> AssetLoader::loadImage(const FilePath& filepath, PixelFormat format) {
+    return m_Pool.submit([filepath, format]() {
+        return glimac::loadImage(filepath, format);
+    });
+}
+
+std::future<const Image*> AssetLoader::loadManagedImage(const FilePath& filepath) {
+    return m_Pool.submit([filepath]() {
+        return ImageManager::loadImage(filepath);
+    });
+}
+
+}
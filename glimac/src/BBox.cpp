@@ -0,0 +1,136 @@
+#include "glimac/BBox.hpp"
+#include "glimac/ThreadPool.hpp"
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define GLIMAC_BBOX_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace glimac {
+
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 must be three packed floats");
+
+namespace {
+
+/*! below this, starting a task costs more than the reduction itself */
+const size_t MIN_POINTS_PER_TASK = 1 << 16;
+
+const glm::vec3& pointAt(const glm::vec3* points, size_t stride, size_t i) {
+    return *reinterpret_cast<const glm::vec3*>(reinterpret_cast<const char*>(points) + i * stride);
+}
+
+#ifdef GLIMAC_BBOX_SSE
+
+BBox3f toBBox(const float lower[4], const float upper[4]) {
+    return BBox3f(glm::vec3(lower[0], lower[1], lower[2]), glm::vec3(upper[0], upper[1], upper[2]));
+}
+
+/*! packed points: 4 points are 3 registers x0y0z0x1 | y1z1x2y2 | z2x3y3z3, reduced separately then
+ *  gathered per axis at the end */
+BBox3f fromPackedPoints(const glm::vec3* points, size_t count) {
+    const float* p = reinterpret_cast<const float*>(points);
+    __m128 lo0 = _mm_set1_ps(std::numeric_limits<float>::infinity()), lo1 = lo0, lo2 = lo0;
+    __m128 hi0 = _mm_set1_ps(-std::numeric_limits<float>::infinity()), hi1 = hi0, hi2 = hi0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, p += 12) {
+        __m128 a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4), c = _mm_loadu_ps(p + 8);
+        lo0 = _mm_min_ps(lo0, a); hi0 = _mm_max_ps(hi0, a);
+        lo1 = _mm_min_ps(lo1, b); hi1 = _mm_max_ps(hi1, b);
+        lo2 = _mm_min_ps(lo2, c); hi2 = _mm_max_ps(hi2, c);
+    }
+    float l0[4], l1[4], l2[4], h0[4], h1[4], h2[4];
+    _mm_storeu_ps(l0, lo0); _mm_storeu_ps(l1, lo1); _mm_storeu_ps(l2, lo2);
+    _mm_storeu_ps(h0, hi0); _mm_storeu_ps(h1, hi1); _mm_storeu_ps(h2, hi2);
+    float lower[4] = {
+        std::min(std::min(l0[0], l0[3]), std::min(l1[2], l2[1])),
+        std::min(std::min(l0[1], l1[0]), std::min(l1[3], l2[2])),
+        std::min(std::min(l0[2], l1[1]), std::min(l2[0], l2[3])), 0.f
+    };
+    float upper[4] = {
+        std::max(std::max(h0[0], h0[3]), std::max(h1[2], h2[1])),
+        std::max(std::max(h0[1], h1[0]), std::max(h1[3], h2[2])),
+        std::max(std::max(h0[2], h1[1]), std::max(h2[0], h2[3])), 0.f
+    };
+    BBox3f box = toBBox(lower, upper);
+    for (; i < count; ++i) {
+        box.grow(points[i]);
+    }
+    return box;
+}
+
+/*! strided points: one unaligned load per point. The 4th float read belongs to the next point (or to the
+ *  rest of the element), so every point but the last can be loaded this way; that 4th lane is ignored */
+BBox3f fromStridedPoints(const glm::vec3* points, size_t count, size_t stride) {
+    const char* p = reinterpret_cast<const char*>(points);
+    __m128 lo0 = _mm_set1_ps(std::numeric_limits<float>::infinity()), lo1 = lo0;
+    __m128 hi0 = _mm_set1_ps(-std::numeric_limits<float>::infinity()), hi1 = hi0;
+    size_t i = 0;
+    for (; i + 2 < count; i += 2, p += 2 * stride) {
+        __m128 a = _mm_loadu_ps(reinterpret_cast<const float*>(p));
+        __m128 b = _mm_loadu_ps(reinterpret_cast<const float*>(p + stride));
+        lo0 = _mm_min_ps(lo0, a); hi0 = _mm_max_ps(hi0, a);
+        lo1 = _mm_min_ps(lo1, b); hi1 = _mm_max_ps(hi1, b);
+    }
+    float lower[4], upper[4];
+    _mm_storeu_ps(lower, _mm_min_ps(lo0, lo1));
+    _mm_storeu_ps(upper, _mm_max_ps(hi0, hi1));
+    BBox3f box = toBBox(lower, upper);
+    for (; i < count; ++i) {
+        box.grow(pointAt(points, stride, i));
+    }
+    return box;
+}
+
+#endif
+
+BBox3f reduce(const glm::vec3* points, size_t count, size_t stride) {
+#ifdef GLIMAC_BBOX_SSE
+    if (stride == sizeof(glm::vec3)) {
+        return fromPackedPoints(points, count);
+    }
+    if (stride > sizeof(glm::vec3)) {
+        return fromStridedPoints(points, count, stride);
+    }
+#endif
+    BBox3f box = BBox3f::emptyBox();
+    for (size_t i = 0; i < count; ++i) {
+        box.grow(pointAt(points, stride, i));
+    }
+    return box;
+}
+
+}
+
+BBox3f BBox3f::emptyBox() {
+    return BBox3f(glm::vec3(std::numeric_limits<float>::infinity()), glm::vec3(-std::numeric_limits<float>::infinity()));
+}
+
+BBox3f BBox3f::fromPoints(const glm::vec3* points, size_t count, size_t stride) {
+    return reduce(points, count, stride);
+}
+
+BBox3f BBox3f::fromPoints(const glm::vec3* points, size_t count, size_t stride, ThreadPool& pool) {
+    size_t taskCount = std::max<size_t>(1, std::min<size_t>(pool.getThreadCount(), count / MIN_POINTS_PER_TASK));
+    if (taskCount == 1) {
+        return reduce(points, count, stride);
+    }
+    std::vector<std::future<BBox3f>> tasks;
+    tasks.reserve(taskCount);
+    for (size_t task = 0; task < taskCount; ++task) {
+        size_t begin = count * task / taskCount;
+        size_t end = count * (task + 1) / taskCount;
+        const glm::vec3* first = &pointAt(points, stride, begin);
+        tasks.push_back(pool.submit([first, begin, end, stride]() { return reduce(first, end - begin, stride); }));
+    }
+    BBox3f box = emptyBox();
+    for (auto& task: tasks) {
+        box.grow(task.get());
+    }
+    return box;
+}
+
+}
@@ -0,0 +1,273 @@
+#include "glimac/BVH.hpp"
+#include <algorithm>
+
+namespace glimac {
+
+namespace {
+
+// Nombre d'intervalles de centres testés par axe pour le découpage SAH
+const size_t BIN_COUNT = 16;
+
+// Au-delà, une feuille est découpée même si le SAH la juge moins coûteuse
+const uint32_t MAX_LEAF_SIZE = 8;
+
+// Coût d'un noeud traversé relativement au test d'une primitive
+const float TRAVERSAL_COST = 1.f;
+
+// Passé cette profondeur, les noeuds sont coupés à la médiane: l'arbre ne peut plus dépasser MAX_DEPTH
+const size_t MEDIAN_SPLIT_DEPTH = BVH::MAX_DEPTH - 33;
+
+float halfArea(const BBox3f& box) {
+    glm::vec3 d = glm::max(box.size(), glm::vec3(0.f));
+    return d.x * d.y + d.y * d.z + d.z * d.x;
+}
+
+int largestAxis(const glm::vec3& size) {
+    return size.x >= size.y && size.x >= size.z ? 0 : (size.y >= size.z ? 1 : 2);
+}
+
+}
+
+bool intersectTriangle(const Ray& ray, const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, float& t) {
+    glm::vec3 e1 = p1 - p0;
+    glm::vec3 e2 = p2 - p0;
+    glm::vec3 p = glm::cross(ray.direction, e2);
+    float det = glm::dot(e1, p);
+    if (det == 0.f) {
+        return false;
+    }
+    float invDet = 1.f / det;
+    glm::vec3 s = ray.origin - p0;
+    float u = glm::dot(s, p) * invDet;
+    if (u < 0.f || u > 1.f) {
+        return false;
+    }
+    glm::vec3 q = glm::cross(s, e1);
+    float v = glm::dot(ray.direction, q) * invDet;
+    if (v < 0.f || u + v > 1.f) {
+        return false;
+    }
+    t = glm::dot(e2, q) * invDet;
+    return t >= ray.tMin && t <= ray.tMax;
+}
+
+BVH::BVH(const std::vector<BBox3f>& boxes) {
+    std::vector<BuildPrimitive> primitives(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        primitives[i].bounds = boxes[i];
+        primitives[i].centroid = center(boxes[i]);
+        primitives[i].index = i;
+    }
+    build(primitives);
+}
+
+BVH BVH::fromTriangles(const glm::vec3* positions, size_t stride, const unsigned int* indices, size_t triangleCount) {
+    auto position = [positions, stride](unsigned int i) -> const glm::vec3& {
+        return *reinterpret_cast<const glm::vec3*>(reinterpret_cast<const char*>(positions) + i * stride);
+    };
+    std::vector<BuildPrimitive> primitives(triangleCount);
+    for (size_t i = 0; i < triangleCount; ++i) {
+        BBox3f box(position(indices[3 * i]));
+        box.grow(position(indices[3 * i + 1]));
+        box.grow(position(indices[3 * i + 2]));
+        primitives[i].bounds = box;
+        primitives[i].centroid = center(box);
+        primitives[i].index = i;
+    }
+    BVH bvh;
+    bvh.build(primitives);
+    return bvh;
+}
+
+void BVH::build(std::vector<BuildPrimitive>& primitives) {
+    m_Nodes.clear();
+    m_Primitives.clear();
+    if (primitives.empty()) {
+        return;
+    }
+    // Un arbre binaire dont les feuilles ont au moins une primitive a moins de 2n noeuds
+    m_Nodes.reserve(2 * primitives.size());
+    buildNode(primitives, 0, primitives.size(), 0);
+    m_Nodes.shrink_to_fit();
+
+    // Les feuilles désignent des intervalles de primitives, réordonnées pendant la construction
+    m_Primitives.resize(primitives.size());
+    for (size_t i = 0; i < primitives.size(); ++i) {
+        m_Primitives[i] = primitives[i].index;
+    }
+}
+
+uint32_t BVH::buildNode(std::vector<BuildPrimitive>& primitives, uint32_t begin, uint32_t end, size_t depth) {
+    const uint32_t nodeIndex = m_Nodes.size();
+    m_Nodes.emplace_back();
+
+    BBox3f bounds = BBox3f::emptyBox();
+    BBox3f centroids = BBox3f::emptyBox();
+    for (auto i = begin; i < end; ++i) {
+        bounds.grow(primitives[i].bounds);
+        centroids.grow(primitives[i].centroid);
+    }
+    m_Nodes[nodeIndex].bounds = bounds;
+
+    const uint32_t count = end - begin;
+    const glm::vec3 extent = centroids.size();
+    const int axis = largestAxis(extent);
+
+    auto makeLeaf = [&]() {
+        m_Nodes[nodeIndex].offset = begin;
+        m_Nodes[nodeIndex].count = count;
+        return nodeIndex;
+    };
+    if (count == 1 || (extent[axis] <= 0.f && count <= MAX_LEAF_SIZE)) {
+        return makeLeaf();
+    }
+
+    uint32_t middle = begin;
+    if (extent[axis] > 0.f && depth < MEDIAN_SPLIT_DEPTH) {
+        // Répartition des centres dans BIN_COUNT intervalles réguliers sur l'axe le plus long
+        struct Bin {
+            BBox3f bounds = BBox3f::emptyBox();
+            uint32_t count = 0;
+        } bins[BIN_COUNT];
+        const float scale = BIN_COUNT / extent[axis] * 0.99999f;
+        auto binOf = [&](const BuildPrimitive& primitive) {
+            return std::min<size_t>(BIN_COUNT - 1, size_t((primitive.centroid[axis] - centroids.lower[axis]) * scale));
+        };
+        for (auto i = begin; i < end; ++i) {
+            auto& bin = bins[binOf(primitives[i])];
+            bin.bounds.grow(primitives[i].bounds);
+            ++bin.count;
+        }
+
+        // Coût SAH de chaque coupure entre deux intervalles: aires des deux côtés balayées dans les deux sens
+        float rightCosts[BIN_COUNT];
+        BBox3f side = BBox3f::emptyBox();
+        uint32_t sideCount = 0;
+        for (size_t i = BIN_COUNT - 1; i > 0; --i) {
+            side.grow(bins[i].bounds);
+            sideCount += bins[i].count;
+            rightCosts[i] = sideCount ? halfArea(side) * sideCount : 0.f;
+        }
+        side = BBox3f::emptyBox();
+        sideCount = 0;
+        size_t bestSplit = 0;
+        float bestCost = std::numeric_limits<float>::infinity();
+        for (size_t i = 0; i + 1 < BIN_COUNT; ++i) {
+            side.grow(bins[i].bounds);
+            sideCount += bins[i].count;
+            float cost = (sideCount ? halfArea(side) * sideCount : 0.f) + rightCosts[i + 1];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestSplit = i + 1;
+            }
+        }
+
+        const float area = halfArea(bounds);
+        const float splitCost = TRAVERSAL_COST + (area > 0.f ? bestCost / area : 0.f);
+        if (count <= MAX_LEAF_SIZE && splitCost >= float(count)) {
+            return makeLeaf();
+        }
+        middle = std::partition(primitives.begin() + begin, primitives.begin() + end,
+                                [&](const BuildPrimitive& primitive) { return binOf(primitive) < bestSplit; }) - primitives.begin();
+    }
+    if (middle == begin || middle == end) {
+        // Centres confondus, intervalle vide d'un côté ou arbre trop profond: coupure à la médiane
+        middle = begin + count / 2;
+        std::nth_element(primitives.begin() + begin, primitives.begin() + middle, primitives.begin() + end,
+                         [axis](const BuildPrimitive& a, const BuildPrimitive& b) { return a.centroid[axis] < b.centroid[axis]; });
+    }
+
+    buildNode(primitives, begin, middle, depth + 1);
+    uint32_t right = buildNode(primitives, middle, end, depth + 1);
+    m_Nodes[nodeIndex].offset = right;
+    m_Nodes[nodeIndex].count = 0;
+    return nodeIndex;
+}
+
+void BVH::queryBox(const BBox3f& box, std::vector<uint32_t>& result) const {
+    if (m_Nodes.empty()) {
+        return;
+    }
+    uint32_t stack[MAX_DEPTH + 1];
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const uint32_t index = stack[--top];
+        const Node& node = m_Nodes[index];
+        if (!conjoint(node.bounds, box)) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            result.insert(result.end(), m_Primitives.begin() + node.offset, m_Primitives.begin() + node.offset + node.count);
+        }
+        else {
+            stack[top++] = node.offset;
+            stack[top++] = index + 1;
+        }
+    }
+}
+
+void BVH::queryFrustum(const Frustum& frustum, std::vector<uint32_t>& result) const {
+    if (m_Nodes.empty()) {
+        return;
+    }
+    // Le booléen indique un ancêtre entièrement dans le frustum: le sous-arbre est pris sans test
+    std::pair<uint32_t, bool> stack[MAX_DEPTH + 1];
+    size_t top = 0;
+    stack[top++] = std::make_pair(0u, false);
+    while (top > 0) {
+        const auto entry = stack[--top];
+        const Node& node = m_Nodes[entry.first];
+        bool inside = entry.second;
+        if (!inside) {
+            auto side = frustum.classify(node.bounds);
+            if (side == Frustum::OUTSIDE) {
+                continue;
+            }
+            inside = side == Frustum::INSIDE;
+        }
+        if (node.isLeaf()) {
+            result.insert(result.end(), m_Primitives.begin() + node.offset, m_Primitives.begin() + node.offset + node.count);
+        }
+        else {
+            stack[top++] = std::make_pair(node.offset, inside);
+            stack[top++] = std::make_pair(entry.first + 1, inside);
+        }
+    }
+}
+
+void BVH::queryRay(const Ray& ray, std::vector<uint32_t>& result) const {
+    if (m_Nodes.empty()) {
+        return;
+    }
+    const glm::vec3 invDirection = 1.f / ray.direction;
+    uint32_t stack[MAX_DEPTH + 1];
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const uint32_t index = stack[--top];
+        const Node& node = m_Nodes[index];
+        float tEntry;
+        if (!intersectBox(node.bounds, ray.origin, invDirection, ray.tMin, ray.tMax, tEntry)) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            result.insert(result.end(), m_Primitives.begin() + node.offset, m_Primitives.begin() + node.offset + node.count);
+        }
+        else {
+            stack[top++] = node.offset;
+            stack[top++] = index + 1;
+        }
+    }
+}
+
+bool BVH::closestTriangle(const Ray& ray, const glm::vec3* positions, size_t stride, const unsigned int* indices, RayHit& hit) const {
+    auto position = [positions, stride](unsigned int i) -> const glm::vec3& {
+        return *reinterpret_cast<const glm::vec3*>(reinterpret_cast<const char*>(positions) + i * stride);
+    };
+    return closestHit(ray, hit, [&](uint32_t triangle, const Ray& current, float& t) {
+        return intersectTriangle(current, position(indices[3 * triangle]), position(indices[3 * triangle + 1]), position(indices[3 * triangle + 2]), t);
+    });
+}
+
+}
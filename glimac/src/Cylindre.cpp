@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include <vector>
 #include <iostream>
@@ -24,59 +25,85 @@ void Cylindre::build(GLfloat height, GLfloat r, GLsizei discLat, GLsizei discHei
     GLfloat rcpLat = 1.f / discLat, rcpH = 1.f / discHeight;
     GLfloat dPhi = 2 * glm::pi<float>() * rcpLat, dH = height * rcpH;
     
-    std::vector<ShapeVertex> data;
+    // Le cercle de base est le même à chaque hauteur: ses positions et normales sont calculées une seule fois
+    std::vector<ShapeVertex> ring(discLat);
+    for(GLsizei i = 0; i < discLat; ++i) {
+        ShapeVertex& vertex = ring[i];
+        
+        vertex.texCoords.x = i * rcpLat;
+        
+        vertex.position.x = r * sin(i * dPhi);
+        vertex.position.y = r * cos(i * dPhi);
+        
+        /* avec cette formule la normale est mal définie au sommet (= (0, 0, 0))
+        vertex.normal.x = vertex.position.x;
+        vertex.normal.y = r * r * (1 - vertex.position.y / height) / height;
+        vertex.normal.z = vertex.position.z;
+        vertex.normal = glm::normalize(vertex.normal);
+        */
+        
+        vertex.normal.x = sin(i * dPhi);
+        
+        vertex.normal.y = cos(i * dPhi);
+
+        vertex.normal.z = 0;
+        vertex.normal = glm::normalize(vertex.normal);
+    }
+
+    std::vector<ShapeVertex> data((discHeight + 1) * discLat);
+    ShapeVertex* pVertex = data.data();
     
     // Construit l'ensemble des vertex
     for(GLsizei j = 0; j <= discHeight; ++j) {
-        for(GLsizei i = 0; i < discLat; ++i) {
-            ShapeVertex vertex;
-            
-            vertex.texCoords.x = i * rcpLat;
-            vertex.texCoords.y = j * rcpH;
-            
-            vertex.position.x = r * sin(i * dPhi);
-            vertex.position.y = r * cos(i * dPhi);
-            vertex.position.z = j * dH;
-            
-            /* avec cette formule la normale est mal définie au sommet (= (0, 0, 0))
-            vertex.normal.x = vertex.position.x;
-            vertex.normal.y = r * r * (1 - vertex.position.y / height) / height;
-            vertex.normal.z = vertex.position.z;
-            vertex.normal = glm::normalize(vertex.normal);
-            */
-            
-            vertex.normal.x = sin(i * dPhi);
-            
-            vertex.normal.y = cos(i * dPhi);
-
-            vertex.normal.z = 0;
-            vertex.normal = glm::normalize(vertex.normal);
-            
-            data.push_back(vertex);
+        GLfloat texCoordY = j * rcpH;
+        GLfloat z = j * dH;
+        for(GLsizei i = 0; i < discLat; ++i, ++pVertex) {
+            *pVertex = ring[i];
+            pVertex->texCoords.y = texCoordY;
+            pVertex->position.z = z;
         }
     }
 
     m_nVertexCount = discLat * discHeight * 6;
     
-    GLuint idx = 0;
-    // Construit les vertex finaux en regroupant les données en triangles:
+    // Construit les triangles à partir des index:
     // Pour une longitude donnée, les deux triangles formant une face sont de la forme:
     // (i, i + 1, i + discLat + 1), (i, i + discLat + 1, i + discLat)
     // avec i sur la bande correspondant à la longitude
+    m_Indices.reserve(m_nVertexCount);
     for(GLsizei j = 0; j < discHeight; ++j) {
-        GLsizei offset = j * discLat;
+        GLuint offset = j * discLat;
         for(GLsizei i = 0; i < discLat; ++i) {
-            m_Vertices.push_back(data[offset + i]);
-            m_Vertices.push_back(data[offset + (i + 1) % discLat]);
-            m_Vertices.push_back(data[offset + discLat + (i + 1) % discLat]);
-            m_Vertices.push_back(data[offset + i]);
-            m_Vertices.push_back(data[offset + discLat + (i + 1) % discLat]);
-            m_Vertices.push_back(data[offset + i + discLat]);
+            m_Indices.push_back(offset + i);
+            m_Indices.push_back(offset + (i + 1) % discLat);
+            m_Indices.push_back(offset + discLat + (i + 1) % discLat);
+            m_Indices.push_back(offset + i);
+            m_Indices.push_back(offset + discLat + (i + 1) % discLat);
+            m_Indices.push_back(offset + i + discLat);
         }
     }
+
+    // Version non indexée: les sommets de chaque triangle sont dupliqués
+    m_Vertices.reserve(m_nVertexCount);
+    for(auto index: m_Indices) {
+        m_Vertices.push_back(data[index]);
+    }
+    m_IndexedVertices = std::move(data);
     
-    // Attention ! dans cette implantation on duplique beaucoup de sommets. Une meilleur stratégie est de passer
-    // par un Index Buffer Object, que nous verrons dans les prochains TDs
+    // Attention ! la version non indexée duplique beaucoup de sommets: pour dessiner, préférer
+    // getIndexedDataPointer() et getIndexPointer() avec un Index Buffer Object
+}
+
+std::vector<Cylindre> Cylindre::createLODChain(GLfloat height, GLfloat radius, GLsizei discLat, GLsizei discHeight, unsigned int levelCount) {
+    std::vector<Cylindre> levels;
+    levels.reserve(levelCount);
+    for(unsigned int i = 0; i < levelCount; ++i) {
+        levels.emplace_back(height, radius, discLat, discHeight);
+        // Au minimum un prisme triangulaire d'une seule bande
+        discLat = std::max<GLsizei>(discLat / 2, 3);
+        discHeight = std::max<GLsizei>(discHeight / 2, 1);
+    }
+    return levels;
 }
 
 }
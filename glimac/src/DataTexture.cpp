@@ -0,0 +1,78 @@
+#include "glimac/DataTexture.hpp"
+#include "glimac/GLState.hpp"
+#include "glimac/RenderStats.hpp"
+
+namespace glimac {
+
+DataTexture::DataTexture(GLenum internalFormat, GLenum format, GLenum type, size_t texelSize, GLsizei width, GLuint unit):
+    m_InternalFormat(internalFormat), m_Format(format), m_Type(type), m_nTexelSize(texelSize), m_nWidth(width), m_nUnit(unit) {
+    glGenTextures(1, &m_nTexture);
+    // sur sa propre unité: les textures des matériaux (unités 0, 1...) ne sont pas touchées
+    GLState::bindTexture(m_nUnit, m_nTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+DataTexture::~DataTexture() {
+    release();
+}
+
+DataTexture::DataTexture(DataTexture&& rvalue):
+    m_nTexture(rvalue.m_nTexture), m_InternalFormat(rvalue.m_InternalFormat), m_Format(rvalue.m_Format), m_Type(rvalue.m_Type),
+    m_nTexelSize(rvalue.m_nTexelSize), m_nWidth(rvalue.m_nWidth), m_nHeight(rvalue.m_nHeight), m_nUnit(rvalue.m_nUnit) {
+    rvalue.m_nTexture = 0;
+}
+
+DataTexture& DataTexture::operator =(DataTexture&& rvalue) {
+    if (this != &rvalue) {
+        release();
+        m_nTexture = rvalue.m_nTexture;
+        m_InternalFormat = rvalue.m_InternalFormat;
+        m_Format = rvalue.m_Format;
+        m_Type = rvalue.m_Type;
+        m_nTexelSize = rvalue.m_nTexelSize;
+        m_nWidth = rvalue.m_nWidth;
+        m_nHeight = rvalue.m_nHeight;
+        m_nUnit = rvalue.m_nUnit;
+        rvalue.m_nTexture = 0;
+    }
+    return *this;
+}
+
+void DataTexture::release() {
+    glDeleteTextures(1, &m_nTexture);
+    m_nTexture = 0;
+    // le nom peut être réutilisé par une autre texture: le cache ne doit plus le croire bindé
+    GLState::invalidate();
+}
+
+void DataTexture::upload(const void* texels, size_t texelCount) {
+    GLsizei rows = GLsizei((texelCount + m_nWidth - 1) / m_nWidth);
+    GLState::bindTexture(m_nUnit, m_nTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (rows > m_nHeight || m_nHeight == 0) {
+        // agrandie par puissances de 2 pour ne pas réallouer à chaque frame
+        GLsizei height = 1;
+        while (height < rows) {
+            height *= 2;
+        }
+        glTexImage2D(GL_TEXTURE_2D, 0, m_InternalFormat, m_nWidth, height, 0, m_Format, m_Type, nullptr);
+        m_nHeight = height;
+    }
+
+    // lignes complètes puis le reste de la dernière ligne
+    GLsizei fullRows = GLsizei(texelCount / m_nWidth);
+    if (fullRows > 0) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_nWidth, fullRows, m_Format, m_Type, texels);
+    }
+    GLsizei remainder = GLsizei(texelCount % m_nWidth);
+    if (remainder > 0) {
+        const char* lastRow = static_cast<const char*>(texels) + size_t(fullRows) * m_nWidth * m_nTexelSize;
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, fullRows, remainder, 1, m_Format, m_Type, lastRow);
+    }
+    RenderStats::addUpload(texelCount * m_nTexelSize);
+}
+
+}
@@ -0,0 +1,109 @@
+#include "glimac/Frustum.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define GLIMAC_FRUSTUM_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace glimac {
+
+Frustum::Frustum(const glm::mat4& matrix) {
+    // Gribb et Hartmann: chaque plan est la somme ou la différence de la 4e ligne et d'une autre ligne,
+    // le volume de clipping OpenGL étant -w <= x, y, z <= w
+    glm::vec4 rows[4];
+    for (auto i = 0u; i < 4; ++i) {
+        rows[i] = glm::vec4(matrix[0][i], matrix[1][i], matrix[2][i], matrix[3][i]);
+    }
+    for (auto i = 0u; i < 3; ++i) {
+        planes[2 * i] = rows[3] + rows[i];
+        planes[2 * i + 1] = rows[3] - rows[i];
+    }
+}
+
+Frustum::Side Frustum::classify(const BBox3f& box) const {
+    Side side = INSIDE;
+    for (const auto& plane: planes) {
+        glm::vec3 normal(plane);
+        // p: coin de la boîte le plus loin dans la direction de la normale, n: le plus loin à l'opposé
+        glm::vec3 p(normal.x >= 0.f ? box.upper.x : box.lower.x, normal.y >= 0.f ? box.upper.y : box.lower.y, normal.z >= 0.f ? box.upper.z : box.lower.z);
+        if (glm::dot(normal, p) + plane.w < 0.f) {
+            return OUTSIDE;
+        }
+        glm::vec3 n(normal.x >= 0.f ? box.lower.x : box.upper.x, normal.y >= 0.f ? box.lower.y : box.upper.y, normal.z >= 0.f ? box.lower.z : box.upper.z);
+        if (glm::dot(normal, n) + plane.w < 0.f) {
+            side = INTERSECTS;
+        }
+    }
+    return side;
+}
+
+bool Frustum::intersects(const glm::vec3& center, float radius) const {
+    for (const auto& plane: planes) {
+        glm::vec3 normal(plane);
+        // Les plans ne sont pas normalisés: la distance signée est divisée par la longueur de la normale
+        if (glm::dot(normal, center) + plane.w < -radius * glm::length(normal)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t Frustum::testBoxes(const BBox3f* boxes, size_t count, unsigned char* visible) const {
+    // Avec le centre c et la demi-taille e d'une boîte, le sommet p est à la distance n.c + |n|.e + d du plan:
+    // la boîte est dehors si cette distance est négative pour un des plans
+    size_t visibleCount = 0;
+#ifdef GLIMAC_FRUSTUM_SSE
+    // Plans rangés par composante, complétés jusqu'à 8 par deux plans neutres (normale nulle, d = 1)
+    float components[4][8];
+    for (auto i = 0u; i < 8; ++i) {
+        glm::vec4 plane = i < 6 ? planes[i] : glm::vec4(0.f, 0.f, 0.f, 1.f);
+        for (auto k = 0u; k < 4; ++k) {
+            components[k][i] = plane[k];
+        }
+    }
+    const __m128 signMask = _mm_set1_ps(-0.f);
+    __m128 nx[2], ny[2], nz[2], d[2], ax[2], ay[2], az[2];
+    for (auto g = 0u; g < 2; ++g) {
+        nx[g] = _mm_loadu_ps(components[0] + 4 * g);
+        ny[g] = _mm_loadu_ps(components[1] + 4 * g);
+        nz[g] = _mm_loadu_ps(components[2] + 4 * g);
+        d[g] = _mm_loadu_ps(components[3] + 4 * g);
+        ax[g] = _mm_andnot_ps(signMask, nx[g]);
+        ay[g] = _mm_andnot_ps(signMask, ny[g]);
+        az[g] = _mm_andnot_ps(signMask, nz[g]);
+    }
+    const __m128 zero = _mm_setzero_ps();
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 c = center(boxes[i]);
+        glm::vec3 e = boxes[i].upper - c;
+        __m128 cx = _mm_set1_ps(c.x), cy = _mm_set1_ps(c.y), cz = _mm_set1_ps(c.z);
+        __m128 ex = _mm_set1_ps(e.x), ey = _mm_set1_ps(e.y), ez = _mm_set1_ps(e.z);
+        int outside = 0;
+        for (auto g = 0u; g < 2; ++g) {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[g], cx), _mm_mul_ps(ny[g], cy)), _mm_add_ps(_mm_mul_ps(nz[g], cz), d[g]));
+            __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[g], ex), _mm_mul_ps(ay[g], ey)), _mm_mul_ps(az[g], ez));
+            outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+        }
+        visible[i] = outside == 0;
+        visibleCount += visible[i];
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 c = center(boxes[i]);
+        glm::vec3 e = boxes[i].upper - c;
+        bool inside = true;
+        for (const auto& plane: planes) {
+            glm::vec3 normal(plane);
+            if (glm::dot(normal, c) + glm::dot(glm::abs(normal), e) + plane.w < 0.f) {
+                inside = false;
+                break;
+            }
+        }
+        visible[i] = inside;
+        visibleCount += visible[i];
+    }
+#endif
+    return visibleCount;
+}
+
+}
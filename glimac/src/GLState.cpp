@@ -0,0 +1,69 @@
+#include "glimac/GLState.hpp"
+#include "glimac/RenderStats.hpp"
+
+namespace glimac {
+
+// Valeur qu'aucun objet GL ne peut avoir: état inconnu
+static const GLuint UNKNOWN = 0xffffffffu;
+
+GLuint GLState::m_nProgram = UNKNOWN;
+GLuint GLState::m_nVertexArray = UNKNOWN;
+GLuint GLState::m_nActiveUnit = UNKNOWN;
+GLuint GLState::m_BoundTextures[GLState::MAX_TEXTURE_UNITS] = { UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN,
+                                                                UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN };
+
+void GLState::useProgram(GLuint program) {
+    if (program != m_nProgram) {
+        glUseProgram(program);
+        m_nProgram = program;
+        RenderStats::addStateChange(RenderStats::PROGRAM_CHANGE);
+    }
+}
+
+void GLState::bindVertexArray(GLuint vertexArray) {
+    if (vertexArray != m_nVertexArray) {
+        glBindVertexArray(vertexArray);
+        m_nVertexArray = vertexArray;
+        RenderStats::addStateChange(RenderStats::VERTEX_ARRAY_CHANGE);
+    }
+}
+
+void GLState::bindTexture(GLuint unit, GLuint texture) {
+    if (unit >= MAX_TEXTURE_UNITS) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        m_nActiveUnit = unit;
+        RenderStats::addStateChange(RenderStats::TEXTURE_CHANGE);
+        return;
+    }
+    if (texture != m_BoundTextures[unit]) {
+        if (unit != m_nActiveUnit) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            m_nActiveUnit = unit;
+        }
+        glBindTexture(GL_TEXTURE_2D, texture);
+        m_BoundTextures[unit] = texture;
+        RenderStats::addStateChange(RenderStats::TEXTURE_CHANGE);
+    }
+}
+
+void GLState::deleteVertexArray(GLuint vertexArray) {
+    if (vertexArray == 0) {
+        return;
+    }
+    glDeleteVertexArrays(1, &vertexArray);
+    if (vertexArray == m_nVertexArray) {
+        m_nVertexArray = 0;
+    }
+}
+
+void GLState::invalidate() {
+    m_nProgram = UNKNOWN;
+    m_nVertexArray = UNKNOWN;
+    m_nActiveUnit = UNKNOWN;
+    for (GLuint i = 0; i < MAX_TEXTURE_UNITS; ++i) {
+        m_BoundTextures[i] = UNKNOWN;
+    }
+}
+
+}
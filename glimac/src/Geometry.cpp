@@ -1,33 +1,330 @@
 #include "glimac/Geometry.hpp"
+#include "glimac/AssetLoader.hpp"
+#include "glimac/MappedFile.hpp"
+#include "glimac/MeshOptimizer.hpp"
+#include "glimac/NormalGenerator.hpp"
+#include "glimac/ThreadPool.hpp"
 #include "tiny_obj_loader.h"
 #include <iostream>
+#include <fstream>
+#include <filesystem>
 #include <algorithm>
+#include <cstring>
 
 namespace glimac {
 
-void Geometry::generateNormals(unsigned int meshIndex) {
-    auto indexOffset = m_MeshBuffer[meshIndex].m_nIndexOffset;
-    for (auto j = 0u; j < m_MeshBuffer[meshIndex].m_nIndexCount; j += 3) {
-        auto i1 = m_IndexBuffer[indexOffset + j];
-        auto i2 = m_IndexBuffer[indexOffset + j + 1];
-        auto i3 = m_IndexBuffer[indexOffset + j + 2];
+void Geometry::generateNormals(size_t indexOffset, size_t indexCount, size_t firstVertex, size_t vertexCount) {
+    auto splits = generateSmoothNormals(m_IndexBuffer.data() + indexOffset, indexCount, getPositions(), getMutableNormals(),
+                                        firstVertex, vertexCount, m_fCreaseAngle, ThreadPool::getDefault());
+    if (splits.empty()) {
+        return;
+    }
+    std::clog << "Split " << splits.size() << " vertices along creases" << std::endl;
+
+    // Copies numbered from the current vertex count, in order
+    auto count = getVertexCount();
+    if (m_Storage == VertexStorage::SoA) {
+        m_Positions.resize(count + splits.size());
+        m_Normals.resize(count + splits.size());
+        m_TexCoords.resize(count + splits.size());
+        for (size_t i = 0; i < splits.size(); ++i) {
+            m_Positions[count + i] = m_Positions[splits[i].source];
+            m_Normals[count + i] = splits[i].normal;
+            m_TexCoords[count + i] = m_TexCoords[splits[i].source];
+        }
+    }
+    else {
+        m_VertexBuffer.resize(count + splits.size());
+        for (size_t i = 0; i < splits.size(); ++i) {
+            m_VertexBuffer[count + i] = m_VertexBuffer[splits[i].source];
+            m_VertexBuffer[count + i].m_Normal = splits[i].normal;
+        }
+    }
+}
+
+void Geometry::recomputeNormals() {
+    generateNormals(0, m_IndexBuffer.size(), 0, getVertexCount());
+}
+
+void Geometry::computeBoundingBox() {
+    auto positions = getPositions();
+    if (positions.m_nCount == 0) {
+        return;
+    }
+    m_BBox = BBox3f::fromPoints(positions.m_pData, positions.m_nCount, positions.m_nStride, ThreadPool::getDefault());
+}
+
+VertexStream<const glm::vec3> Geometry::getPositions() const {
+    if (m_Storage == VertexStorage::SoA) {
+        return VertexStream<const glm::vec3>{ m_Positions.data(), sizeof(glm::vec3), m_Positions.size() };
+    }
+    return VertexStream<const glm::vec3>{ m_VertexBuffer.empty() ? nullptr : &m_VertexBuffer[0].m_Position, sizeof(Vertex), m_VertexBuffer.size() };
+}
+
+VertexStream<const glm::vec3> Geometry::getNormals() const {
+    if (m_Storage == VertexStorage::SoA) {
+        return VertexStream<const glm::vec3>{ m_Normals.data(), sizeof(glm::vec3), m_Normals.size() };
+    }
+    return VertexStream<const glm::vec3>{ m_VertexBuffer.empty() ? nullptr : &m_VertexBuffer[0].m_Normal, sizeof(Vertex), m_VertexBuffer.size() };
+}
+
+VertexStream<const glm::vec2> Geometry::getTexCoords() const {
+    if (m_Storage == VertexStorage::SoA) {
+        return VertexStream<const glm::vec2>{ m_TexCoords.data(), sizeof(glm::vec2), m_TexCoords.size() };
+    }
+    return VertexStream<const glm::vec2>{ m_VertexBuffer.empty() ? nullptr : &m_VertexBuffer[0].m_TexCoords, sizeof(Vertex), m_VertexBuffer.size() };
+}
 
-        auto n = glm::cross(glm::normalize(m_VertexBuffer[i2].m_Position - m_VertexBuffer[i1].m_Position),
-                            glm::normalize(m_VertexBuffer[i3].m_Position - m_VertexBuffer[i1].m_Position));
+VertexStream<glm::vec3> Geometry::getMutablePositions() {
+    if (m_Storage == VertexStorage::SoA) {
+        return VertexStream<glm::vec3>{ m_Positions.data(), sizeof(glm::vec3), m_Positions.size() };
+    }
+    return VertexStream<glm::vec3>{ m_VertexBuffer.empty() ? nullptr : &m_VertexBuffer[0].m_Position, sizeof(Vertex), m_VertexBuffer.size() };
+}
+
+VertexStream<glm::vec3> Geometry::getMutableNormals() {
+    if (m_Storage == VertexStorage::SoA) {
+        return VertexStream<glm::vec3>{ m_Normals.data(), sizeof(glm::vec3), m_Normals.size() };
+    }
+    return VertexStream<glm::vec3>{ m_VertexBuffer.empty() ? nullptr : &m_VertexBuffer[0].m_Normal, sizeof(Vertex), m_VertexBuffer.size() };
+}
 
-        m_VertexBuffer[i1].m_Normal = n;
-        m_VertexBuffer[i2].m_Normal = n;
-        m_VertexBuffer[i3].m_Normal = n;
+void Geometry::setVertexStorage(VertexStorage storage) {
+    if (storage == m_Storage) {
+        return;
+    }
+    if (storage == VertexStorage::SoA) {
+        auto count = m_VertexBuffer.size();
+        m_Positions.resize(count);
+        m_Normals.resize(count);
+        m_TexCoords.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            m_Positions[i] = m_VertexBuffer[i].m_Position;
+            m_Normals[i] = m_VertexBuffer[i].m_Normal;
+            m_TexCoords[i] = m_VertexBuffer[i].m_TexCoords;
+        }
+        std::vector<Vertex>().swap(m_VertexBuffer);
+    }
+    else {
+        auto count = m_Positions.size();
+        m_VertexBuffer.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            m_VertexBuffer[i] = Vertex{ m_Positions[i], m_Normals[i], m_TexCoords[i] };
+        }
+        std::vector<glm::vec3>().swap(m_Positions);
+        std::vector<glm::vec3>().swap(m_Normals);
+        std::vector<glm::vec2>().swap(m_TexCoords);
+    }
+    m_Storage = storage;
+}
+
+namespace {
+
+struct MeshCacheString {
+    uint32_t offset;
+    uint32_t size;
+};
+
+// Layout of a ".cache" file, every block in native byte order:
+//   MeshCacheHeader
+//   Geometry::Vertex[vertexCount]
+//   unsigned int[indexCount]            indices relative to the first vertex of the file
+//   MeshCacheMesh[meshCount]
+//   MeshCacheMaterial[materialCount]
+//   MeshCacheLibrary[libraryCount]      .mtl files read by the .obj
+//   char[stringSize]                    mesh, texture and file names, referenced by MeshCacheString
+const char MESH_CACHE_MAGIC[4] = { 'G', 'M', 'S', 'H' };
+// 2: .mtl stamps and base path, 3: meshes optimised for the vertex cache, 4: smooth generated normals
+const uint32_t MESH_CACHE_VERSION = 4;
+
+struct MeshCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t vertexSize; // sizeof(Geometry::Vertex): rejects a cache written with another layout
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t meshCount;
+    uint32_t materialCount;
+    uint32_t stringSize;
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    float bboxLower[3];
+    float bboxUpper[3];
+    float creaseAngle; // Generated normals depend on it
+    uint32_t libraryCount;
+    MeshCacheString mtlBasePath;
+};
+
+struct MeshCacheMesh {
+    MeshCacheString name;
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    int32_t materialIndex;
+};
+
+struct MeshCacheMaterial {
+    float ka[3], kd[3], ks[3], tr[3], le[3];
+    float shininess;
+    float refractionIndex;
+    float dissolve;
+    MeshCacheString maps[4]; // same order as MATERIAL_MAPS
+};
+
+struct MeshCacheLibrary {
+    MeshCacheString path; // as read by the loader: mtlBasePath + mtllib name
+    uint64_t sourceSize;
+    int64_t sourceTime;
+};
+
+const Image* Geometry::Material::* const MATERIAL_MAPS[4] = {
+    &Geometry::Material::m_pKaMap, &Geometry::Material::m_pKdMap, &Geometry::Material::m_pKsMap, &Geometry::Material::m_pNormalMap
+};
+
+bool getSourceStamp(const FilePath& filepath, uint64_t& size, int64_t& time) {
+    std::error_code error;
+    size = std::filesystem::file_size(filepath.str(), error);
+    if (error) {
+        return false;
     }
+    time = std::filesystem::last_write_time(filepath.str(), error).time_since_epoch().count();
+    return !error;
+}
+
+// A missing .mtl is stamped too, so that creating it invalidates the cache
+void getLibraryStamp(const FilePath& filepath, uint64_t& size, int64_t& time) {
+    if (!getSourceStamp(filepath, size, time)) {
+        size = UINT64_MAX;
+        time = 0;
+    }
+}
+
+}
+
+// The .mtl files named by the "mtllib" lines of the .obj, resolved like tinyobj::MaterialFileReader does
+std::vector<Geometry::MaterialLibrary> Geometry::findMaterialLibraries(const FilePath& filepath, const FilePath& mtlBasePath) {
+    std::vector<MaterialLibrary> libraries;
+    MappedFile file;
+    if (!file.open(filepath)) {
+        return libraries;
+    }
+    const char* cursor = file.data();
+    const char* end = file.data() + file.size();
+    while (cursor < end) {
+        const char* lineEnd = (const char*)memchr(cursor, '\n', end - cursor);
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        const char* token = cursor;
+        while (token < lineEnd && (*token == ' ' || *token == '\t')) {
+            ++token;
+        }
+        if (lineEnd - token > 7 && memcmp(token, "mtllib", 6) == 0 && (token[6] == ' ' || token[6] == '\t')) {
+            const char* name = token + 7;
+            while (name < lineEnd && (*name == ' ' || *name == '\t')) {
+                ++name;
+            }
+            const char* nameEnd = name;
+            while (nameEnd < lineEnd && *nameEnd != ' ' && *nameEnd != '\t' && *nameEnd != '\r') {
+                ++nameEnd;
+            }
+            FilePath path = mtlBasePath.str() + std::string(name, nameEnd);
+            MaterialLibrary library;
+            library.m_sPath = path.str();
+            getLibraryStamp(path, library.m_Stamp.m_nSize, library.m_Stamp.m_nTime);
+            libraries.push_back(library);
+        }
+        cursor = lineEnd + 1;
+    }
+    return libraries;
+}
+
+namespace {
+
+MeshCacheString addString(std::string& strings, const std::string& str) {
+    MeshCacheString result = { uint32_t(strings.size()), uint32_t(str.size()) };
+    strings += str;
+    return result;
+}
+
+bool getString(const char* strings, uint32_t stringSize, const MeshCacheString& str, std::string& result) {
+    if (str.offset > stringSize || str.size > stringSize - str.offset) {
+        return false;
+    }
+    result.assign(strings + str.offset, str.size);
+    return true;
+}
+
 }
 
 bool Geometry::loadOBJ(const FilePath& filepath, const FilePath& mtlBasePath, bool loadTextures) {
+    auto storage = m_Storage;
+    setVertexStorage(VertexStorage::AoS);
+    bool result = loadOBJData(filepath, mtlBasePath, loadTextures);
+    setVertexStorage(storage);
+    return result;
+}
+
+bool Geometry::loadOBJData(const FilePath& filepath, const FilePath& mtlBasePath, bool loadTextures) {
+    auto vertexOffset = m_VertexBuffer.size();
+    auto indexOffset = m_IndexBuffer.size();
+    auto meshOffset = m_MeshBuffer.size();
+    auto materialOffset = m_Materials.size();
+
+    // Taken before parsing: a file modified meanwhile must not be cached as up to date
+    SourceStamp stamp;
+    bool hasStamp = getSourceStamp(filepath, stamp.m_nSize, stamp.m_nTime);
+
+    const FilePath cachePath = filepath.addExt(".cache");
+    std::vector<std::string> textureNames;
+    if (hasStamp && loadCache(cachePath, stamp, mtlBasePath, textureNames)) {
+        std::clog << "Load OBJ " << filepath << " from " << cachePath << std::endl;
+    }
+    else {
+        std::vector<MaterialLibrary> libraries;
+        if (hasStamp) {
+            libraries = findMaterialLibraries(filepath, mtlBasePath);
+        }
+        if (!parseOBJ(filepath, mtlBasePath, textureNames)) {
+            return false;
+        }
+        optimizeMeshes(vertexOffset, meshOffset);
+        if (hasStamp) {
+            writeCache(cachePath, stamp, mtlBasePath, libraries, textureNames, vertexOffset, indexOffset, meshOffset, materialOffset);
+        }
+    }
+
+    if(loadTextures) {
+        // Les textures sont décodées en parallèle, on récupère les résultats après la boucle
+        struct PendingMap {
+            size_t materialIndex;
+            const Image* Material::* map;
+            std::future<const Image*> image;
+        };
+        std::vector<PendingMap> pendingMaps;
+        AssetLoader loader;
+
+        for (auto i = 0u; i < textureNames.size(); ++i) {
+            if(!textureNames[i].empty()) {
+                FilePath texturePath = mtlBasePath + textureNames[i];
+                std::clog << "load " << texturePath << std::endl;
+                pendingMaps.push_back(PendingMap{ materialOffset + i / 4, MATERIAL_MAPS[i % 4], loader.loadManagedImage(texturePath) });
+            }
+        }
+        for(auto& pending: pendingMaps) {
+            m_Materials[pending.materialIndex].*pending.map = pending.image.get();
+        }
+    }
+
+    return true;
+}
+
+bool Geometry::parseOBJ(const FilePath& filepath, const FilePath& mtlBasePath, std::vector<std::string>& textureNames) {
     std::vector<tinyobj::shape_t> shapes;
     std::vector<tinyobj::material_t> materials;
 
     std::clog << "Load OBJ " << filepath << std::endl;
-    std::string objErr = tinyobj::LoadObj(shapes, materials,
-        filepath.c_str(), mtlBasePath.c_str());
+    std::string objErr = tinyobj::LoadObjParallel(shapes, materials,
+        filepath.c_str(), ThreadPool::getDefault(), mtlBasePath.c_str());
 
     std::clog << "done." << std::endl;
 
@@ -51,35 +348,11 @@ bool Geometry::loadOBJ(const FilePath& filepath, const FilePath& mtlBasePath, bo
         m.m_RefractionIndex = material.ior;
         m.m_Dissolve = material.dissolve;
 
-        if(loadTextures) {
-            if(!material.ambient_texname.empty()) {
-                //std::replace(material.ambient_texname.begin(), material.ambient_texname.end(), '\\', '/');
-                FilePath texturePath = mtlBasePath + material.ambient_texname;
-                std::clog << "load " << texturePath << std::endl;
-                m.m_pKaMap = ImageManager::loadImage(texturePath);
-            }
-
-            if(!material.diffuse_texname.empty()) {
-                //std::replace(material.diffuse_texname.begin(), material.diffuse_texname.end(), '\\', '/');
-                FilePath texturePath = mtlBasePath + material.diffuse_texname;
-                std::clog << "load " << texturePath << std::endl;
-                m.m_pKdMap = ImageManager::loadImage(texturePath);
-            }
-
-            if(!material.specular_texname.empty()) {
-                //std::replace(material.specular_texname.begin(), material.specular_texname.end(), '\\', '/');
-                FilePath texturePath = mtlBasePath + material.specular_texname;
-                std::clog << "load " << texturePath << std::endl;
-                m.m_pKsMap = ImageManager::loadImage(texturePath);
-            }
-
-            if(!material.normal_texname.empty()) {
-                //std::replace(material.normal_texname.begin(), material.normal_texname.end(), '\\', '/');
-                FilePath texturePath = mtlBasePath + material.normal_texname;
-                std::clog << "load " << texturePath << std::endl;
-                m.m_pNormalMap = ImageManager::loadImage(texturePath);
-            }
-        }
+        // Same order as MATERIAL_MAPS
+        textureNames.push_back(material.ambient_texname);
+        textureNames.push_back(material.diffuse_texname);
+        textureNames.push_back(material.specular_texname);
+        textureNames.push_back(material.normal_texname);
     }
     std::clog << "done." << std::endl;
 
@@ -89,7 +362,7 @@ bool Geometry::loadOBJ(const FilePath& filepath, const FilePath& mtlBasePath, bo
     auto nbVertex = 0u;
     auto nbIndex = 0u;
     for (const auto& shape: shapes) {
-        nbVertex += shape.mesh.positions.size();
+        nbVertex += shape.mesh.positions.size() / 3;
         nbIndex += shape.mesh.indices.size();
     }
 
@@ -107,17 +380,23 @@ bool Geometry::loadOBJ(const FilePath& filepath, const FilePath& mtlBasePath, bo
 
     m_MeshBuffer.reserve(m_MeshBuffer.size() + shapes.size());
 
+    // Normals are generated once every shape is copied: crease splits append vertices to the buffer
+    struct MeshVertices {
+        size_t indexOffset, indexCount, vertexOffset, vertexCount;
+    };
+    std::vector<MeshVertices> missingNormals;
+
     auto vertexOffset = globalVertexOffset;
     auto indexOffset = globalIndexOffset;
     for (size_t i = 0; i < shapes.size(); i++) {
+        m_BBox.grow(BBox3f::fromPoints(reinterpret_cast<const glm::vec3*>(shapes[i].mesh.positions.data()),
+                                       shapes[i].mesh.positions.size() / 3, sizeof(glm::vec3), ThreadPool::getDefault()));
+
         auto pVertexTmp = pVertex;
         for (auto j = 0u; j < shapes[i].mesh.positions.size(); j += 3) {
             pVertexTmp->m_Position.x = shapes[i].mesh.positions[j];
             pVertexTmp->m_Position.y = shapes[i].mesh.positions[j + 1];
             pVertexTmp->m_Position.z = shapes[i].mesh.positions[j + 2];
-
-            m_BBox.grow(pVertexTmp->m_Position);
-
             ++pVertexTmp;
         }
         pVertexTmp = pVertex;
@@ -158,16 +437,244 @@ bool Geometry::loadOBJ(const FilePath& filepath, const FilePath& mtlBasePath, bo
         m_MeshBuffer.emplace_back(shapes[i].name, indexOffset, shapes[i].mesh.indices.size(), materialIndex);
 
         if(shapes[i].mesh.normals.size() == 0u) {
-            generateNormals(m_MeshBuffer.size() - 1);
+            missingNormals.push_back(MeshVertices{ indexOffset, shapes[i].mesh.indices.size(), vertexOffset, shapes[i].mesh.positions.size() / 3 });
         }
 
-        pVertex += shapes[i].mesh.positions.size();
-        vertexOffset += shapes[i].mesh.positions.size();
+        pVertex += shapes[i].mesh.positions.size() / 3;
+        vertexOffset += shapes[i].mesh.positions.size() / 3;
         pIndex += shapes[i].mesh.indices.size();
         indexOffset += shapes[i].mesh.indices.size();
     }
 
+    for (const auto& mesh: missingNormals) {
+        generateNormals(mesh.indexOffset, mesh.indexCount, mesh.vertexOffset, mesh.vertexCount);
+    }
+
     return true;
 }
 
+
+void Geometry::optimizeMeshes(size_t vertexOffset, size_t meshOffset) {
+    for (auto i = meshOffset; i < m_MeshBuffer.size(); ++i) {
+        optimizeVertexCache(m_IndexBuffer.data() + m_MeshBuffer[i].m_nIndexOffset, m_MeshBuffer[i].m_nIndexCount);
+    }
+
+    // The meshes are in index buffer order, so the vertices of each mesh stay together
+    auto indexOffset = meshOffset < m_MeshBuffer.size() ? m_MeshBuffer[meshOffset].m_nIndexOffset : m_IndexBuffer.size();
+    auto remap = optimizeVertexFetch(m_IndexBuffer.data() + indexOffset, m_IndexBuffer.size() - indexOffset,
+                                     vertexOffset, m_VertexBuffer.size() - vertexOffset);
+    std::vector<Vertex> vertices(remap.size());
+    for (auto i = 0u; i < remap.size(); ++i) {
+        vertices[remap[i]] = m_VertexBuffer[vertexOffset + i];
+    }
+    std::copy(vertices.begin(), vertices.end(), m_VertexBuffer.begin() + vertexOffset);
+}
+
+bool Geometry::loadCache(const FilePath& cachePath, const SourceStamp& stamp, const FilePath& mtlBasePath, std::vector<std::string>& textureNames) {
+    MappedFile file;
+    if (!file.open(cachePath) || file.size() < sizeof(MeshCacheHeader)) {
+        return false;
+    }
+
+    MeshCacheHeader header;
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic)) != 0 || header.version != MESH_CACHE_VERSION ||
+        header.vertexSize != sizeof(Vertex) || header.sourceSize != stamp.m_nSize || header.sourceTime != stamp.m_nTime ||
+        header.creaseAngle != m_fCreaseAngle) {
+        return false;
+    }
+
+    // Block sizes are checked against the file size so that a truncated cache is rejected
+    const uint64_t vertexBytes = uint64_t(header.vertexCount) * sizeof(Vertex);
+    const uint64_t indexBytes = uint64_t(header.indexCount) * sizeof(unsigned int);
+    const uint64_t meshBytes = uint64_t(header.meshCount) * sizeof(MeshCacheMesh);
+    const uint64_t materialBytes = uint64_t(header.materialCount) * sizeof(MeshCacheMaterial);
+    const uint64_t libraryBytes = uint64_t(header.libraryCount) * sizeof(MeshCacheLibrary);
+    if (file.size() != sizeof(header) + vertexBytes + indexBytes + meshBytes + materialBytes + libraryBytes + header.stringSize) {
+        return false;
+    }
+    const char* pVertices = file.data() + sizeof(header);
+    const char* pIndices = pVertices + vertexBytes;
+    const char* pMeshes = pIndices + indexBytes;
+    const char* pMaterials = pMeshes + meshBytes;
+    const char* pLibraries = pMaterials + materialBytes;
+    const char* pStrings = pLibraries + libraryBytes;
+
+    // Materials and texture names come from the .mtl files, found relative to mtlBasePath
+    std::string cachedBasePath;
+    if (!getString(pStrings, header.stringSize, header.mtlBasePath, cachedBasePath) || cachedBasePath != mtlBasePath.str()) {
+        return false;
+    }
+    for (auto i = 0u; i < header.libraryCount; ++i) {
+        MeshCacheLibrary library;
+        memcpy(&library, pLibraries + i * sizeof(library), sizeof(library));
+        std::string path;
+        if (!getString(pStrings, header.stringSize, library.path, path)) {
+            return false;
+        }
+        SourceStamp libraryStamp;
+        getLibraryStamp(path, libraryStamp.m_nSize, libraryStamp.m_nTime);
+        if (libraryStamp.m_nSize != library.sourceSize || libraryStamp.m_nTime != library.sourceTime) {
+            return false;
+        }
+    }
+
+    auto vertexOffset = m_VertexBuffer.size();
+    auto indexOffset = m_IndexBuffer.size();
+    auto meshOffset = m_MeshBuffer.size();
+    auto materialOffset = m_Materials.size();
+    auto rollback = [&]() {
+        m_VertexBuffer.resize(vertexOffset);
+        m_IndexBuffer.resize(indexOffset);
+        m_MeshBuffer.resize(meshOffset, Mesh("", 0, 0, -1));
+        m_Materials.resize(materialOffset);
+        textureNames.clear();
+        return false;
+    };
+
+    m_VertexBuffer.resize(vertexOffset + header.vertexCount);
+    memcpy(m_VertexBuffer.data() + vertexOffset, pVertices, vertexBytes);
+
+    m_IndexBuffer.resize(indexOffset + header.indexCount);
+    auto pIndex = m_IndexBuffer.data() + indexOffset;
+    memcpy(pIndex, pIndices, indexBytes);
+    for (auto i = 0u; i < header.indexCount; ++i) {
+        if (pIndex[i] >= header.vertexCount) {
+            return rollback();
+        }
+        pIndex[i] += vertexOffset;
+    }
+
+    m_MeshBuffer.reserve(meshOffset + header.meshCount);
+    for (auto i = 0u; i < header.meshCount; ++i) {
+        MeshCacheMesh mesh;
+        memcpy(&mesh, pMeshes + i * sizeof(mesh), sizeof(mesh));
+        std::string name;
+        if (!getString(pStrings, header.stringSize, mesh.name, name) ||
+            mesh.indexOffset > header.indexCount || mesh.indexCount > header.indexCount - mesh.indexOffset) {
+            return rollback();
+        }
+        m_MeshBuffer.emplace_back(std::move(name), indexOffset + mesh.indexOffset, mesh.indexCount, mesh.materialIndex);
+    }
+
+    m_Materials.reserve(materialOffset + header.materialCount);
+    for (auto i = 0u; i < header.materialCount; ++i) {
+        MeshCacheMaterial material;
+        memcpy(&material, pMaterials + i * sizeof(material), sizeof(material));
+        m_Materials.emplace_back();
+        auto& m = m_Materials.back();
+
+        m.m_Ka = glm::vec3(material.ka[0], material.ka[1], material.ka[2]);
+        m.m_Kd = glm::vec3(material.kd[0], material.kd[1], material.kd[2]);
+        m.m_Ks = glm::vec3(material.ks[0], material.ks[1], material.ks[2]);
+        m.m_Tr = glm::vec3(material.tr[0], material.tr[1], material.tr[2]);
+        m.m_Le = glm::vec3(material.le[0], material.le[1], material.le[2]);
+        m.m_Shininess = material.shininess;
+        m.m_RefractionIndex = material.refractionIndex;
+        m.m_Dissolve = material.dissolve;
+
+        for (const auto& map: material.maps) {
+            textureNames.emplace_back();
+            if (!getString(pStrings, header.stringSize, map, textureNames.back())) {
+                return rollback();
+            }
+        }
+    }
+
+    m_BBox = BBox3f(glm::vec3(header.bboxLower[0], header.bboxLower[1], header.bboxLower[2]),
+                    glm::vec3(header.bboxUpper[0], header.bboxUpper[1], header.bboxUpper[2]));
+
+    return true;
+}
+
+void Geometry::writeCache(const FilePath& cachePath, const SourceStamp& stamp, const FilePath& mtlBasePath,
+                          const std::vector<MaterialLibrary>& libraries, const std::vector<std::string>& textureNames,
+                          size_t vertexOffset, size_t indexOffset, size_t meshOffset, size_t materialOffset) const {
+    MeshCacheHeader header;
+    memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic));
+    header.version = MESH_CACHE_VERSION;
+    header.vertexSize = sizeof(Vertex);
+    header.creaseAngle = m_fCreaseAngle;
+    header.libraryCount = libraries.size();
+    header.vertexCount = m_VertexBuffer.size() - vertexOffset;
+    header.indexCount = m_IndexBuffer.size() - indexOffset;
+    header.meshCount = m_MeshBuffer.size() - meshOffset;
+    header.materialCount = m_Materials.size() - materialOffset;
+    header.sourceSize = stamp.m_nSize;
+    header.sourceTime = stamp.m_nTime;
+    for (auto i = 0u; i < 3u; ++i) {
+        header.bboxLower[i] = m_BBox.lower[i];
+        header.bboxUpper[i] = m_BBox.upper[i];
+    }
+
+    std::string strings;
+    header.mtlBasePath = addString(strings, mtlBasePath.str());
+
+    std::vector<MeshCacheLibrary> cachedLibraries;
+    cachedLibraries.reserve(libraries.size());
+    for (const auto& library: libraries) {
+        cachedLibraries.push_back(MeshCacheLibrary{ addString(strings, library.m_sPath), library.m_Stamp.m_nSize, library.m_Stamp.m_nTime });
+    }
+
+    std::vector<unsigned int> indices(m_IndexBuffer.begin() + indexOffset, m_IndexBuffer.end());
+    for (auto& index: indices) {
+        index -= vertexOffset;
+    }
+
+    std::vector<MeshCacheMesh> meshes;
+    meshes.reserve(header.meshCount);
+    for (auto i = meshOffset; i < m_MeshBuffer.size(); ++i) {
+        const auto& mesh = m_MeshBuffer[i];
+        meshes.push_back(MeshCacheMesh{ addString(strings, mesh.m_sName), uint32_t(mesh.m_nIndexOffset - indexOffset), mesh.m_nIndexCount, mesh.m_nMaterialIndex });
+    }
+
+    std::vector<MeshCacheMaterial> materials(header.materialCount);
+    for (auto i = 0u; i < header.materialCount; ++i) {
+        const auto& m = m_Materials[materialOffset + i];
+        auto& material = materials[i];
+        for (auto j = 0u; j < 3u; ++j) {
+            material.ka[j] = m.m_Ka[j];
+            material.kd[j] = m.m_Kd[j];
+            material.ks[j] = m.m_Ks[j];
+            material.tr[j] = m.m_Tr[j];
+            material.le[j] = m.m_Le[j];
+        }
+        material.shininess = m.m_Shininess;
+        material.refractionIndex = m.m_RefractionIndex;
+        material.dissolve = m.m_Dissolve;
+        for (auto j = 0u; j < 4u; ++j) {
+            material.maps[j] = addString(strings, textureNames[4 * i + j]);
+        }
+    }
+    header.stringSize = strings.size();
+
+    // Written to a temporary file then renamed, so that an interrupted write never leaves a truncated cache
+    const std::string tmpPath = cachePath.str() + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        out.write((const char*)&header, sizeof(header));
+        out.write((const char*)(m_VertexBuffer.data() + vertexOffset), header.vertexCount * sizeof(Vertex));
+        out.write((const char*)indices.data(), indices.size() * sizeof(unsigned int));
+        out.write((const char*)meshes.data(), meshes.size() * sizeof(MeshCacheMesh));
+        out.write((const char*)materials.data(), materials.size() * sizeof(MeshCacheMaterial));
+        out.write((const char*)cachedLibraries.data(), cachedLibraries.size() * sizeof(MeshCacheLibrary));
+        out.write(strings.data(), strings.size());
+        if (out) {
+            out.close();
+        }
+        if (!out) {
+            std::clog << "Cannot write mesh cache " << cachePath << std::endl;
+            out.close();
+            std::error_code error;
+            std::filesystem::remove(tmpPath, error);
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tmpPath, cachePath.str(), error);
+    if (error) {
+        std::clog << "Cannot write mesh cache " << cachePath << ": " << error.message() << std::endl;
+        std::filesystem::remove(tmpPath, error);
+    }
+}
 }
@@ -1,45 +1,85 @@
 #include "glimac/Image.hpp"
+#include "glimac/PixelConversion.hpp"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include <iostream>
 
 namespace glimac {
 
-std::unique_ptr<Image> loadImage(const FilePath& filepath) {
+static void deleteBytes(unsigned char* bytes) {
+    delete [] bytes;
+}
+
+static void freeStbBytes(unsigned char* bytes) {
+    stbi_image_free(bytes);
+}
+
+Image::Image(unsigned int width, unsigned int height, PixelFormat format):
+    m_nWidth(width), m_nHeight(height), m_Format(format), m_Bytes(nullptr, nullptr) {
+    if(format == PixelFormat::RGBA8) {
+        m_Bytes = std::unique_ptr<unsigned char[], ByteDeleter>(new unsigned char[4 * width * height], &deleteBytes);
+    } else {
+        m_Pixels.reset(new glm::vec4[width * height]);
+    }
+}
+
+void Image::convert(PixelFormat format) {
+    if(format == m_Format) {
+        return;
+    }
+    unsigned int size = m_nWidth * m_nHeight;
+    if(format == PixelFormat::RGBA32F) {
+        m_Pixels.reset(new glm::vec4[size]);
+        convertU8ToF32(m_Bytes.get(), glm::value_ptr(m_Pixels[0]), 4 * size);
+        m_Bytes.reset();
+    } else {
+        m_Bytes = std::unique_ptr<unsigned char[], ByteDeleter>(new unsigned char[4 * size], &deleteBytes);
+        convertF32ToU8(glm::value_ptr(m_Pixels[0]), m_Bytes.get(), 4 * size);
+        m_Pixels.reset();
+    }
+    m_Format = format;
+}
+
+std::unique_ptr<Image> loadImage(const FilePath& filepath, PixelFormat format) {
+    // stb_image initialise paresseusement ses tables zlib: on le fait une fois pour que les chargements
+    // parallèles (AssetLoader) ne l'écrivent pas en même temps
+    static std::once_flag zlibTablesInitialized;
+    std::call_once(zlibTablesInitialized, &stbi__init_zdefaults);
+
     int x, y, n;
     unsigned char *data = stbi_load(filepath.c_str(), &x, &y, &n, 4);
     if(!data) {
         std::cerr << "loading image " << filepath << " error: " << stbi_failure_reason() << std::endl;
         return std::unique_ptr<Image>();
     }
-    std::unique_ptr<Image> pImage(new Image(x, y));
-    unsigned int size = x * y;
-    auto scale = 1.f / 255;
-    auto ptr = pImage->getPixels();
-    for(auto i = 0u; i < size; ++i) {
-        auto offset = 4 * i;
-        ptr->r = data[offset] * scale;
-        ptr->g = data[offset + 1] * scale;
-        ptr->b = data[offset + 2] * scale;
-        ptr->a = data[offset + 3] * scale;
-        ++ptr;
-    }
-    stbi_image_free(data);
+    // Le buffer de stb_image est adopté tel quel, la conversion en flottants n'a lieu que sur demande
+    std::unique_ptr<Image> pImage(new Image(x, y, data, &freeStbBytes));
+    pImage->convert(format);
     return pImage;
 }
 
+std::mutex ImageManager::m_Mutex;
 std::unordered_map<FilePath, std::unique_ptr<Image>> ImageManager::m_ImageMap;
 
 const Image* ImageManager::loadImage(const FilePath& filepath) {
-    auto it = m_ImageMap.find(filepath);
-    if(it != std::end(m_ImageMap)) {
-        return (*it).second.get();
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_ImageMap.find(filepath);
+        if(it != std::end(m_ImageMap)) {
+            return (*it).second.get();
+        }
     }
+    // Décodage hors du verrou pour que plusieurs images puissent être chargées en parallèle
     auto pImage = glimac::loadImage(filepath);
     if(!pImage) {
         return nullptr;
     }
-    auto& img = m_ImageMap[filepath] = std::move(pImage);
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    // Si un autre thread a chargé la même image entre temps, on garde la sienne
+    auto& img = m_ImageMap[filepath];
+    if(!img) {
+        img = std::move(pImage);
+    }
     return img.get();
 }
 
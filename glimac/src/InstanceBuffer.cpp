@@ -0,0 +1,118 @@
+#include "glimac/InstanceBuffer.hpp"
+#include "glimac/GLState.hpp"
+#include "glimac/RenderStats.hpp"
+#include <cstddef>
+
+namespace glimac {
+
+glm::mat4 segmentMatrix(glm::vec3 Pstart, glm::vec3 Pend) {
+    glm::vec3 direction = glm::normalize(Pend - Pstart);
+    glm::vec3 cylinderDirection = glm::vec3(0, 0, 1);
+
+    float angle = glm::radians(180.f); // set a 180 au cas ou parallele et opposés
+    glm::vec3 axis = glm::cross(cylinderDirection, direction); // axis around which to turn
+    if (glm::length(axis) > 0.01f)
+        angle = glm::acos(glm::dot(cylinderDirection, direction));
+    else{ // si les vecteurs sont paralleles
+        // si dans le meme sens, pas de changement
+        if (glm::dot(glm::normalize(cylinderDirection), glm::normalize(direction)) >= 0.f) angle = 0.f;
+        axis = glm::vec3(0, 1, 0); // on prend un axe qulconque a 90° de l'axe du cylindre (0,0,1)
+    }
+
+    glm::mat4 matrix = glm::translate(glm::mat4(1.f), Pstart); // move to start
+    matrix           = glm::rotate(matrix, angle, axis); // rotate towards end
+    matrix           = glm::scale(matrix, glm::vec3(1, 1, glm::length(Pend - Pstart))); // scale to length
+    return matrix;
+}
+
+InstanceBuffer::InstanceBuffer(const MeshBuffer& mesh):
+    m_pMesh(&mesh), m_nVertexCount(mesh.getVertexCount()), m_nIndexCount(mesh.getIndexCount()) {
+    glGenVertexArrays(1, &m_nVAO);
+    GLState::bindVertexArray(m_nVAO);
+
+    // Attributs de sommet: ceux du maillage
+    mesh.setupVertexAttributes();
+
+    // Attributs d'instance: une matrice occupe un emplacement par colonne
+    glGenBuffers(1, &m_nInstanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_nInstanceVBO);
+    for (GLuint i = 0; i < 4; ++i) {
+        glEnableVertexAttribArray(INSTANCE_ATTR_MODEL + i);
+        glVertexAttribPointer(INSTANCE_ATTR_MODEL + i, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (const GLvoid*)(offsetof(InstanceData, model) + i * sizeof(glm::vec4)));
+        glVertexAttribDivisor(INSTANCE_ATTR_MODEL + i, 1);
+    }
+    for (GLuint i = 0; i < 3; ++i) {
+        glEnableVertexAttribArray(INSTANCE_ATTR_NORMAL + i);
+        glVertexAttribPointer(INSTANCE_ATTR_NORMAL + i, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (const GLvoid*)(offsetof(InstanceData, normal) + i * sizeof(glm::vec3)));
+        glVertexAttribDivisor(INSTANCE_ATTR_NORMAL + i, 1);
+    }
+    glEnableVertexAttribArray(INSTANCE_ATTR_COLOR);
+    glVertexAttribPointer(INSTANCE_ATTR_COLOR, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (const GLvoid*)offsetof(InstanceData, color));
+    glVertexAttribDivisor(INSTANCE_ATTR_COLOR, 1);
+
+    GLState::bindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+InstanceBuffer::~InstanceBuffer() {
+    release();
+}
+
+InstanceBuffer::InstanceBuffer(InstanceBuffer&& rvalue):
+    m_pMesh(rvalue.m_pMesh), m_nVAO(rvalue.m_nVAO), m_nInstanceVBO(rvalue.m_nInstanceVBO),
+    m_nVertexCount(rvalue.m_nVertexCount), m_nIndexCount(rvalue.m_nIndexCount),
+    m_nInstanceCount(rvalue.m_nInstanceCount), m_nUploadedBytes(rvalue.m_nUploadedBytes) {
+    rvalue.m_nVAO = 0;
+    rvalue.m_nInstanceVBO = 0;
+    rvalue.m_nInstanceCount = 0;
+}
+
+InstanceBuffer& InstanceBuffer::operator =(InstanceBuffer&& rvalue) {
+    if (this != &rvalue) {
+        release();
+        m_pMesh = rvalue.m_pMesh;
+        m_nVAO = rvalue.m_nVAO;
+        m_nInstanceVBO = rvalue.m_nInstanceVBO;
+        m_nVertexCount = rvalue.m_nVertexCount;
+        m_nIndexCount = rvalue.m_nIndexCount;
+        m_nInstanceCount = rvalue.m_nInstanceCount;
+        m_nUploadedBytes = rvalue.m_nUploadedBytes;
+        rvalue.m_nVAO = 0;
+        rvalue.m_nInstanceVBO = 0;
+        rvalue.m_nInstanceCount = 0;
+    }
+    return *this;
+}
+
+void InstanceBuffer::release() {
+    GLState::deleteVertexArray(m_nVAO);
+    glDeleteBuffers(1, &m_nInstanceVBO);
+    m_nVAO = m_nInstanceVBO = 0;
+}
+
+void InstanceBuffer::upload(const std::vector<InstanceData>& instances) {
+    glBindBuffer(GL_ARRAY_BUFFER, m_nInstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(InstanceData), instances.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_nInstanceCount = instances.size();
+    m_nUploadedBytes += instances.size() * sizeof(InstanceData);
+    RenderStats::addUpload(instances.size() * sizeof(InstanceData));
+}
+
+void InstanceBuffer::draw() const {
+    if (m_nInstanceCount == 0) {
+        return;
+    }
+    RenderStats::addDraw(size_t((m_nIndexCount > 0 ? m_nIndexCount : m_nVertexCount) / 3) * m_nInstanceCount);
+    m_pMesh->setDecodeAttributes();
+    GLState::bindVertexArray(m_nVAO);
+    if (m_nIndexCount > 0) {
+        glDrawElementsInstanced(GL_TRIANGLES, m_nIndexCount, GL_UNSIGNED_INT, 0, m_nInstanceCount);
+    }
+    else {
+        glDrawArraysInstanced(GL_TRIANGLES, 0, m_nVertexCount, m_nInstanceCount);
+    }
+}
+
+}
@@ -0,0 +1,111 @@
+#include "glimac/LightClusters.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace glimac {
+
+LightClusters::LightClusters(unsigned tilesX, unsigned tilesY, unsigned slices):
+    m_nTilesX(std::max(tilesX, 1u)), m_nTilesY(std::max(tilesY, 1u)), m_nSlices(std::max(slices, 1u)),
+    m_Clusters(size_t(m_nTilesX) * m_nTilesY * m_nSlices, Cluster{ 0, 0 }) {
+    setProjection(glm::perspective(1.f, 1.f, m_fNear, m_fFar), m_fNear, m_fFar);
+}
+
+void LightClusters::setProjection(const glm::mat4& projMatrix, float zNear, float zFar) {
+    // point (x, y, -profondeur): clip.x = P[0][0] x - P[2][0] profondeur, clip.w = profondeur
+    m_Projection = glm::vec4(projMatrix[0][0], projMatrix[1][1], projMatrix[2][0], projMatrix[2][1]);
+    m_fNear = zNear;
+    m_fFar = zFar;
+    m_fSliceScale = m_nSlices / std::log(zFar / zNear);
+    m_fSliceBias = -std::log(zNear) * m_fSliceScale;
+}
+
+unsigned LightClusters::getSlice(float depth) const {
+    float slice = std::floor(std::log(std::max(depth, m_fNear)) * m_fSliceScale + m_fSliceBias);
+    return unsigned(glm::clamp(slice, 0.f, float(m_nSlices - 1)));
+}
+
+// Tuile contenant une coordonnée normalisée [-1, 1], bornée à [0, tiles - 1]
+static unsigned getTile(float ndc, unsigned tiles) {
+    float tile = std::floor((ndc * 0.5f + 0.5f) * tiles);
+    return unsigned(glm::clamp(tile, 0.f, float(tiles - 1)));
+}
+
+LightClusters::ClusterRange LightClusters::computeRange(const glm::vec4& light) const {
+    ClusterRange range = {};
+    float depth = -light.z;
+    float radius = light.w;
+    float nearDepth = depth - radius;
+    float farDepth = depth + radius;
+    if (farDepth < m_fNear || nearDepth > m_fFar) {
+        range.empty = true;
+        return range;
+    }
+    // Seule la partie devant le plan proche est dessinée
+    nearDepth = std::max(nearDepth, m_fNear);
+    farDepth = std::min(farDepth, m_fFar);
+
+    // x / profondeur est extrême aux coins de la boîte englobante: au plus près pour les grands |x|,
+    // au plus loin pour les petits
+    float minX = std::min((light.x - radius) / nearDepth, (light.x - radius) / farDepth);
+    float maxX = std::max((light.x + radius) / nearDepth, (light.x + radius) / farDepth);
+    float minY = std::min((light.y - radius) / nearDepth, (light.y - radius) / farDepth);
+    float maxY = std::max((light.y + radius) / nearDepth, (light.y + radius) / farDepth);
+
+    range.minX = getTile(m_Projection.x * minX - m_Projection.z, m_nTilesX);
+    range.maxX = getTile(m_Projection.x * maxX - m_Projection.z, m_nTilesX);
+    range.minY = getTile(m_Projection.y * minY - m_Projection.w, m_nTilesY);
+    range.maxY = getTile(m_Projection.y * maxY - m_Projection.w, m_nTilesY);
+    range.minSlice = getSlice(nearDepth);
+    range.maxSlice = getSlice(farDepth);
+    range.empty = false;
+    return range;
+}
+
+void LightClusters::build(const glm::vec4* lights, size_t count) {
+    // 1er passage: nombre de lumières par cluster
+    for (auto& cluster : m_Clusters) {
+        cluster.count = 0;
+    }
+    m_Ranges.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const ClusterRange range = m_Ranges[i] = computeRange(lights[i]);
+        if (range.empty) {
+            continue;
+        }
+        for (unsigned z = range.minSlice; z <= range.maxSlice; ++z) {
+            for (unsigned y = range.minY; y <= range.maxY; ++y) {
+                Cluster* row = &m_Clusters[getClusterIndex(0, y, z)];
+                for (unsigned x = range.minX; x <= range.maxX; ++x) {
+                    ++row[x].count;
+                }
+            }
+        }
+    }
+
+    // Début de chaque cluster dans la liste d'indices
+    uint32_t offset = 0;
+    for (auto& cluster : m_Clusters) {
+        cluster.offset = offset;
+        offset += cluster.count;
+        cluster.count = 0;
+    }
+    m_LightIndices.resize(offset);
+
+    // 2e passage: indices des lumières, dans l'ordre croissant pour chaque cluster
+    for (size_t i = 0; i < count; ++i) {
+        const ClusterRange& range = m_Ranges[i];
+        if (range.empty) {
+            continue;
+        }
+        for (unsigned z = range.minSlice; z <= range.maxSlice; ++z) {
+            for (unsigned y = range.minY; y <= range.maxY; ++y) {
+                Cluster* row = &m_Clusters[getClusterIndex(0, y, z)];
+                for (unsigned x = range.minX; x <= range.maxX; ++x) {
+                    m_LightIndices[row[x].offset + row[x].count++] = uint32_t(i);
+                }
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,108 @@
+#include "glimac/MappedFile.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace glimac {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& filepath) {
+    close();
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    m_hFile = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        close();
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        return true;
+    }
+    m_hMapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!m_hMapping) {
+        close();
+        return false;
+    }
+    m_pData = (const char*)MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!m_pData) {
+        close();
+        return false;
+    }
+    m_nSize = (size_t)size.QuadPart;
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_pData) {
+        UnmapViewOfFile(m_pData);
+    }
+    if (m_hMapping) {
+        CloseHandle(m_hMapping);
+    }
+    if (m_hFile) {
+        CloseHandle(m_hFile);
+    }
+    m_pData = nullptr;
+    m_nSize = 0;
+    m_hFile = m_hMapping = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& filepath) {
+    close();
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    if (st.st_size == 0) {
+        ::close(fd);
+        return true;
+    }
+    // Le descripteur peut être fermé dès que la projection existe
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+#ifdef MADV_SEQUENTIAL
+    madvise(data, st.st_size, MADV_SEQUENTIAL);
+#endif
+    m_pData = (const char*)data;
+    m_nSize = st.st_size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_pData) {
+        munmap((void*)m_pData, m_nSize);
+    }
+    m_pData = nullptr;
+    m_nSize = 0;
+}
+
+#endif
+
+}
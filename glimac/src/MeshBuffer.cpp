@@ -0,0 +1,271 @@
+#include "glimac/MeshBuffer.hpp"
+#include "glimac/GLState.hpp"
+#include "glimac/RenderStats.hpp"
+#include <cstddef>
+#include <stdexcept>
+
+namespace glimac {
+
+static_assert(sizeof(Geometry::Vertex) == sizeof(ShapeVertex), "Geometry::Vertex and ShapeVertex must share the same layout");
+static_assert(offsetof(Geometry::Vertex, m_Normal) == offsetof(ShapeVertex, normal), "Geometry::Vertex and ShapeVertex must share the same layout");
+static_assert(offsetof(Geometry::Vertex, m_TexCoords) == offsetof(ShapeVertex, texCoords), "Geometry::Vertex and ShapeVertex must share the same layout");
+
+MeshBuffer::MeshBuffer(const ShapeVertex* vertices, GLsizei vertexCount, const unsigned int* indices, GLsizei indexCount, VertexFormat format):
+    m_nVertexCount(vertexCount), m_nIndexCount(indexCount), m_Format(format) {
+    glGenBuffers(1, &m_nVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_nVBO);
+    if (format == VertexFormat::Packed) {
+        auto packed = packVertices(vertices, vertexCount, m_Bounds);
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(PackedVertex), packed.data(), GL_STATIC_DRAW);
+    }
+    else {
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(ShapeVertex), vertices, GL_STATIC_DRAW);
+    }
+    m_nUploadedBytes += vertexCount * getVertexSize();
+    RenderStats::addUpload(vertexCount * getVertexSize());
+
+    createVertexArray(indices);
+}
+
+MeshBuffer::MeshBuffer(const glm::vec3* positions, const glm::vec3* normals, const glm::vec2* texCoords, GLsizei vertexCount,
+                       const unsigned int* indices, GLsizei indexCount):
+    m_nVertexCount(vertexCount), m_nIndexCount(indexCount) {
+    GLuint vbos[3];
+    glGenBuffers(3, vbos);
+    m_nVBO = vbos[0];
+    m_nNormalVBO = vbos[1];
+    m_nTexCoordsVBO = vbos[2];
+    glBindBuffer(GL_ARRAY_BUFFER, m_nVBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(glm::vec3), positions, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, m_nNormalVBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(glm::vec3), normals, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, m_nTexCoordsVBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(glm::vec2), texCoords, GL_STATIC_DRAW);
+    m_nUploadedBytes += vertexCount * getVertexSize();
+    RenderStats::addUpload(vertexCount * getVertexSize());
+
+    createVertexArray(indices);
+}
+
+void MeshBuffer::createVertexArray(const unsigned int* indices) {
+    // binder l'IBO modifierait le VAO laissé bindé par le dernier draw
+    GLState::bindVertexArray(0);
+    if (indices && m_nIndexCount > 0) {
+        glGenBuffers(1, &m_nIBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_nIBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_nIndexCount * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+        m_nUploadedBytes += m_nIndexCount * sizeof(unsigned int);
+        RenderStats::addUpload(m_nIndexCount * sizeof(unsigned int));
+    }
+    else {
+        m_nIndexCount = 0;
+    }
+
+    // L'IBO reste attaché au VAO: il ne faut pas le débinder avant le VAO
+    glGenVertexArrays(1, &m_nVAO);
+    GLState::bindVertexArray(m_nVAO);
+    setupVertexAttributes();
+
+    GLState::bindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void MeshBuffer::setupVertexAttributes() const {
+    glBindBuffer(GL_ARRAY_BUFFER, m_nVBO);
+    glEnableVertexAttribArray(VERTEX_ATTR_POSITION);
+    glEnableVertexAttribArray(VERTEX_ATTR_NORMAL);
+    glEnableVertexAttribArray(VERTEX_ATTR_TEXCOORDS);
+    if (m_nNormalVBO) {
+        // Attributs dans des VBO séparés: chaque pointeur est lu depuis le VBO bindé au moment de l'appel
+        glVertexAttribPointer(VERTEX_ATTR_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), 0);
+        glBindBuffer(GL_ARRAY_BUFFER, m_nNormalVBO);
+        glVertexAttribPointer(VERTEX_ATTR_NORMAL, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), 0);
+        glBindBuffer(GL_ARRAY_BUFFER, m_nTexCoordsVBO);
+        glVertexAttribPointer(VERTEX_ATTR_TEXCOORDS, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), 0);
+    }
+    else if (m_Format == VertexFormat::Packed) {
+        // Les entiers normalisés arrivent dans le shader dans [0, 1] (position) et [-1, 1] (normale)
+        glVertexAttribPointer(VERTEX_ATTR_POSITION, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (const GLvoid*)offsetof(PackedVertex, position));
+        glVertexAttribPointer(VERTEX_ATTR_NORMAL, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (const GLvoid*)offsetof(PackedVertex, normal));
+        glVertexAttribPointer(VERTEX_ATTR_TEXCOORDS, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (const GLvoid*)offsetof(PackedVertex, texCoords));
+    }
+    else {
+        glVertexAttribPointer(VERTEX_ATTR_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(ShapeVertex), (const GLvoid*)offsetof(ShapeVertex, position));
+        glVertexAttribPointer(VERTEX_ATTR_NORMAL, 3, GL_FLOAT, GL_FALSE, sizeof(ShapeVertex), (const GLvoid*)offsetof(ShapeVertex, normal));
+        glVertexAttribPointer(VERTEX_ATTR_TEXCOORDS, 2, GL_FLOAT, GL_FALSE, sizeof(ShapeVertex), (const GLvoid*)offsetof(ShapeVertex, texCoords));
+    }
+    if (m_nIBO) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_nIBO);
+    }
+}
+
+void MeshBuffer::setDecodeAttributes() const {
+    if (m_Format == VertexFormat::Packed) {
+        glm::vec3 size = m_Bounds.size();
+        glVertexAttrib4f(VERTEX_ATTR_POSITION_SCALE, size.x, size.y, size.z, 1.f);
+        glVertexAttrib3f(VERTEX_ATTR_POSITION_OFFSET, m_Bounds.lower.x, m_Bounds.lower.y, m_Bounds.lower.z);
+    }
+    else {
+        glVertexAttrib4f(VERTEX_ATTR_POSITION_SCALE, 1.f, 1.f, 1.f, 0.f);
+        glVertexAttrib3f(VERTEX_ATTR_POSITION_OFFSET, 0.f, 0.f, 0.f);
+    }
+}
+
+MeshBuffer::~MeshBuffer() {
+    release();
+}
+
+MeshBuffer::MeshBuffer(MeshBuffer&& rvalue):
+    m_nVBO(rvalue.m_nVBO), m_nNormalVBO(rvalue.m_nNormalVBO), m_nTexCoordsVBO(rvalue.m_nTexCoordsVBO), m_nIBO(rvalue.m_nIBO), m_nVAO(rvalue.m_nVAO),
+    m_nVertexCount(rvalue.m_nVertexCount), m_nIndexCount(rvalue.m_nIndexCount), m_nUploadedBytes(rvalue.m_nUploadedBytes),
+    m_Format(rvalue.m_Format), m_Bounds(rvalue.m_Bounds) {
+    rvalue.m_nVBO = 0;
+    rvalue.m_nNormalVBO = 0;
+    rvalue.m_nTexCoordsVBO = 0;
+    rvalue.m_nIBO = 0;
+    rvalue.m_nVAO = 0;
+}
+
+MeshBuffer& MeshBuffer::operator =(MeshBuffer&& rvalue) {
+    if (this != &rvalue) {
+        release();
+        m_nVBO = rvalue.m_nVBO;
+        m_nNormalVBO = rvalue.m_nNormalVBO;
+        m_nTexCoordsVBO = rvalue.m_nTexCoordsVBO;
+        m_nIBO = rvalue.m_nIBO;
+        m_nVAO = rvalue.m_nVAO;
+        m_nVertexCount = rvalue.m_nVertexCount;
+        m_nIndexCount = rvalue.m_nIndexCount;
+        m_nUploadedBytes = rvalue.m_nUploadedBytes;
+        m_Format = rvalue.m_Format;
+        m_Bounds = rvalue.m_Bounds;
+        rvalue.m_nVBO = 0;
+        rvalue.m_nNormalVBO = 0;
+        rvalue.m_nTexCoordsVBO = 0;
+        rvalue.m_nIBO = 0;
+        rvalue.m_nVAO = 0;
+    }
+    return *this;
+}
+
+void MeshBuffer::release() {
+    // glDelete* ignore silencieusement les noms nuls
+    GLState::deleteVertexArray(m_nVAO);
+    glDeleteBuffers(1, &m_nVBO);
+    glDeleteBuffers(1, &m_nNormalVBO);
+    glDeleteBuffers(1, &m_nTexCoordsVBO);
+    glDeleteBuffers(1, &m_nIBO);
+    m_nVAO = m_nVBO = m_nNormalVBO = m_nTexCoordsVBO = m_nIBO = 0;
+}
+
+void MeshBuffer::draw() const {
+    RenderStats::addDraw(getTriangleCount());
+    setDecodeAttributes();
+    // le VAO reste bindé: deux draws successifs du même maillage ne le rebindent pas
+    GLState::bindVertexArray(m_nVAO);
+    if (m_nIndexCount > 0) {
+        glDrawElements(GL_TRIANGLES, m_nIndexCount, GL_UNSIGNED_INT, 0);
+    }
+    else {
+        glDrawArrays(GL_TRIANGLES, 0, m_nVertexCount);
+    }
+}
+
+const MeshBuffer& MeshRegistry::add(const std::string& name, const Sphere& sphere) {
+    return insert(name, std::unique_ptr<MeshBuffer>(new MeshBuffer(sphere.getIndexedDataPointer(), sphere.getIndexedVertexCount(), sphere.getIndexPointer(), sphere.getIndexCount())));
+}
+
+const MeshBuffer& MeshRegistry::add(const std::string& name, const Cylindre& cylindre) {
+    return insert(name, std::unique_ptr<MeshBuffer>(new MeshBuffer(cylindre.getIndexedDataPointer(), cylindre.getIndexedVertexCount(), cylindre.getIndexPointer(), cylindre.getIndexCount())));
+}
+
+const MeshBuffer& MeshRegistry::add(const std::string& name, const Geometry& geometry, VertexFormat format) {
+    if (geometry.getVertexStorage() == VertexStorage::SoA) {
+        auto positions = geometry.getPositions();
+        auto normals = geometry.getNormals();
+        auto texCoords = geometry.getTexCoords();
+        if (format == VertexFormat::Float) {
+            // Les flux SoA sont contigus: envoyés tels quels, sans copie intermédiaire
+            return insert(name, std::unique_ptr<MeshBuffer>(new MeshBuffer(positions.m_pData, normals.m_pData, texCoords.m_pData, geometry.getVertexCount(),
+                                                                           geometry.getIndexBuffer(), geometry.getIndexCount())));
+        }
+        // La compression travaille sur des sommets entrelacés
+        std::vector<ShapeVertex> vertices(geometry.getVertexCount());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            vertices[i] = ShapeVertex{ positions[i], normals[i], texCoords[i] };
+        }
+        return add(name, vertices, std::vector<unsigned int>(geometry.getIndexBuffer(), geometry.getIndexBuffer() + geometry.getIndexCount()), format);
+    }
+    auto vertices = reinterpret_cast<const ShapeVertex*>(geometry.getVertexBuffer());
+    return insert(name, std::unique_ptr<MeshBuffer>(new MeshBuffer(vertices, geometry.getVertexCount(), geometry.getIndexBuffer(), geometry.getIndexCount(), format)));
+}
+
+const MeshBuffer& MeshRegistry::add(const std::string& name, const std::vector<ShapeVertex>& vertices, const std::vector<unsigned int>& indices, VertexFormat format) {
+    return insert(name, std::unique_ptr<MeshBuffer>(new MeshBuffer(vertices.data(), vertices.size(), indices.data(), indices.size(), format)));
+}
+
+const MeshLOD& MeshRegistry::addLOD(const std::string& name, const std::vector<Sphere>& levels, std::vector<float> minScreenSizes) {
+    return insertLOD(name, levels, std::move(minScreenSizes), levels.empty() ? 0.f : levels.front().getRadius());
+}
+
+const MeshLOD& MeshRegistry::addLOD(const std::string& name, const std::vector<Cylindre>& levels, std::vector<float> minScreenSizes) {
+    return insertLOD(name, levels, std::move(minScreenSizes), levels.empty() ? 0.f : levels.front().getBoundingRadius());
+}
+
+template<typename Shape>
+const MeshLOD& MeshRegistry::insertLOD(const std::string& name, const std::vector<Shape>& levels, std::vector<float> minScreenSizes, float boundingRadius) {
+    // Vérifié avant d'envoyer les niveaux au GPU
+    if (m_LODMap.count(name)) {
+        throw std::invalid_argument("Mesh LOD " + name + " is already registered");
+    }
+    std::vector<const MeshBuffer*> buffers;
+    for (size_t i = 0; i < levels.size(); ++i) {
+        buffers.push_back(&add(name + "#" + std::to_string(i), levels[i]));
+    }
+    auto& slot = m_LODMap[name] = std::unique_ptr<MeshLOD>(new MeshLOD(std::move(buffers), std::move(minScreenSizes), boundingRadius));
+    return *slot;
+}
+
+const MeshBuffer& MeshRegistry::insert(const std::string& name, std::unique_ptr<MeshBuffer> mesh) {
+    auto& slot = m_MeshMap[name];
+    if (slot) {
+        // Le maillage en place est peut-être encore référencé: il n'est pas remplacé
+        throw std::invalid_argument("Mesh " + name + " is already registered");
+    }
+    m_nUploadedBytes += mesh->getUploadedBytes();
+    m_nUnpackedBytes += mesh->getUnpackedBytes();
+    slot = std::move(mesh);
+    return *slot;
+}
+
+const MeshBuffer* MeshRegistry::find(const std::string& name) const {
+    auto it = m_MeshMap.find(name);
+    if (it == std::end(m_MeshMap)) {
+        return nullptr;
+    }
+    return (*it).second.get();
+}
+
+const MeshBuffer& MeshRegistry::get(const std::string& name) const {
+    auto pMesh = find(name);
+    if (!pMesh) {
+        throw std::runtime_error("Unknown mesh " + name);
+    }
+    return *pMesh;
+}
+
+const MeshLOD& MeshRegistry::getLOD(const std::string& name) const {
+    auto it = m_LODMap.find(name);
+    if (it == std::end(m_LODMap)) {
+        throw std::runtime_error("Unknown mesh LOD " + name);
+    }
+    return *(*it).second;
+}
+
+void MeshRegistry::clear() {
+    m_LODMap.clear();
+    m_MeshMap.clear();
+}
+
+}
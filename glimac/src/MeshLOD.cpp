@@ -0,0 +1,45 @@
+#include "glimac/MeshLOD.hpp"
+#include "glimac/MeshBuffer.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace glimac {
+
+MeshLOD::MeshLOD(std::vector<const MeshBuffer*> levels, std::vector<float> minScreenSizes, float boundingRadius):
+    m_Levels(std::move(levels)), m_MinScreenSizes(std::move(minScreenSizes)), m_fBoundingRadius(boundingRadius) {
+    if (m_Levels.empty()) {
+        throw std::invalid_argument("MeshLOD needs at least one level");
+    }
+    // Un seuil par niveau sauf le dernier
+    m_MinScreenSizes.resize(m_Levels.size() - 1, 0.f);
+}
+
+size_t MeshLOD::selectLevel(float screenSize) const {
+    for (size_t i = 0; i < m_MinScreenSizes.size(); ++i) {
+        if (screenSize >= m_MinScreenSizes[i]) {
+            return i;
+        }
+    }
+    return m_Levels.size() - 1;
+}
+
+std::vector<float> MeshLOD::getDefaultScreenSizes() {
+    return std::vector<float>{ 160.f, 64.f, 24.f };
+}
+
+float computeScreenSize(float radius, float distance, const glm::mat4& projMatrix, float viewportHeight) {
+    // La caméra est dans la sphère: le niveau le plus fin
+    if (distance <= radius) {
+        return std::numeric_limits<float>::max();
+    }
+    // projMatrix[1][1] = cotan(fovy / 2): passage d'une hauteur en repère vue à une hauteur en NDC ([-1, 1])
+    return radius * projMatrix[1][1] / distance * viewportHeight;
+}
+
+float computeScreenSize(float radius, const glm::mat4& MVMatrix, const glm::mat4& projMatrix, float viewportHeight) {
+    float scale = std::max(glm::length(glm::vec3(MVMatrix[0])), std::max(glm::length(glm::vec3(MVMatrix[1])), glm::length(glm::vec3(MVMatrix[2]))));
+    return computeScreenSize(radius * scale, glm::length(glm::vec3(MVMatrix[3])), projMatrix, viewportHeight);
+}
+
+}
@@ -0,0 +1,185 @@
+#include "glimac/MeshOptimizer.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace glimac {
+
+VertexCacheStats simulateVertexCache(const unsigned int* indices, size_t indexCount, size_t cacheSize) {
+    VertexCacheStats stats;
+    stats.triangles = indexCount / 3;
+
+    // Petit buffer circulaire: une recherche linéaire est plus rapide qu'une table pour 16 à 32 entrées
+    std::vector<unsigned int> cache(cacheSize, std::numeric_limits<unsigned int>::max());
+    size_t next = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        if (std::find(cache.begin(), cache.end(), indices[i]) == cache.end()) {
+            cache[next] = indices[i];
+            next = (next + 1) % cacheSize;
+            ++stats.misses;
+        }
+    }
+
+    if (indexCount > 0) {
+        auto bounds = std::minmax_element(indices, indices + indexCount);
+        std::vector<bool> used(*bounds.second - *bounds.first + 1, false);
+        for (size_t i = 0; i < indexCount; ++i) {
+            if (!used[indices[i] - *bounds.first]) {
+                used[indices[i] - *bounds.first] = true;
+                ++stats.vertices;
+            }
+        }
+    }
+
+    return stats;
+}
+
+namespace {
+
+// Etat de Tipsify, les sommets étant numérotés à partir de 0
+class Tipsify {
+public:
+    Tipsify(const unsigned int* indices, size_t indexCount, unsigned int vertexCount, size_t cacheSize):
+        m_pIndices(indices), m_nTriangleCount(indexCount / 3), m_nCacheSize(cacheSize),
+        m_LiveTriangles(vertexCount, 0), m_AdjacencyOffsets(vertexCount + 1, 0),
+        m_CacheTime(vertexCount, 0), m_Emitted(m_nTriangleCount, false) {
+        // Triangles adjacents à chaque sommet, stockés à plat (un sommet répété compte plusieurs fois)
+        for (size_t i = 0; i < 3 * m_nTriangleCount; ++i) {
+            ++m_LiveTriangles[indices[i]];
+        }
+        for (unsigned int v = 0; v < vertexCount; ++v) {
+            m_AdjacencyOffsets[v + 1] = m_AdjacencyOffsets[v] + m_LiveTriangles[v];
+        }
+        m_Adjacency.resize(3 * m_nTriangleCount);
+        std::vector<unsigned int> fill(m_AdjacencyOffsets.begin(), m_AdjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < 3 * m_nTriangleCount; ++i) {
+            m_Adjacency[fill[indices[i]]++] = i / 3;
+        }
+    }
+
+    void run(unsigned int* output) {
+        size_t timestamp = m_nCacheSize + 1;
+        size_t cursor = 0;
+        int fanning = 0;
+        std::vector<unsigned int> candidates;
+
+        while (fanning >= 0) {
+            candidates.clear();
+            for (auto a = m_AdjacencyOffsets[fanning]; a < m_AdjacencyOffsets[fanning + 1]; ++a) {
+                auto t = m_Adjacency[a];
+                if (m_Emitted[t]) {
+                    continue;
+                }
+                for (auto k = 0u; k < 3u; ++k) {
+                    auto v = m_pIndices[3 * t + k];
+                    *output++ = v;
+                    m_DeadEnds.push_back(v);
+                    candidates.push_back(v);
+                    --m_LiveTriangles[v];
+                    if (timestamp - m_CacheTime[v] > m_nCacheSize) {
+                        m_CacheTime[v] = timestamp++;
+                    }
+                }
+                m_Emitted[t] = true;
+            }
+            fanning = nextVertex(candidates, timestamp, cursor);
+        }
+    }
+
+private:
+    // Parmi les sommets des triangles émis, celui qui sera encore dans le cache une fois tous
+    // ses triangles restants émis, le plus ancien d'abord
+    int nextVertex(const std::vector<unsigned int>& candidates, size_t timestamp, size_t& cursor) {
+        int best = -1;
+        long bestPriority = -1;
+        for (auto v: candidates) {
+            if (m_LiveTriangles[v] == 0) {
+                continue;
+            }
+            long priority = 0;
+            if (timestamp - m_CacheTime[v] + 2 * m_LiveTriangles[v] <= m_nCacheSize) {
+                priority = timestamp - m_CacheTime[v];
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                best = v;
+            }
+        }
+        if (best == -1) {
+            best = skipDeadEnd(cursor);
+        }
+        return best;
+    }
+
+    // Revient à un sommet récemment utilisé, sinon au premier sommet ayant encore des triangles
+    int skipDeadEnd(size_t& cursor) {
+        while (!m_DeadEnds.empty()) {
+            auto v = m_DeadEnds.back();
+            m_DeadEnds.pop_back();
+            if (m_LiveTriangles[v] > 0) {
+                return v;
+            }
+        }
+        for (; cursor < m_LiveTriangles.size(); ++cursor) {
+            if (m_LiveTriangles[cursor] > 0) {
+                return cursor;
+            }
+        }
+        return -1;
+    }
+
+    const unsigned int* m_pIndices;
+    size_t m_nTriangleCount;
+    size_t m_nCacheSize;
+    std::vector<unsigned int> m_LiveTriangles;
+    std::vector<unsigned int> m_AdjacencyOffsets;
+    std::vector<unsigned int> m_Adjacency;
+    std::vector<size_t> m_CacheTime;
+    std::vector<bool> m_Emitted;
+    std::vector<unsigned int> m_DeadEnds;
+};
+
+}
+
+void optimizeVertexCache(unsigned int* indices, size_t indexCount, size_t cacheSize) {
+    indexCount -= indexCount % 3;
+    if (indexCount == 0) {
+        return;
+    }
+
+    // Tipsify travaille sur des sommets numérotés à partir de 0
+    auto bounds = std::minmax_element(indices, indices + indexCount);
+    auto firstVertex = *bounds.first;
+    std::vector<unsigned int> local(indices, indices + indexCount);
+    for (auto& index: local) {
+        index -= firstVertex;
+    }
+
+    Tipsify(local.data(), indexCount, *bounds.second - firstVertex + 1, cacheSize).run(indices);
+
+    for (size_t i = 0; i < indexCount; ++i) {
+        indices[i] += firstVertex;
+    }
+}
+
+std::vector<unsigned int> optimizeVertexFetch(unsigned int* indices, size_t indexCount, unsigned int firstVertex, size_t vertexCount) {
+    const auto unused = std::numeric_limits<unsigned int>::max();
+    std::vector<unsigned int> remap(vertexCount, unused);
+
+    unsigned int next = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        auto& target = remap[indices[i] - firstVertex];
+        if (target == unused) {
+            target = next++;
+        }
+        indices[i] = firstVertex + target;
+    }
+    for (auto& target: remap) {
+        if (target == unused) {
+            target = next++;
+        }
+    }
+
+    return remap;
+}
+
+}
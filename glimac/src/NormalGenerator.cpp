@@ -0,0 +1,191 @@
+#include "glimac/NormalGenerator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <future>
+
+namespace glimac {
+
+namespace {
+
+// En dessous, le coût de lancement d'une tâche dépasse celui du travail
+const size_t MIN_ITEMS_PER_TASK = 16384;
+
+// Deux normales de coin plus proches que ça partagent le même sommet
+const float SAME_NORMAL_DOT = 0.9999f;
+
+size_t getTaskCount(const ThreadPool& pool, size_t itemCount) {
+    return std::max<size_t>(1, std::min<size_t>(pool.getThreadCount(), itemCount / MIN_ITEMS_PER_TASK));
+}
+
+// Découpe [0, itemCount) en taskCount intervalles traités par function(task, begin, end), puis attend la fin
+template<typename Function>
+void parallelFor(ThreadPool& pool, size_t taskCount, size_t itemCount, const Function& function) {
+    if (taskCount <= 1) {
+        function(size_t(0), size_t(0), itemCount);
+        return;
+    }
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(taskCount);
+    for (size_t task = 0; task < taskCount; ++task) {
+        size_t begin = itemCount * task / taskCount;
+        size_t end = itemCount * (task + 1) / taskCount;
+        tasks.push_back(pool.submit([&function, task, begin, end]() { function(task, begin, end); }));
+    }
+    for (auto& task: tasks) {
+        task.get();
+    }
+}
+
+// Contribution d'un triangle à chacun de ses coins: sa normale, de longueur deux fois son aire, multipliée
+// par l'angle du coin. L'angle entre deux arêtes vaut atan2(|a x b|, a.b) et |a x b| est le même pour les
+// trois coins. Renvoit false pour un triangle dégénéré
+bool getCornerContributions(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, glm::vec3 contributions[3]) {
+    glm::vec3 e01 = p1 - p0;
+    glm::vec3 e12 = p2 - p1;
+    glm::vec3 e20 = p0 - p2;
+    glm::vec3 n = glm::cross(e01, -e20);
+    float doubleArea = glm::length(n);
+    if (!(doubleArea > 0.f)) {
+        return false;
+    }
+    contributions[0] = n * std::atan2(doubleArea, -glm::dot(e01, e20));
+    contributions[1] = n * std::atan2(doubleArea, -glm::dot(e12, e01));
+    contributions[2] = n * std::atan2(doubleArea, -glm::dot(e20, e12));
+    return true;
+}
+
+// Sans pli: chaque tâche accumule ses triangles dans son propre buffer, puis les buffers sont sommés par sommet
+void generateWithoutCreases(const unsigned int* indices, size_t indexCount, VertexStream<const glm::vec3> positions,
+                            VertexStream<glm::vec3> normals, unsigned int firstVertex, size_t vertexCount, ThreadPool& pool) {
+    const size_t triangleCount = indexCount / 3;
+    const size_t taskCount = getTaskCount(pool, triangleCount);
+    std::vector<std::vector<glm::vec3>> sums(taskCount);
+
+    parallelFor(pool, taskCount, triangleCount, [&](size_t task, size_t begin, size_t end) {
+        auto& sum = sums[task];
+        sum.assign(vertexCount, glm::vec3(0.f));
+        glm::vec3 contributions[3];
+        for (size_t t = begin; t < end; ++t) {
+            const unsigned int* corner = indices + 3 * t;
+            if (getCornerContributions(positions[corner[0]], positions[corner[1]], positions[corner[2]], contributions)) {
+                for (auto k = 0u; k < 3; ++k) {
+                    sum[corner[k] - firstVertex] += contributions[k];
+                }
+            }
+        }
+    });
+
+    parallelFor(pool, getTaskCount(pool, vertexCount), vertexCount, [&](size_t, size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            glm::vec3 n = sums[0][v];
+            for (size_t task = 1; task < taskCount; ++task) {
+                n += sums[task][v];
+            }
+            if (glm::dot(n, n) > 0.f) {
+                normals[firstVertex + v] = glm::normalize(n);
+            }
+        }
+    });
+}
+
+}
+
+std::vector<NormalSplit> generateSmoothNormals(unsigned int* indices, size_t indexCount,
+                                               VertexStream<const glm::vec3> positions, VertexStream<glm::vec3> normals,
+                                               unsigned int firstVertex, size_t vertexCount,
+                                               float creaseAngle, ThreadPool& pool) {
+    std::vector<NormalSplit> splits;
+    indexCount -= indexCount % 3;
+    if (indexCount == 0 || vertexCount == 0) {
+        return splits;
+    }
+    if (creaseAngle >= NO_CREASE_ANGLE) {
+        generateWithoutCreases(indices, indexCount, positions, normals, firstVertex, vertexCount, pool);
+        return splits;
+    }
+
+    const size_t triangleCount = indexCount / 3;
+    const float creaseCos = std::cos(creaseAngle);
+
+    // Contribution de chaque coin et direction de chaque face (nulle si dégénérée)
+    std::vector<glm::vec3> contributions(indexCount, glm::vec3(0.f));
+    std::vector<glm::vec3> faceNormals(triangleCount, glm::vec3(0.f));
+    parallelFor(pool, getTaskCount(pool, triangleCount), triangleCount, [&](size_t, size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            const unsigned int* corner = indices + 3 * t;
+            if (getCornerContributions(positions[corner[0]], positions[corner[1]], positions[corner[2]], &contributions[3 * t])) {
+                faceNormals[t] = glm::normalize(contributions[3 * t]);
+            }
+        }
+    });
+
+    // Coins de chaque sommet, rangés par sommet (tri par dénombrement)
+    std::vector<unsigned int> firstCorner(vertexCount + 1, 0);
+    for (size_t i = 0; i < indexCount; ++i) {
+        ++firstCorner[indices[i] - firstVertex + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        firstCorner[v + 1] += firstCorner[v];
+    }
+    std::vector<unsigned int> vertexCorners(indexCount);
+    {
+        std::vector<unsigned int> cursor(firstCorner.begin(), firstCorner.end() - 1);
+        for (size_t i = 0; i < indexCount; ++i) {
+            vertexCorners[cursor[indices[i] - firstVertex]++] = i;
+        }
+    }
+
+    // Normale de chaque coin: somme des contributions des faces du sommet qui ne forment pas de pli avec la sienne
+    std::vector<glm::vec3> cornerNormals(indexCount, glm::vec3(0.f));
+    parallelFor(pool, getTaskCount(pool, vertexCount), vertexCount, [&](size_t, size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            for (auto i = firstCorner[v]; i < firstCorner[v + 1]; ++i) {
+                const glm::vec3& face = faceNormals[vertexCorners[i] / 3];
+                bool degenerate = glm::dot(face, face) == 0.f;
+                glm::vec3 n(0.f);
+                for (auto j = firstCorner[v]; j < firstCorner[v + 1]; ++j) {
+                    if (degenerate || glm::dot(face, faceNormals[vertexCorners[j] / 3]) >= creaseCos) {
+                        n += contributions[vertexCorners[j]];
+                    }
+                }
+                cornerNormals[vertexCorners[i]] = glm::dot(n, n) > 0.f ? glm::normalize(n) : n;
+            }
+        }
+    });
+
+    // Les coins de même normale partagent un sommet: le premier groupe garde le sommet d'origine, les suivants
+    // deviennent des copies. Fait en série pour numéroter les copies de façon déterministe
+    std::vector<glm::vec3> groups;
+    std::vector<unsigned int> groupVertices;
+    for (size_t v = 0; v < vertexCount; ++v) {
+        groups.clear();
+        groupVertices.clear();
+        for (auto i = firstCorner[v]; i < firstCorner[v + 1]; ++i) {
+            auto corner = vertexCorners[i];
+            const glm::vec3& n = cornerNormals[corner];
+            if (glm::dot(n, n) == 0.f) {
+                continue; // seulement des faces dégénérées: la normale reste inchangée
+            }
+            size_t g = 0;
+            while (g < groups.size() && glm::dot(groups[g], n) < SAME_NORMAL_DOT) {
+                ++g;
+            }
+            if (g == groups.size()) {
+                groups.push_back(n);
+                if (g == 0) {
+                    groupVertices.push_back(firstVertex + v);
+                    normals[firstVertex + v] = n;
+                }
+                else {
+                    groupVertices.push_back(positions.m_nCount + splits.size());
+                    splits.push_back(NormalSplit{ unsigned(firstVertex + v), n });
+                }
+            }
+            indices[corner] = groupVertices[g];
+        }
+    }
+
+    return splits;
+}
+
+}
@@ -0,0 +1,87 @@
+#include "glimac/PackedVertex.hpp"
+#include <glm/gtc/packing.hpp>
+
+namespace glimac {
+
+namespace {
+
+uint16_t quantizeUnorm16(float value, float lower, float size) {
+    if (size <= 0.f) {
+        return 0;
+    }
+    return uint16_t(glm::round(glm::clamp((value - lower) / size, 0.f, 1.f) * 65535.f));
+}
+
+int16_t quantizeSnorm16(float value) {
+    return int16_t(glm::round(glm::clamp(value, -1.f, 1.f) * 32767.f));
+}
+
+// Conversion faite par le GPU pour un attribut GL_SHORT normalisé (OpenGL 4.2+, OpenGL ES 3.0)
+float dequantizeSnorm16(int16_t value) {
+    return glm::max(value / 32767.f, -1.f);
+}
+
+glm::vec2 signNotZero(const glm::vec2& v) {
+    return glm::vec2(v.x >= 0.f ? 1.f : -1.f, v.y >= 0.f ? 1.f : -1.f);
+}
+
+}
+
+glm::vec2 encodeOctahedral(const glm::vec3& normal) {
+    // Projection sur l'octaèdre |x| + |y| + |z| = 1, l'hémisphère z < 0 étant replié sur les coins
+    float l1 = glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z);
+    if (l1 == 0.f) {
+        return glm::vec2(0.f);
+    }
+    glm::vec2 p = glm::vec2(normal) / l1;
+    if (normal.z < 0.f) {
+        p = (1.f - glm::abs(glm::vec2(p.y, p.x))) * signNotZero(p);
+    }
+    return p;
+}
+
+glm::vec3 decodeOctahedral(const glm::vec2& encoded) {
+    // Même calcul que decodeOctahedral dans 3D.vs.glsl
+    glm::vec3 n(encoded, 1.f - glm::abs(encoded.x) - glm::abs(encoded.y));
+    float t = glm::max(-n.z, 0.f);
+    n.x += n.x >= 0.f ? -t : t;
+    n.y += n.y >= 0.f ? -t : t;
+    return glm::normalize(n);
+}
+
+PackedVertex packVertex(const ShapeVertex& vertex, const BBox3f& bounds) {
+    PackedVertex packed;
+    glm::vec3 size = bounds.size();
+    for (auto i = 0u; i < 3u; ++i) {
+        packed.position[i] = quantizeUnorm16(vertex.position[i], bounds.lower[i], size[i]);
+    }
+    packed.padding = 0;
+
+    glm::vec2 normal = encodeOctahedral(vertex.normal);
+    packed.normal[0] = quantizeSnorm16(normal.x);
+    packed.normal[1] = quantizeSnorm16(normal.y);
+
+    packed.texCoords[0] = glm::packHalf1x16(vertex.texCoords.x);
+    packed.texCoords[1] = glm::packHalf1x16(vertex.texCoords.y);
+    return packed;
+}
+
+ShapeVertex unpackVertex(const PackedVertex& vertex, const BBox3f& bounds) {
+    glm::vec3 q(vertex.position[0], vertex.position[1], vertex.position[2]);
+    return ShapeVertex(bounds.lower + q / 65535.f * bounds.size(),
+                       decodeOctahedral(glm::vec2(dequantizeSnorm16(vertex.normal[0]), dequantizeSnorm16(vertex.normal[1]))),
+                       glm::vec2(glm::unpackHalf1x16(vertex.texCoords[0]), glm::unpackHalf1x16(vertex.texCoords[1])));
+}
+
+std::vector<PackedVertex> packVertices(const ShapeVertex* vertices, size_t count, BBox3f& bounds) {
+    bounds = count ? BBox3f::fromPoints(&vertices[0].position, count, sizeof(ShapeVertex)) : BBox3f(glm::vec3(0.f));
+
+    std::vector<PackedVertex> packed;
+    packed.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        packed.push_back(packVertex(vertices[i], bounds));
+    }
+    return packed;
+}
+
+}
@@ -0,0 +1,210 @@
+#include "glimac/PixelConversion.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define GLIMAC_PIXEL_CONVERSION_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define GLIMAC_TARGET(isa) __attribute__((target(isa)))
+#else
+#define GLIMAC_TARGET(isa)
+#endif
+
+namespace glimac {
+
+static const float U8_TO_F32_SCALE = 1.f / 255;
+
+void convertU8ToF32Scalar(const unsigned char* src, float* dst, size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        dst[i] = src[i] * U8_TO_F32_SCALE;
+    }
+}
+
+void convertF32ToU8Scalar(const float* src, unsigned char* dst, size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        // mêmes comparaisons que _mm_max_ps / _mm_min_ps, pour que NaN donne 0 dans les deux cas
+        float v = src[i] > 0.f ? src[i] : 0.f;
+        v = v < 1.f ? v : 1.f;
+        dst[i] = (unsigned char)(v * 255.f + .5f);
+    }
+}
+
+#ifdef GLIMAC_PIXEL_CONVERSION_X86
+
+GLIMAC_TARGET("sse2")
+static void convertU8ToF32SSE2(const unsigned char* src, float* dst, size_t count) {
+    const __m128 scale = _mm_set1_ps(U8_TO_F32_SCALE);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for(; i + 16 <= count; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i lo16 = _mm_unpacklo_epi8(bytes, zero);
+        __m128i hi16 = _mm_unpackhi_epi8(bytes, zero);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo16, zero)), scale));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo16, zero)), scale));
+        _mm_storeu_ps(dst + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi16, zero)), scale));
+        _mm_storeu_ps(dst + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi16, zero)), scale));
+    }
+    convertU8ToF32Scalar(src + i, dst + i, count - i);
+}
+
+GLIMAC_TARGET("sse2")
+static void convertF32ToU8SSE2(const float* src, unsigned char* dst, size_t count) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 scale = _mm_set1_ps(255.f);
+    const __m128 half = _mm_set1_ps(.5f);
+    size_t i = 0;
+    for(; i + 16 <= count; i += 16) {
+        __m128i v[4];
+        for(int k = 0; k < 4; ++k) {
+            __m128 f = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4 * k), zero), one);
+            v[k] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(f, scale), half));
+        }
+        __m128i packed = _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]), _mm_packs_epi32(v[2], v[3]));
+        _mm_storeu_si128((__m128i*)(dst + i), packed);
+    }
+    convertF32ToU8Scalar(src + i, dst + i, count - i);
+}
+
+GLIMAC_TARGET("avx2")
+static void convertU8ToF32AVX2(const unsigned char* src, float* dst, size_t count) {
+    const __m256 scale = _mm256_set1_ps(U8_TO_F32_SCALE);
+    size_t i = 0;
+    for(; i + 16 <= count; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(src + i));
+        __m256i lo = _mm256_cvtepu8_epi32(bytes);
+        __m256i hi = _mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+        _mm256_storeu_ps(dst + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+    }
+    convertU8ToF32Scalar(src + i, dst + i, count - i);
+}
+
+GLIMAC_TARGET("avx2")
+static void convertF32ToU8AVX2(const float* src, unsigned char* dst, size_t count) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256 scale = _mm256_set1_ps(255.f);
+    const __m256 half = _mm256_set1_ps(.5f);
+    size_t i = 0;
+    for(; i + 16 <= count; i += 16) {
+        __m256 f0 = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i), zero), one);
+        __m256 f1 = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i + 8), zero), one);
+        __m256i v0 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(f0, scale), half));
+        __m256i v1 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(f1, scale), half));
+        // les pack AVX2 travaillent par moitié de 128 bits: on remet les 4 groupes dans l'ordre
+        __m256i packed16 = _mm256_permute4x64_epi64(_mm256_packs_epi32(v0, v1), 0xD8);
+        __m128i packed8 = _mm_packus_epi16(_mm256_castsi256_si128(packed16), _mm256_extracti128_si256(packed16, 1));
+        _mm_storeu_si128((__m128i*)(dst + i), packed8);
+    }
+    convertF32ToU8Scalar(src + i, dst + i, count - i);
+}
+
+static bool cpuSupportsAVX2() {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if(info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if(!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+#endif
+
+namespace {
+
+struct PixelConversionFunctions {
+    void (*u8ToF32)(const unsigned char*, float*, size_t);
+    void (*f32ToU8)(const float*, unsigned char*, size_t);
+    const char* name;
+};
+
+const PixelConversionFunctions SCALAR_FUNCTIONS = { &convertU8ToF32Scalar, &convertF32ToU8Scalar, "scalar" };
+
+#ifdef GLIMAC_PIXEL_CONVERSION_X86
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GLIMAC_PIXEL_CONVERSION_SSE2
+const PixelConversionFunctions SSE2_FUNCTIONS = { &convertU8ToF32SSE2, &convertF32ToU8SSE2, "sse2" };
+#endif
+const PixelConversionFunctions AVX2_FUNCTIONS = { &convertU8ToF32AVX2, &convertF32ToU8AVX2, "avx2" };
+#endif
+
+// nullptr si le noyau n'est pas disponible
+const PixelConversionFunctions* getFunctions(PixelConversionKernel kernel) {
+    switch(kernel) {
+    case PixelConversionKernel::SCALAR:
+        return &SCALAR_FUNCTIONS;
+#ifdef GLIMAC_PIXEL_CONVERSION_SSE2
+    case PixelConversionKernel::SSE2:
+        return &SSE2_FUNCTIONS;
+#endif
+#ifdef GLIMAC_PIXEL_CONVERSION_X86
+    case PixelConversionKernel::AVX2:
+        return cpuSupportsAVX2() ? &AVX2_FUNCTIONS : nullptr;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+// Noyau courant: le plus large disponible, sauf s'il a été imposé
+const PixelConversionFunctions*& currentFunctions() {
+    static const PixelConversionFunctions* functions = []() {
+        if(const PixelConversionFunctions* avx2 = getFunctions(PixelConversionKernel::AVX2)) {
+            return avx2;
+        }
+        if(const PixelConversionFunctions* sse2 = getFunctions(PixelConversionKernel::SSE2)) {
+            return sse2;
+        }
+        return &SCALAR_FUNCTIONS;
+    }();
+    return functions;
+}
+
+}
+
+void convertU8ToF32(const unsigned char* src, float* dst, size_t count) {
+    currentFunctions()->u8ToF32(src, dst, count);
+}
+
+void convertF32ToU8(const float* src, unsigned char* dst, size_t count) {
+    currentFunctions()->f32ToU8(src, dst, count);
+}
+
+const char* getPixelConversionKernel() {
+    return currentFunctions()->name;
+}
+
+bool isPixelConversionKernelSupported(PixelConversionKernel kernel) {
+    return getFunctions(kernel) != nullptr;
+}
+
+bool setPixelConversionKernel(PixelConversionKernel kernel) {
+    const PixelConversionFunctions* functions = getFunctions(kernel);
+    if(!functions) {
+        return false;
+    }
+    currentFunctions() = functions;
+    return true;
+}
+
+}
@@ -0,0 +1,79 @@
+#include "glimac/RenderQueue.hpp"
+#include <algorithm>
+
+namespace glimac {
+
+static_assert(RenderQueue::PASS_BITS + RenderQueue::MATERIAL_BITS + RenderQueue::TEXTURE_BITS + RenderQueue::MESH_BITS + RenderQueue::DEPTH_BITS == 64,
+              "RenderQueue key fields must fill 64 bits");
+
+static const unsigned RADIX_BITS = 16;
+static const unsigned RADIX_SIZE = 1u << RADIX_BITS;
+static const unsigned RADIX_PASSES = 64 / RADIX_BITS;
+
+// En dessous, remettre à zéro les histogrammes coûte plus que le tri par comparaison
+static const size_t MIN_RADIX_SORT_COUNT = 4096;
+
+uint64_t RenderQueue::makeKey(uint32_t pass, uint32_t material, uint32_t texture, uint32_t mesh, float depth) {
+    const uint32_t maxDepth = (1u << DEPTH_BITS) - 1;
+    uint32_t quantizedDepth = uint32_t(std::min(std::max(depth, 0.f), 1.f) * maxDepth);
+
+    uint64_t key = pass & ((1u << PASS_BITS) - 1);
+    key = (key << MATERIAL_BITS) | (material & ((1u << MATERIAL_BITS) - 1));
+    key = (key << TEXTURE_BITS) | (texture & ((1u << TEXTURE_BITS) - 1));
+    key = (key << MESH_BITS) | (mesh & ((1u << MESH_BITS) - 1));
+    return (key << DEPTH_BITS) | quantizedDepth;
+}
+
+void RenderQueue::reserve(size_t commandCount) {
+    m_Commands.reserve(commandCount);
+    m_Scratch.reserve(commandCount);
+}
+
+void RenderQueue::sort() {
+    const size_t count = m_Commands.size();
+    if (count < MIN_RADIX_SORT_COUNT) {
+        std::stable_sort(m_Commands.begin(), m_Commands.end(), [](const RenderCommand& a, const RenderCommand& b) {
+            return a.key < b.key;
+        });
+        return;
+    }
+
+    // Histogrammes des 4 chiffres en un seul parcours
+    m_Histograms.assign(RADIX_PASSES * RADIX_SIZE, 0);
+    for (const auto& command : m_Commands) {
+        for (unsigned pass = 0; pass < RADIX_PASSES; ++pass) {
+            ++m_Histograms[pass * RADIX_SIZE + ((command.key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1))];
+        }
+    }
+
+    m_Scratch.resize(count);
+    RenderCommand* source = m_Commands.data();
+    RenderCommand* destination = m_Scratch.data();
+    for (unsigned pass = 0; pass < RADIX_PASSES; ++pass) {
+        uint32_t* histogram = &m_Histograms[pass * RADIX_SIZE];
+        const unsigned shift = pass * RADIX_BITS;
+
+        // Toutes les clés ont le même chiffre: la passe ne changerait rien
+        if (histogram[(source[0].key >> shift) & (RADIX_SIZE - 1)] == count) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (unsigned digit = 0; digit < RADIX_SIZE; ++digit) {
+            uint32_t digitCount = histogram[digit];
+            histogram[digit] = offset;
+            offset += digitCount;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            destination[histogram[(source[i].key >> shift) & (RADIX_SIZE - 1)]++] = source[i];
+        }
+        std::swap(source, destination);
+    }
+
+    // Nombre impair de passes effectuées: le résultat est dans le tampon de travail
+    if (source != m_Commands.data()) {
+        m_Commands.swap(m_Scratch);
+    }
+}
+
+}
@@ -0,0 +1,41 @@
+#include "glimac/RenderStats.hpp"
+
+namespace glimac {
+
+size_t RenderStats::m_nDrawCalls = 0;
+size_t RenderStats::m_nTriangles = 0;
+size_t RenderStats::m_nVisibleObjects = 0;
+size_t RenderStats::m_nCulledObjects = 0;
+size_t RenderStats::m_nUploadedBytes = 0;
+size_t RenderStats::m_StateChanges[RenderStats::STATE_CHANGE_TYPES] = {};
+
+void RenderStats::beginFrame() {
+    m_nDrawCalls = 0;
+    m_nTriangles = 0;
+    m_nVisibleObjects = 0;
+    m_nCulledObjects = 0;
+    m_nUploadedBytes = 0;
+    for (size_t i = 0; i < STATE_CHANGE_TYPES; ++i) {
+        m_StateChanges[i] = 0;
+    }
+}
+
+void RenderStats::addDraw(size_t triangleCount) {
+    ++m_nDrawCalls;
+    m_nTriangles += triangleCount;
+}
+
+void RenderStats::addCulling(size_t visibleCount, size_t culledCount) {
+    m_nVisibleObjects += visibleCount;
+    m_nCulledObjects += culledCount;
+}
+
+size_t RenderStats::getStateChangeCount() {
+    size_t count = 0;
+    for (size_t i = 0; i < STATE_CHANGE_TYPES; ++i) {
+        count += m_StateChanges[i];
+    }
+    return count;
+}
+
+}
@@ -0,0 +1,69 @@
+#include "glimac/Scene.hpp"
+#include <stdexcept>
+
+namespace glimac {
+
+Entity Scene::create(Entity parent, const glm::mat4& localMatrix) {
+    if (parent != NO_ENTITY && parent >= m_Parents.size()) {
+        throw std::runtime_error("Scene: the parent must be created before its children");
+    }
+    Entity entity = m_Parents.size();
+    m_Parents.push_back(parent);
+    m_LocalMatrices.push_back(localMatrix);
+    m_WorldMatrices.push_back(localMatrix);
+    m_Meshes.push_back(NO_MESH);
+    m_Materials.push_back(0);
+    m_LocalBounds.push_back(BBox3f::emptyBox());
+    m_WorldBounds.push_back(BBox3f::emptyBox());
+    return entity;
+}
+
+void Scene::reserve(size_t entityCount) {
+    m_Parents.reserve(entityCount);
+    m_LocalMatrices.reserve(entityCount);
+    m_WorldMatrices.reserve(entityCount);
+    m_Meshes.reserve(entityCount);
+    m_Materials.reserve(entityCount);
+    m_LocalBounds.reserve(entityCount);
+    m_WorldBounds.reserve(entityCount);
+}
+
+void Scene::clear() {
+    m_Parents.clear();
+    m_LocalMatrices.clear();
+    m_WorldMatrices.clear();
+    m_Meshes.clear();
+    m_Materials.clear();
+    m_LocalBounds.clear();
+    m_WorldBounds.clear();
+    m_nDrawableCount = 0;
+}
+
+void Scene::setMesh(Entity entity, uint32_t mesh) {
+    m_nDrawableCount += (mesh != NO_MESH) - (m_Meshes[entity] != NO_MESH);
+    m_Meshes[entity] = mesh;
+}
+
+void Scene::updateWorldMatrices() {
+    const size_t count = m_Parents.size();
+    for (size_t i = 0; i < count; ++i) {
+        // Le parent a un indice plus petit: sa matrice monde est déjà à jour
+        Entity parent = m_Parents[i];
+        m_WorldMatrices[i] = parent == NO_ENTITY ? m_LocalMatrices[i] : m_WorldMatrices[parent] * m_LocalMatrices[i];
+        m_WorldBounds[i] = m_LocalBounds[i].empty() ? m_LocalBounds[i] : transform(m_WorldMatrices[i], m_LocalBounds[i]);
+    }
+}
+
+size_t Scene::cull(const Frustum& frustum, std::vector<unsigned char>& visible) const {
+    const size_t count = m_Parents.size();
+    visible.resize(count);
+    frustum.testBoxes(m_WorldBounds.data(), count, visible.data());
+    size_t visibleCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        visible[i] = m_Meshes[i] != NO_MESH && (visible[i] || m_WorldBounds[i].empty());
+        visibleCount += visible[i];
+    }
+    return visibleCount;
+}
+
+}
@@ -0,0 +1,22 @@
+#include "glimac/SegmentCache.hpp"
+
+namespace glimac {
+
+const std::vector<InstanceData>& SegmentCache::get(const std::vector<glm::vec3>& points, const std::vector<glm::vec3>& colors, unsigned int version) {
+    if (m_nVersion != version) {
+        rebuild(points, colors);
+        m_nVersion = version;
+    }
+    return m_Segments;
+}
+
+void SegmentCache::rebuild(const std::vector<glm::vec3>& points, const std::vector<glm::vec3>& colors) {
+    m_Segments.clear();
+    m_Segments.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        glm::vec3 end = points[(i + 1) % points.size()];
+        m_Segments.push_back(InstanceData(segmentMatrix(points[i], end), colors[i]));
+    }
+}
+
+}
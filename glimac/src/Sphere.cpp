@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include <vector>
 #include <iostream>
@@ -24,50 +25,75 @@ void Sphere::build(GLfloat r, GLsizei discLat, GLsizei discLong) {
     GLfloat rcpLat = 1.f / discLat, rcpLong = 1.f / discLong;
     GLfloat dPhi = 2 * glm::pi<float>() * rcpLat, dTheta = glm::pi<float>() * rcpLong;
     
-    std::vector<ShapeVertex> data;
+    // Sinus et cosinus de chaque longitude, calculés une seule fois pour toutes les bandes
+    // (gardés en double: ils sont multipliés comme l'étaient les appels à sin / cos)
+    std::vector<double> sinPhi(discLat + 1), cosPhi(discLat + 1);
+    for(GLsizei i = 0; i <= discLat; ++i) {
+        sinPhi[i] = sin(i * dPhi);
+        cosPhi[i] = cos(i * dPhi);
+    }
+
+    std::vector<ShapeVertex> data((discLong + 1) * (discLat + 1));
+    ShapeVertex* pVertex = data.data();
     
     // Construit l'ensemble des vertex
     for(GLsizei j = 0; j <= discLong; ++j) {
         GLfloat cosTheta = cos(-glm::pi<float>() / 2 + j * dTheta);
         GLfloat sinTheta = sin(-glm::pi<float>() / 2 + j * dTheta);
+        GLfloat texCoordY = 1.f - j * rcpLong;
         
-        for(GLsizei i = 0; i <= discLat; ++i) {
-            ShapeVertex vertex;
-            
-            vertex.texCoords.x = i * rcpLat;
-            vertex.texCoords.y = 1.f - j * rcpLong;
+        for(GLsizei i = 0; i <= discLat; ++i, ++pVertex) {
+            pVertex->texCoords.x = i * rcpLat;
+            pVertex->texCoords.y = texCoordY;
 
-            vertex.normal.x = sin(i * dPhi) * cosTheta;
-            vertex.normal.y = sinTheta;
-            vertex.normal.z = cos(i * dPhi) * cosTheta;
+            pVertex->normal.x = sinPhi[i] * cosTheta;
+            pVertex->normal.y = sinTheta;
+            pVertex->normal.z = cosPhi[i] * cosTheta;
             
-            vertex.position = r * vertex.normal;
-            
-            data.push_back(vertex);
+            pVertex->position = r * pVertex->normal;
         }
     }
 
     m_nVertexCount = discLat * discLong * 6;
     
-    GLuint idx = 0;
-    // Construit les vertex finaux en regroupant les données en triangles:
+    // Construit les triangles à partir des index:
     // Pour une longitude donnée, les deux triangles formant une face sont de la forme:
     // (i, i + 1, i + discLat + 1), (i, i + discLat + 1, i + discLat)
     // avec i sur la bande correspondant à la longitude
+    m_Indices.reserve(m_nVertexCount);
     for(GLsizei j = 0; j < discLong; ++j) {
-        GLsizei offset = j * (discLat + 1);
+        GLuint offset = j * (discLat + 1);
         for(GLsizei i = 0; i < discLat; ++i) {
-            m_Vertices.push_back(data[offset + i]);
-            m_Vertices.push_back(data[offset + (i + 1)]);
-            m_Vertices.push_back(data[offset + discLat + 1 + (i + 1)]);
-            m_Vertices.push_back(data[offset + i]);
-            m_Vertices.push_back(data[offset + discLat + 1 + (i + 1)]);
-            m_Vertices.push_back(data[offset + i + discLat + 1]);
+            m_Indices.push_back(offset + i);
+            m_Indices.push_back(offset + (i + 1));
+            m_Indices.push_back(offset + discLat + 1 + (i + 1));
+            m_Indices.push_back(offset + i);
+            m_Indices.push_back(offset + discLat + 1 + (i + 1));
+            m_Indices.push_back(offset + i + discLat + 1);
         }
     }
+
+    // Version non indexée: les sommets de chaque triangle sont dupliqués
+    m_Vertices.reserve(m_nVertexCount);
+    for(auto index: m_Indices) {
+        m_Vertices.push_back(data[index]);
+    }
+    m_IndexedVertices = std::move(data);
     
-    // Attention ! dans cette implantation on duplique beaucoup de sommets. Une meilleur stratégie est de passer
-    // par un Index Buffer Object, que nous verrons dans les prochains TDs
+    // Attention ! la version non indexée duplique beaucoup de sommets: pour dessiner, préférer
+    // getIndexedDataPointer() et getIndexPointer() avec un Index Buffer Object
+}
+
+std::vector<Sphere> Sphere::createLODChain(GLfloat radius, GLsizei discLat, GLsizei discLong, unsigned int levelCount) {
+    std::vector<Sphere> levels;
+    levels.reserve(levelCount);
+    for(unsigned int i = 0; i < levelCount; ++i) {
+        levels.emplace_back(radius, discLat, discLong);
+        // En dessous, la sphère ne ressemble plus à une sphère
+        discLat = std::max<GLsizei>(discLat / 2, 4);
+        discLong = std::max<GLsizei>(discLong / 2, 2);
+    }
+    return levels;
 }
 
 }
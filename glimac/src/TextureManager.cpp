@@ -0,0 +1,48 @@
+#include "glimac/TextureManager.hpp"
+#include "glimac/GLState.hpp"
+#include "glimac/RenderStats.hpp"
+
+namespace glimac {
+
+std::unordered_map<const Image*, GLuint> TextureManager::m_TextureMap;
+
+GLuint TextureManager::getTexture(const Image* image) {
+    auto it = m_TextureMap.find(image);
+    if(it != std::end(m_TextureMap)) {
+        return (*it).second;
+    }
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    GLState::bindTexture(0, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    if(image->getFormat() == PixelFormat::RGBA8) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, image->getWidth(), image->getHeight(), 0, GL_RGBA, GL_UNSIGNED_BYTE, image->getBytes());
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image->getWidth(), image->getHeight(), 0, GL_RGBA, GL_FLOAT, image->getPixels());
+    }
+    RenderStats::addUpload(image->getByteSize());
+    GLState::bindTexture(0, 0);
+
+    m_TextureMap[image] = texture;
+    return texture;
+}
+
+void TextureManager::bind(const Image* image, GLuint unit) {
+    GLState::bindTexture(unit, getTexture(image));
+}
+
+size_t TextureManager::getTextureCount() {
+    return m_TextureMap.size();
+}
+
+void TextureManager::clear() {
+    for(auto& entry: m_TextureMap) {
+        glDeleteTextures(1, &entry.second);
+    }
+    m_TextureMap.clear();
+    GLState::invalidate();
+}
+
+}
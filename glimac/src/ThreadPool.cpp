@@ -0,0 +1,58 @@
+#include "glimac/ThreadPool.hpp"
+
+namespace glimac {
+
+ThreadPool::ThreadPool(unsigned int threadCount) {
+    if(threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if(threadCount == 0) {
+        threadCount = 1;
+    }
+    m_Threads.reserve(threadCount);
+    for(auto i = 0u; i < threadCount; ++i) {
+        m_Threads.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_bStopping = true;
+    }
+    m_Condition.notify_all();
+    for(auto& thread: m_Threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Tasks.push(std::move(task));
+    }
+    m_Condition.notify_one();
+}
+
+void ThreadPool::work() {
+    for(;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(lock, [this]() { return m_bStopping || !m_Tasks.empty(); });
+            if(m_Tasks.empty()) {
+                return; // arrêt demandé et plus rien à faire
+            }
+            task = std::move(m_Tasks.front());
+            m_Tasks.pop();
+        }
+        task();
+    }
+}
+
+ThreadPool& ThreadPool::getDefault() {
+    static ThreadPool pool;
+    return pool;
+}
+
+}
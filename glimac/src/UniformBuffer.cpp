@@ -0,0 +1,68 @@
+#include "glimac/UniformBuffer.hpp"
+#include "glimac/RenderStats.hpp"
+#include <stdexcept>
+
+namespace glimac {
+
+UniformBuffer::UniformBuffer(size_t size, GLuint bindingPoint):
+    m_nSize(size), m_nBindingPoint(bindingPoint) {
+    GLint maxBlockSize = 0;
+    glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &maxBlockSize);
+    if (size > size_t(maxBlockSize)) {
+        throw std::runtime_error("UniformBuffer: the block is larger than GL_MAX_UNIFORM_BLOCK_SIZE");
+    }
+
+    glGenBuffers(1, &m_nUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_nUBO);
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, m_nUBO);
+}
+
+UniformBuffer::~UniformBuffer() {
+    release();
+}
+
+UniformBuffer::UniformBuffer(UniformBuffer&& rvalue):
+    m_nUBO(rvalue.m_nUBO), m_nSize(rvalue.m_nSize), m_nBindingPoint(rvalue.m_nBindingPoint), m_nUploadedBytes(rvalue.m_nUploadedBytes) {
+    rvalue.m_nUBO = 0;
+}
+
+UniformBuffer& UniformBuffer::operator =(UniformBuffer&& rvalue) {
+    if (this != &rvalue) {
+        release();
+        m_nUBO = rvalue.m_nUBO;
+        m_nSize = rvalue.m_nSize;
+        m_nBindingPoint = rvalue.m_nBindingPoint;
+        m_nUploadedBytes = rvalue.m_nUploadedBytes;
+        rvalue.m_nUBO = 0;
+    }
+    return *this;
+}
+
+void UniformBuffer::release() {
+    glDeleteBuffers(1, &m_nUBO);
+    m_nUBO = 0;
+}
+
+bool UniformBuffer::bindBlock(GLuint program, const char* blockName, GLuint bindingPoint) {
+    GLuint blockIndex = glGetUniformBlockIndex(program, blockName);
+    if (blockIndex == GL_INVALID_INDEX) {
+        return false;
+    }
+    glUniformBlockBinding(program, blockIndex, bindingPoint);
+    return true;
+}
+
+void UniformBuffer::update(const void* data, size_t size, size_t offset) {
+    if (offset + size > m_nSize) {
+        throw std::runtime_error("UniformBuffer: update out of the buffer");
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, m_nUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    m_nUploadedBytes += size;
+    RenderStats::addUpload(size);
+}
+
+}
@@ -21,6 +21,8 @@
 #include <cstdlib>
 #include <cstring>
 #include <cassert>
+#include <algorithm>
+#include <climits>
 
 #include <string>
 #include <vector>
@@ -28,26 +30,35 @@
 #include <fstream>
 #include <sstream>
 
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#if defined(__cpp_lib_to_chars)
+#define TINYOBJ_HAS_FROM_CHARS
+#endif
+#endif
+#endif
+
 #include "tiny_obj_loader.h"
+#include "tiny_obj_vertex_map.h"
+#include "glimac/MappedFile.hpp"
+#include "glimac/ThreadPool.hpp"
 
 namespace tinyobj {
 
-struct vertex_index {
-  int v_idx, vt_idx, vn_idx;
-  vertex_index() {};
-  vertex_index(int idx) : v_idx(idx), vt_idx(idx), vn_idx(idx) {};
-  vertex_index(int vidx, int vtidx, int vnidx) : v_idx(vidx), vt_idx(vtidx), vn_idx(vnidx) {};
+// Faces of the group being parsed, stored flat: face i is made of the
+// sizes[i] corners that follow those of the previous faces.
+struct face_group {
+  std::vector<vertex_index> corners;
+  std::vector<unsigned int> sizes;
 
-};
-// for std::map
-static inline bool operator<(const vertex_index& a, const vertex_index& b)
-{
-  if (a.v_idx != b.v_idx) return (a.v_idx < b.v_idx);
-  if (a.vn_idx != b.vn_idx) return (a.vn_idx < b.vn_idx);
-  if (a.vt_idx != b.vt_idx) return (a.vt_idx < b.vt_idx);
+  bool empty() const { return sizes.empty(); }
 
-  return false;
-}
+  void clear() {
+    corners.clear();
+    sizes.clear();
+  }
+};
 
 struct obj_shape {
   std::vector<float> v;
@@ -163,7 +174,7 @@ static vertex_index parseTriple(
 
 static unsigned int
 updateVertex(
-  std::map<vertex_index, unsigned int>& vertexCache,
+  vertex_index_map& vertexCache,
   std::vector<float>& positions,
   std::vector<float>& normals,
   std::vector<float>& texcoords,
@@ -172,11 +183,12 @@ updateVertex(
   const std::vector<float>& in_texcoords,
   const vertex_index& i)
 {
-  const std::map<vertex_index, unsigned int>::iterator it = vertexCache.find(i);
+  bool inserted;
+  unsigned int idx = vertexCache.find_or_insert(i, positions.size() / 3, inserted);
 
-  if (it != vertexCache.end()) {
+  if (!inserted) {
     // found cache
-    return it->second;
+    return idx;
   }
 
   assert(in_positions.size() > (unsigned int) (3*i.v_idx+2));
@@ -196,9 +208,6 @@ updateVertex(
     texcoords.push_back(in_texcoords[2*i.vt_idx+1]);
   }
 
-  unsigned int idx = positions.size() / 3 - 1;
-  vertexCache[i] = idx;
-
   return idx;
 }
 
@@ -222,36 +231,42 @@ void InitMaterial(material_t& material) {
   material.unknown_parameter.clear();
 }
 
+// Vertices are only deduplicated within one face group: the cache starts empty
+// on every call (it used to be a std::map passed by value, hence always a fresh
+// copy of an empty map).
 static bool
 exportFaceGroupToShape(
   shape_t& shape,
-  std::map<vertex_index, unsigned int> vertexCache,
   const std::vector<float> &in_positions,
   const std::vector<float> &in_normals,
   const std::vector<float> &in_texcoords,
-  const std::vector<std::vector<vertex_index> >& faceGroup,
+  const face_group& faceGroup,
   const int material_id,
-  const std::string &name,
-  bool clearCache)
+  const std::string &name)
 {
   if (faceGroup.empty()) {
     return false;
   }
 
-  size_t offset;
-
-  offset = shape.mesh.indices.size();
+  // A closed mesh shares each vertex between several corners (about 6 for a
+  // triangle grid): size the cache for a quarter of the corners and let it
+  // grow when the mesh shares less.
+  vertex_index_map vertexCache(faceGroup.corners.size() / 4);
 
   // Flatten vertices and indices
-  for (size_t i = 0; i < faceGroup.size(); i++) {
-    const std::vector<vertex_index>& face = faceGroup[i];
+  const vertex_index* face = faceGroup.corners.data();
+  for (size_t i = 0; i < faceGroup.sizes.size(); i++) {
+    size_t npolys = faceGroup.sizes[i];
+    if (npolys < 3) {
+      // points and lines make no triangle
+      face += npolys;
+      continue;
+    }
 
     vertex_index i0 = face[0];
     vertex_index i1(-1);
     vertex_index i2 = face[1];
 
-    size_t npolys = face.size();
-
     // Polygon -> triangle fan conversion
     for (size_t k = 2; k < npolys; k++) {
       i1 = i2;
@@ -268,13 +283,11 @@ exportFaceGroupToShape(
       shape.mesh.material_ids.push_back(material_id);
     }
 
+    face += npolys;
   }
 
   shape.name = name;
 
-  if (clearCache)
-      vertexCache.clear();
-
   return true;
 
 }
@@ -288,7 +301,8 @@ std::string LoadMtl (
   std::stringstream err;
 
   material_t material;
-  
+  InitMaterial(material);
+
   int maxchars = 8192;  // Alloc enough size.
   std::vector<char> buf(maxchars);  // Alloc enough size.
   while (inStream.peek() != -1) {
@@ -466,9 +480,12 @@ std::string LoadMtl (
       material.unknown_parameter.insert(std::pair<std::string, std::string>(key, value));
     }
   }
-  // flush last material.
-  material_map.insert(std::pair<std::string, int>(material.name, materials.size()));
-  materials.push_back(material);
+  // flush last material (none if the stream held no newmtl, e.g. a missing file).
+  if (!material.name.empty())
+  {
+      material_map.insert(std::pair<std::string, int>(material.name, materials.size()));
+      materials.push_back(material);
+  }
 
   return err.str();
 }
@@ -528,12 +545,11 @@ std::string LoadObj(
   std::vector<float> v;
   std::vector<float> vn;
   std::vector<float> vt;
-  std::vector<std::vector<vertex_index> > faceGroup;
+  face_group faceGroup;
   std::string name;
 
   // material
   std::map<std::string, int> material_map;
-  std::map<vertex_index, unsigned int> vertexCache;
   int  material = -1;
 
   shape_t shape;
@@ -604,15 +620,15 @@ std::string LoadObj(
       token += 2;
       token += strspn(token, " \t");
 
-      std::vector<vertex_index> face;
+      size_t first = faceGroup.corners.size();
       while (!isNewLine(token[0])) {
         vertex_index vi = parseTriple(token, v.size() / 3, vn.size() / 3, vt.size() / 2);
-        face.push_back(vi);
+        faceGroup.corners.push_back(vi);
         int n = strspn(token, " \t\r");
         token += n;
       }
 
-      faceGroup.push_back(face);
+      faceGroup.sizes.push_back(faceGroup.corners.size() - first);
       
       continue;
     }
@@ -620,11 +636,11 @@ std::string LoadObj(
     // use mtl
     if ((0 == strncmp(token, "usemtl", 6)) && isSpace((token[6]))) {
 
-      char namebuf[4096];
+      char namebuf[4096] = ""; // left untouched by sscanf when the name is missing
       token += 7;
       sscanf(token, "%s", namebuf);
 
-      bool ret = exportFaceGroupToShape(shape, vertexCache, v, vn, vt, faceGroup, material, name, false);
+      exportFaceGroupToShape(shape, v, vn, vt, faceGroup, material, name);
       faceGroup.clear();
 
       if (material_map.find(namebuf) != material_map.end()) {
@@ -640,7 +656,7 @@ std::string LoadObj(
 
     // load mtl
     if ((0 == strncmp(token, "mtllib", 6)) && isSpace((token[6]))) {
-      char namebuf[4096];
+      char namebuf[4096] = ""; // left untouched by sscanf when the name is missing
       token += 7;
       sscanf(token, "%s", namebuf);
         
@@ -657,7 +673,7 @@ std::string LoadObj(
     if (token[0] == 'g' && isSpace((token[1]))) {
 
       // flush previous face group.
-      bool ret = exportFaceGroupToShape(shape, vertexCache, v, vn, vt, faceGroup, material, name, true);
+      bool ret = exportFaceGroupToShape(shape, v, vn, vt, faceGroup, material, name);
       if (ret) {
         shapes.push_back(shape);
       }
@@ -690,7 +706,7 @@ std::string LoadObj(
     if (token[0] == 'o' && isSpace((token[1]))) {
 
       // flush previous face group.
-      bool ret = exportFaceGroupToShape(shape, vertexCache, v, vn, vt, faceGroup, material, name, true);
+      bool ret = exportFaceGroupToShape(shape, v, vn, vt, faceGroup, material, name);
       if (ret) {
         shapes.push_back(shape);
       }
@@ -700,7 +716,7 @@ std::string LoadObj(
       shape = shape_t();
 
       // @todo { multiple object name? }
-      char namebuf[4096];
+      char namebuf[4096] = ""; // left untouched by sscanf when the name is missing
       token += 2;
       sscanf(token, "%s", namebuf);
       name = std::string(namebuf);
@@ -712,7 +728,7 @@ std::string LoadObj(
     // Ignore unknown command.
   }
 
-  bool ret = exportFaceGroupToShape(shape, vertexCache, v, vn, vt, faceGroup, material, name, true);
+  bool ret = exportFaceGroupToShape(shape, v, vn, vt, faceGroup, material, name);
   if (ret) {
     shapes.push_back(shape);
   }
@@ -722,4 +738,843 @@ std::string LoadObj(
 }
 
 
+
+//
+// Memory-mapped loader.
+//
+// The parser below works directly on the mapped bytes: every line is a
+// [begin, end) range and the helpers never read past 'end', which plays the
+// role of the '\0' terminating the line buffer in LoadObj. Each helper mirrors
+// the libc call used by LoadObj (strspn, strcspn, atoi, atof, sscanf "%s") so
+// that both entry points produce the same output.
+//
+
+// token[i], or '\0' past the end of the line (as in a NUL-terminated buffer).
+static inline char peekChar(const char* token, const char* end, size_t i)
+{
+  return (token + i < end) ? token[i] : '\0';
+}
+
+static inline bool isCSpace(const char c) {
+  return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\v') || (c == '\f') || (c == '\r');
+}
+
+// token += strspn(token, " \t")
+static inline const char* skipSpaceTab(const char* token, const char* end)
+{
+  while (token < end && isSpace(*token)) token++;
+  return token;
+}
+
+// token += strspn(token, " \t\r")
+static inline const char* skipSpaceTabCR(const char* token, const char* end)
+{
+  while (token < end && (isSpace(*token) || *token == '\r')) token++;
+  return token;
+}
+
+// token += strcspn(token, " \t\r")
+static inline const char* skipToken(const char* token, const char* end)
+{
+  while (token < end && !isSpace(*token) && *token != '\r') token++;
+  return token;
+}
+
+// token += strcspn(token, "/ \t\r")
+static inline const char* skipIndex(const char* token, const char* end)
+{
+  while (token < end && *token != '/' && !isSpace(*token) && *token != '\r') token++;
+  return token;
+}
+
+// atoi(token) (saturating like strtol before the conversion to int)
+static inline int parseIntInPlace(const char* token, const char* end)
+{
+  while (token < end && isCSpace(*token)) token++;
+  bool negative = false;
+  if (token < end && (*token == '+' || *token == '-')) {
+    negative = (*token == '-');
+    token++;
+  }
+  const unsigned long long limit = negative ? (unsigned long long)LONG_MAX + 1 : (unsigned long long)LONG_MAX;
+  unsigned long long value = 0;
+  while (token < end && *token >= '0' && *token <= '9') {
+    if (value <= limit) value = value * 10 + (*token - '0');
+    token++;
+  }
+  if (value > limit) value = limit;
+  long result = negative ? (long)(0 - value) : (long)value;
+  return (int)result;
+}
+
+// atof on what is left of the line: used for anything from_chars does not
+// accept as a whole token (hexadecimal floats, trailing garbage, empty token...)
+static float parseFloatFallback(const char* token, const char* end)
+{
+  char buf[128];
+  size_t len = end - token;
+  if (len < sizeof(buf)) {
+    memcpy(buf, token, len);
+    buf[len] = '\0';
+    return (float)atof(buf);
+  }
+  std::string str(token, end);
+  return (float)atof(str.c_str());
+}
+
+// parseFloat: skip " \t", parse, skip the token
+static inline float parseFloatInPlace(const char*& token, const char* end)
+{
+  token = skipSpaceTab(token, end);
+  const char* tokenEnd = skipToken(token, end);
+  float f;
+#ifdef TINYOBJ_HAS_FROM_CHARS
+  // from_chars rejects a leading '+' that atof accepts
+  const char* first = token;
+  if (first + 1 < tokenEnd && *first == '+' && (first[1] == '.' || (first[1] >= '0' && first[1] <= '9'))) first++;
+  // parse as double then narrow, exactly like (float)atof()
+  double value;
+  std::from_chars_result result = std::from_chars(first, tokenEnd, value);
+  if (first < tokenEnd && result.ec == std::errc() && result.ptr == tokenEnd) {
+    f = (float)value;
+  } else {
+    f = parseFloatFallback(token, end);
+  }
+#else
+  f = parseFloatFallback(token, end);
+#endif
+  token = tokenEnd;
+  return f;
+}
+
+// Parse triples: i, i/j/k, i//k, i/j
+static vertex_index parseTripleInPlace(
+  const char* &token,
+  const char* end,
+  int vsize,
+  int vnsize,
+  int vtsize)
+{
+    vertex_index vi(-1);
+
+    vi.v_idx = fixIndex(parseIntInPlace(token, end), vsize);
+    token = skipIndex(token, end);
+    if (peekChar(token, end, 0) != '/') {
+      return vi;
+    }
+    token++;
+
+    // i//k
+    if (peekChar(token, end, 0) == '/') {
+      token++;
+      vi.vn_idx = fixIndex(parseIntInPlace(token, end), vnsize);
+      token = skipIndex(token, end);
+      return vi;
+    }
+
+    // i/j/k or i/j
+    vi.vt_idx = fixIndex(parseIntInPlace(token, end), vtsize);
+    token = skipIndex(token, end);
+    if (peekChar(token, end, 0) != '/') {
+      return vi;
+    }
+
+    // i/j/k
+    token++;  // skip '/'
+    vi.vn_idx = fixIndex(parseIntInPlace(token, end), vnsize);
+    token = skipIndex(token, end);
+    return vi;
+}
+
+// sscanf(token, "%s", namebuf)
+static inline std::string parseWord(const char* token, const char* end)
+{
+  while (token < end && isCSpace(*token)) token++;
+  const char* wordEnd = token;
+  while (wordEnd < end && !isCSpace(*wordEnd)) wordEnd++;
+  return std::string(token, wordEnd);
+}
+
+static inline bool startsWith(const char* token, const char* end, const char* prefix, size_t len)
+{
+  return (size_t)(end - token) >= len && 0 == strncmp(token, prefix, len);
+}
+
+// Splits the next line of [cursor, fileEnd) the way std::istream::getline with
+// an 8192-byte buffer does in LoadObj: the line stops at '\n' and at an embedded
+// '\0', one trailing '\r' is trimmed, and an overlong line ends the parse.
+// Returns false when there is nothing left to read.
+static inline bool nextLine(const char*& cursor, const char* fileEnd,
+                            const char*& lineBegin, const char*& lineEnd, bool& stop)
+{
+  static const size_t maxchars = 8192;
+  if (cursor >= fileEnd || stop) return false;
+
+  const char* newline = (const char*)memchr(cursor, '\n', fileEnd - cursor);
+  const char* rawEnd = newline ? newline : fileEnd;
+  lineBegin = cursor;
+
+  if ((size_t)(rawEnd - cursor) > maxchars - 1) {
+    // getline stored maxchars - 1 characters and set failbit: LoadObj still
+    // parses them, then stops reading.
+    rawEnd = cursor + maxchars - 1;
+    stop = true;
+  }
+  cursor = newline && !stop ? newline + 1 : rawEnd;
+
+  const char* nul = (const char*)memchr(lineBegin, '\0', rawEnd - lineBegin);
+  lineEnd = nul ? nul : rawEnd;
+  if (lineEnd > lineBegin && lineEnd[-1] == '\r') lineEnd--;
+  return true;
+}
+
+std::string
+LoadObjMapped(
+  std::vector<shape_t>& shapes,
+  std::vector<material_t>& materials,   // [output]
+  const char* filename,
+  const char* mtl_basepath)
+{
+  shapes.clear();
+
+  std::stringstream err;
+
+  glimac::MappedFile file;
+  if (!file.open(filename)) {
+    err << "Cannot open file [" << filename << "]" << std::endl;
+    return err.str();
+  }
+
+  std::string basePath;
+  if (mtl_basepath) {
+    basePath = mtl_basepath;
+  }
+  MaterialFileReader readMatFn( basePath );
+
+  std::vector<float> v;
+  std::vector<float> vn;
+  std::vector<float> vt;
+  face_group faceGroup;
+  std::string name;
+
+  // material
+  std::map<std::string, int> material_map;
+  int  material = -1;
+
+  shape_t shape;
+
+  const char* cursor = file.data();
+  const char* fileEnd = file.data() + file.size();
+  const char* lineBegin;
+  const char* end;
+  bool stop = false;
+  while (nextLine(cursor, fileEnd, lineBegin, end, stop)) {
+
+    // Skip leading space.
+    const char* token = skipSpaceTab(lineBegin, end);
+
+    if (token == end) continue; // empty line
+
+    if (token[0] == '#') continue;  // comment line
+
+    // vertex
+    if (token[0] == 'v' && isSpace(peekChar(token, end, 1))) {
+      token += 2;
+      float x = parseFloatInPlace(token, end);
+      float y = parseFloatInPlace(token, end);
+      float z = parseFloatInPlace(token, end);
+      v.push_back(x);
+      v.push_back(y);
+      v.push_back(z);
+      continue;
+    }
+
+    // normal
+    if (token[0] == 'v' && peekChar(token, end, 1) == 'n' && isSpace(peekChar(token, end, 2))) {
+      token += 3;
+      float x = parseFloatInPlace(token, end);
+      float y = parseFloatInPlace(token, end);
+      float z = parseFloatInPlace(token, end);
+      vn.push_back(x);
+      vn.push_back(y);
+      vn.push_back(z);
+      continue;
+    }
+
+    // texcoord
+    if (token[0] == 'v' && peekChar(token, end, 1) == 't' && isSpace(peekChar(token, end, 2))) {
+      token += 3;
+      float x = parseFloatInPlace(token, end);
+      float y = parseFloatInPlace(token, end);
+      vt.push_back(x);
+      vt.push_back(y);
+      continue;
+    }
+
+    // face
+    if (token[0] == 'f' && isSpace(peekChar(token, end, 1))) {
+      token += 2;
+      token = skipSpaceTab(token, end);
+
+      size_t first = faceGroup.corners.size();
+      while (!isNewLine(peekChar(token, end, 0))) {
+        vertex_index vi = parseTripleInPlace(token, end, v.size() / 3, vn.size() / 3, vt.size() / 2);
+        faceGroup.corners.push_back(vi);
+        token = skipSpaceTabCR(token, end);
+      }
+
+      faceGroup.sizes.push_back(faceGroup.corners.size() - first);
+
+      continue;
+    }
+
+    // use mtl
+    if (startsWith(token, end, "usemtl", 6) && isSpace(peekChar(token, end, 6))) {
+      token += 7;
+      std::string namebuf = parseWord(token, end);
+
+      exportFaceGroupToShape(shape, v, vn, vt, faceGroup, material, name);
+      faceGroup.clear();
+
+      if (material_map.find(namebuf) != material_map.end()) {
+        material = material_map[namebuf];
+      } else {
+        // { error!! material not found }
+        material = -1;
+      }
+
+      continue;
+    }
+
+    // load mtl
+    if (startsWith(token, end, "mtllib", 6) && isSpace(peekChar(token, end, 6))) {
+      token += 7;
+      std::string namebuf = parseWord(token, end);
+
+      std::string err_mtl = readMatFn(namebuf, materials, material_map);
+      if (!err_mtl.empty()) {
+        faceGroup.clear();  // for safety
+        return err_mtl;
+      }
+
+      continue;
+    }
+
+    // group name
+    if (token[0] == 'g' && isSpace(peekChar(token, end, 1))) {
+
+      // flush previous face group.
+      bool ret = exportFaceGroupToShape(shape, v, vn, vt, faceGroup, material, name);
+      if (ret) {
+        shapes.push_back(shape);
+      }
+
+      shape = shape_t();
+
+      //material = -1;
+      faceGroup.clear();
+
+      // names[0] is 'g' itself: only the first name after it is kept
+      int nameCount = 0;
+      name = "";
+      while (!isNewLine(peekChar(token, end, 0))) {
+        const char* nameEnd = skipToken(token, end);
+        if (nameCount == 1) {
+          name.assign(token, nameEnd);
+        }
+        nameCount++;
+        token = skipSpaceTabCR(nameEnd, end); // skip tag
+      }
+
+      continue;
+    }
+
+    // object name
+    if (token[0] == 'o' && isSpace(peekChar(token, end, 1))) {
+
+      // flush previous face group.
+      bool ret = exportFaceGroupToShape(shape, v, vn, vt, faceGroup, material, name);
+      if (ret) {
+        shapes.push_back(shape);
+      }
+
+      //material = -1;
+      faceGroup.clear();
+      shape = shape_t();
+
+      // @todo { multiple object name? }
+      token += 2;
+      name = parseWord(token, end);
+
+      continue;
+    }
+
+    // Ignore unknown command.
+  }
+
+  bool ret = exportFaceGroupToShape(shape, v, vn, vt, faceGroup, material, name);
+  if (ret) {
+    shapes.push_back(shape);
+  }
+  faceGroup.clear();  // for safety
+
+  return err.str();
+}
+
+
+//
+// Parallel loader.
+//
+// The file is cut into chunks at line boundaries and each chunk is parsed on
+// its own into local v/vn/vt arrays. Face corners are resolved against the
+// local counts and flagged when they were relative (negative), and the other
+// commands (usemtl, mtllib, g, o) are recorded with the number of faces seen
+// before them. Once all chunks are parsed, the vertex arrays are concatenated,
+// the relative indices are resolved chunk by chunk and the commands are
+// replayed in file order to cut the corners into shapes, so shapes, materials
+// and errors come out exactly as with LoadObjMapped. Each shape is then
+// deduplicated and exported on its own task.
+//
+
+struct obj_command {
+  enum type_t { USEMTL, MTLLIB, GROUP, OBJECT };
+
+  type_t type;
+  size_t faceCount;    // faces of the chunk that come before this command
+  size_t cornerCount;  // and their corners
+  std::string name;
+};
+
+struct obj_chunk {
+  std::vector<float> v;
+  std::vector<float> vn;
+  std::vector<float> vt;
+  std::vector<vertex_index> corners;
+  std::vector<unsigned char> relative;  // per corner, bit 0: v, bit 1: vt, bit 2: vn
+  std::vector<unsigned int> faceSizes;
+  std::vector<obj_command> commands;
+  bool stop;                            // an overlong line ended the parse here
+
+  obj_chunk() : stop(false) {}
+};
+
+static inline unsigned char relativeBit(int idx, unsigned char bit)
+{
+  return (idx < 0) ? bit : 0;
+}
+
+// Same as parseTripleInPlace, also reporting which indices were relative.
+static vertex_index parseTripleRelative(
+  const char* &token,
+  const char* end,
+  int vsize,
+  int vnsize,
+  int vtsize,
+  unsigned char& relative)
+{
+    vertex_index vi(-1);
+    relative = 0;
+
+    int idx = parseIntInPlace(token, end);
+    relative |= relativeBit(idx, 1);
+    vi.v_idx = fixIndex(idx, vsize);
+    token = skipIndex(token, end);
+    if (peekChar(token, end, 0) != '/') {
+      return vi;
+    }
+    token++;
+
+    // i//k
+    if (peekChar(token, end, 0) == '/') {
+      token++;
+      idx = parseIntInPlace(token, end);
+      relative |= relativeBit(idx, 4);
+      vi.vn_idx = fixIndex(idx, vnsize);
+      token = skipIndex(token, end);
+      return vi;
+    }
+
+    // i/j/k or i/j
+    idx = parseIntInPlace(token, end);
+    relative |= relativeBit(idx, 2);
+    vi.vt_idx = fixIndex(idx, vtsize);
+    token = skipIndex(token, end);
+    if (peekChar(token, end, 0) != '/') {
+      return vi;
+    }
+
+    // i/j/k
+    token++;  // skip '/'
+    idx = parseIntInPlace(token, end);
+    relative |= relativeBit(idx, 4);
+    vi.vn_idx = fixIndex(idx, vnsize);
+    token = skipIndex(token, end);
+    return vi;
+}
+
+static void parseChunk(const char* begin, const char* fileEnd, obj_chunk& chunk)
+{
+  const char* cursor = begin;
+  const char* lineBegin;
+  const char* end;
+  while (nextLine(cursor, fileEnd, lineBegin, end, chunk.stop)) {
+
+    // Skip leading space.
+    const char* token = skipSpaceTab(lineBegin, end);
+
+    if (token == end) continue; // empty line
+
+    if (token[0] == '#') continue;  // comment line
+
+    // vertex
+    if (token[0] == 'v' && isSpace(peekChar(token, end, 1))) {
+      token += 2;
+      float x = parseFloatInPlace(token, end);
+      float y = parseFloatInPlace(token, end);
+      float z = parseFloatInPlace(token, end);
+      chunk.v.push_back(x);
+      chunk.v.push_back(y);
+      chunk.v.push_back(z);
+      continue;
+    }
+
+    // normal
+    if (token[0] == 'v' && peekChar(token, end, 1) == 'n' && isSpace(peekChar(token, end, 2))) {
+      token += 3;
+      float x = parseFloatInPlace(token, end);
+      float y = parseFloatInPlace(token, end);
+      float z = parseFloatInPlace(token, end);
+      chunk.vn.push_back(x);
+      chunk.vn.push_back(y);
+      chunk.vn.push_back(z);
+      continue;
+    }
+
+    // texcoord
+    if (token[0] == 'v' && peekChar(token, end, 1) == 't' && isSpace(peekChar(token, end, 2))) {
+      token += 3;
+      float x = parseFloatInPlace(token, end);
+      float y = parseFloatInPlace(token, end);
+      chunk.vt.push_back(x);
+      chunk.vt.push_back(y);
+      continue;
+    }
+
+    // face
+    if (token[0] == 'f' && isSpace(peekChar(token, end, 1))) {
+      token += 2;
+      token = skipSpaceTab(token, end);
+
+      size_t first = chunk.corners.size();
+      while (!isNewLine(peekChar(token, end, 0))) {
+        unsigned char relative;
+        vertex_index vi = parseTripleRelative(token, end, chunk.v.size() / 3, chunk.vn.size() / 3, chunk.vt.size() / 2, relative);
+        chunk.corners.push_back(vi);
+        chunk.relative.push_back(relative);
+        token = skipSpaceTabCR(token, end);
+      }
+      chunk.faceSizes.push_back(chunk.corners.size() - first);
+
+      continue;
+    }
+
+    obj_command command;
+    command.faceCount = chunk.faceSizes.size();
+    command.cornerCount = chunk.corners.size();
+
+    // use mtl
+    if (startsWith(token, end, "usemtl", 6) && isSpace(peekChar(token, end, 6))) {
+      command.type = obj_command::USEMTL;
+      command.name = parseWord(token + 7, end);
+      chunk.commands.push_back(command);
+      continue;
+    }
+
+    // load mtl
+    if (startsWith(token, end, "mtllib", 6) && isSpace(peekChar(token, end, 6))) {
+      command.type = obj_command::MTLLIB;
+      command.name = parseWord(token + 7, end);
+      chunk.commands.push_back(command);
+      continue;
+    }
+
+    // group name
+    if (token[0] == 'g' && isSpace(peekChar(token, end, 1))) {
+      // names[0] is 'g' itself: only the first name after it is kept
+      int nameCount = 0;
+      while (!isNewLine(peekChar(token, end, 0))) {
+        const char* nameEnd = skipToken(token, end);
+        if (nameCount == 1) {
+          command.name.assign(token, nameEnd);
+        }
+        nameCount++;
+        token = skipSpaceTabCR(nameEnd, end); // skip tag
+      }
+      command.type = obj_command::GROUP;
+      chunk.commands.push_back(command);
+      continue;
+    }
+
+    // object name
+    if (token[0] == 'o' && isSpace(peekChar(token, end, 1))) {
+      command.type = obj_command::OBJECT;
+      command.name = parseWord(token + 2, end);
+      chunk.commands.push_back(command);
+      continue;
+    }
+
+    // Ignore unknown command.
+  }
+}
+
+// Turns the chunk-local relative indices into global ones, given where the
+// chunk's vertices start in the concatenated arrays.
+static void resolveRelativeIndices(
+  obj_chunk& chunk,
+  int vOffset,
+  int vnOffset,
+  int vtOffset)
+{
+  for (size_t corner = 0; corner < chunk.corners.size(); corner++) {
+    unsigned char relative = chunk.relative[corner];
+    if (relative & 1) chunk.corners[corner].v_idx += vOffset;
+    if (relative & 2) chunk.corners[corner].vt_idx += vtOffset;
+    if (relative & 4) chunk.corners[corner].vn_idx += vnOffset;
+  }
+  std::vector<unsigned char>().swap(chunk.relative);
+}
+
+// Appends the faces [face, lastFace) of a chunk, whose corners end at
+// lastCorner, to faceGroup: both arrays are copied as contiguous ranges.
+static void appendChunkFaces(
+  const obj_chunk& chunk,
+  size_t& face,
+  size_t& corner,
+  size_t lastFace,
+  size_t lastCorner,
+  face_group& faceGroup)
+{
+  faceGroup.corners.insert(faceGroup.corners.end(), chunk.corners.begin() + corner, chunk.corners.begin() + lastCorner);
+  faceGroup.sizes.insert(faceGroup.sizes.end(), chunk.faceSizes.begin() + face, chunk.faceSizes.begin() + lastFace);
+  face = lastFace;
+  corner = lastCorner;
+}
+
+// The face groups (one per usemtl) that end up in the same shape_t.
+struct obj_shape_plan {
+  std::string name;
+  std::vector<face_group> groups;
+  std::vector<int> materials;
+};
+
+// Vertices are only deduplicated within a face group, so every shape can be
+// exported on its own task; shapes are appended in file order.
+static void exportShapes(
+  std::vector<obj_shape_plan>& plans,
+  const std::vector<float>& v,
+  const std::vector<float>& vn,
+  const std::vector<float>& vt,
+  glimac::ThreadPool& pool,
+  std::vector<shape_t>& shapes)
+{
+  std::vector<shape_t> exported(plans.size());
+  std::vector<std::future<void> > done;
+  for (size_t i = 0; i < plans.size(); i++) {
+    shape_t* shape = &exported[i];
+    const obj_shape_plan* plan = &plans[i];
+    done.push_back(pool.submit([shape, plan, &v, &vn, &vt]() {
+      for (size_t g = 0; g < plan->groups.size(); g++) {
+        exportFaceGroupToShape(*shape, v, vn, vt, plan->groups[g], plan->materials[g], plan->name);
+      }
+    }));
+  }
+  for (size_t i = 0; i < done.size(); i++) {
+    done[i].get();
+  }
+  for (size_t i = 0; i < exported.size(); i++) {
+    shapes.push_back(std::move(exported[i]));
+  }
+}
+
+std::string
+LoadObjParallel(
+  std::vector<shape_t>& shapes,
+  std::vector<material_t>& materials,   // [output]
+  const char* filename,
+  glimac::ThreadPool& pool,
+  const char* mtl_basepath)
+{
+  // Below this size a chunk is not worth a task.
+  static const size_t minChunkSize = 1 << 20;
+
+  shapes.clear();
+
+  std::stringstream err;
+
+  glimac::MappedFile file;
+  if (!file.open(filename)) {
+    err << "Cannot open file [" << filename << "]" << std::endl;
+    return err.str();
+  }
+
+  std::string basePath;
+  if (mtl_basepath) {
+    basePath = mtl_basepath;
+  }
+  MaterialFileReader readMatFn( basePath );
+
+  // Split at line boundaries: each chunk but the last ends right after a '\n'.
+  const char* fileBegin = file.data();
+  const char* fileEnd = file.data() + file.size();
+  size_t chunkCount = std::max<size_t>(1, std::min<size_t>(pool.getThreadCount(), file.size() / minChunkSize));
+  std::vector<const char*> bounds(1, fileBegin);
+  for (size_t i = 1; i < chunkCount; i++) {
+    const char* target = fileBegin + file.size() / chunkCount * i;
+    if (target <= bounds.back()) continue;
+    const char* newline = (const char*)memchr(target, '\n', fileEnd - target);
+    if (!newline) break;
+    bounds.push_back(newline + 1);
+  }
+  bounds.push_back(fileEnd);
+  chunkCount = bounds.size() - 1;
+
+  std::vector<obj_chunk> chunks(chunkCount);
+  std::vector<std::future<void> > parsed;
+  for (size_t i = 0; i < chunkCount; i++) {
+    obj_chunk* chunk = &chunks[i];
+    const char* begin = bounds[i];
+    const char* end = bounds[i + 1];
+    parsed.push_back(pool.submit([chunk, begin, end]() { parseChunk(begin, end, *chunk); }));
+  }
+  for (size_t i = 0; i < parsed.size(); i++) {
+    parsed[i].get();
+  }
+
+  // An overlong line stops LoadObj: the chunks after it are dropped.
+  for (size_t i = 0; i < chunkCount; i++) {
+    if (chunks[i].stop) {
+      chunks.resize(i + 1);
+      break;
+    }
+  }
+
+  // Global attribute arrays, and where each chunk starts in them.
+  std::vector<int> vOffsets, vnOffsets, vtOffsets;
+  size_t vSize = 0, vnSize = 0, vtSize = 0;
+  for (size_t i = 0; i < chunks.size(); i++) {
+    vOffsets.push_back(vSize / 3);
+    vnOffsets.push_back(vnSize / 3);
+    vtOffsets.push_back(vtSize / 2);
+    vSize += chunks[i].v.size();
+    vnSize += chunks[i].vn.size();
+    vtSize += chunks[i].vt.size();
+  }
+  std::vector<float> v, vn, vt;
+  v.reserve(vSize);
+  vn.reserve(vnSize);
+  vt.reserve(vtSize);
+  for (size_t i = 0; i < chunks.size(); i++) {
+    v.insert(v.end(), chunks[i].v.begin(), chunks[i].v.end());
+    vn.insert(vn.end(), chunks[i].vn.begin(), chunks[i].vn.end());
+    vt.insert(vt.end(), chunks[i].vt.begin(), chunks[i].vt.end());
+    std::vector<float>().swap(chunks[i].v);
+    std::vector<float>().swap(chunks[i].vn);
+    std::vector<float>().swap(chunks[i].vt);
+  }
+
+  // Relative indices only depend on the chunk's own offsets.
+  std::vector<std::future<void> > resolved;
+  for (size_t i = 1; i < chunks.size(); i++) {
+    obj_chunk* chunk = &chunks[i];
+    int vOffset = vOffsets[i], vnOffset = vnOffsets[i], vtOffset = vtOffsets[i];
+    resolved.push_back(pool.submit([chunk, vOffset, vnOffset, vtOffset]() { resolveRelativeIndices(*chunk, vOffset, vnOffset, vtOffset); }));
+  }
+  for (size_t i = 0; i < resolved.size(); i++) {
+    resolved[i].get();
+  }
+
+  // Replay the commands in file order. A face group is flushed into the
+  // current shape on usemtl; the shape is kept on g/o or at the end of the
+  // file only if its last face group is not empty, as in LoadObjMapped.
+  std::vector<obj_shape_plan> plans;
+  obj_shape_plan plan;
+  face_group faceGroup;
+  std::string name;
+  std::string err_mtl;
+
+  // material
+  std::map<std::string, int> material_map;
+  int  material = -1;
+
+  for (size_t i = 0; i < chunks.size() && err_mtl.empty(); i++) {
+    const obj_chunk& chunk = chunks[i];
+    size_t face = 0, corner = 0;
+
+    for (size_t c = 0; c < chunk.commands.size() && err_mtl.empty(); c++) {
+      const obj_command& command = chunk.commands[c];
+      appendChunkFaces(chunk, face, corner, command.faceCount, command.cornerCount, faceGroup);
+
+      switch (command.type) {
+      case obj_command::USEMTL:
+        if (!faceGroup.empty()) {
+          plan.groups.push_back(std::move(faceGroup));
+          plan.materials.push_back(material);
+          faceGroup = face_group();
+        }
+
+        if (material_map.find(command.name) != material_map.end()) {
+          material = material_map[command.name];
+        } else {
+          // { error!! material not found }
+          material = -1;
+        }
+        break;
+
+      case obj_command::MTLLIB:
+        err_mtl = readMatFn(command.name, materials, material_map);
+        break;
+
+      case obj_command::GROUP:
+      case obj_command::OBJECT:
+        // flush previous face group.
+        if (!faceGroup.empty()) {
+          plan.groups.push_back(std::move(faceGroup));
+          plan.materials.push_back(material);
+          plan.name = name;
+          plans.push_back(std::move(plan));
+        }
+
+        plan = obj_shape_plan();
+
+        //material = -1;
+        faceGroup = face_group();
+
+        name = command.name;
+        break;
+      }
+    }
+
+    if (err_mtl.empty()) {
+      appendChunkFaces(chunk, face, corner, chunk.faceSizes.size(), chunk.corners.size(), faceGroup);
+    }
+  }
+
+  // A material error stops the file there: the shape being built is dropped.
+  if (err_mtl.empty() && !faceGroup.empty()) {
+    plan.groups.push_back(std::move(faceGroup));
+    plan.materials.push_back(material);
+    plan.name = name;
+    plans.push_back(std::move(plan));
+  }
+  std::vector<obj_chunk>().swap(chunks);
+
+  exportShapes(plans, v, vn, vt, pool, shapes);
+
+  if (!err_mtl.empty()) {
+    return err_mtl;
+  }
+
+  return err.str();
+}
+
 }
@@ -10,6 +10,10 @@
 #include <vector>
 #include <map>
 
+namespace glimac {
+class ThreadPool;
+}
+
 namespace tinyobj {
 
 typedef struct
@@ -87,6 +91,29 @@ std::string LoadObj(
     const char* filename,
     const char* mtl_basepath = NULL);
 
+/// Loads .obj from a file by memory-mapping it and tokenizing each line in
+/// place (no per-line copy or allocation, numbers parsed with from_chars).
+/// Produces exactly the same 'shapes' and 'materials' as LoadObj.
+/// Returns empty string when loading .obj success.
+std::string LoadObjMapped(
+    std::vector<shape_t>& shapes,   // [output]
+    std::vector<material_t>& materials,   // [output]
+    const char* filename,
+    const char* mtl_basepath = NULL);
+
+/// Same as LoadObjMapped, but the file is split into chunks at line boundaries
+/// that are parsed concurrently on 'pool' before being stitched back together
+/// in file order; the shapes are then deduplicated and exported concurrently.
+/// Produces exactly the same 'shapes' and 'materials' as LoadObj.
+/// Must not be called from a task running on 'pool'.
+/// Returns empty string when loading .obj success.
+std::string LoadObjParallel(
+    std::vector<shape_t>& shapes,   // [output]
+    std::vector<material_t>& materials,   // [output]
+    const char* filename,
+    glimac::ThreadPool& pool,
+    const char* mtl_basepath = NULL);
+
 /// Loads object from a std::istream, uses GetMtlIStreamFn to retrieve
 /// std::istream for materials.
 /// Returns empty string when loading .obj success.
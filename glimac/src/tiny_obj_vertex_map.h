@@ -0,0 +1,109 @@
+//
+// Vertex cache of the OBJ loaders, shared with the benchmarks.
+//
+
+#ifndef _TINY_OBJ_VERTEX_MAP_H
+#define _TINY_OBJ_VERTEX_MAP_H
+
+#include <cstddef>
+#include <vector>
+
+namespace tinyobj {
+
+struct vertex_index {
+  int v_idx, vt_idx, vn_idx;
+  vertex_index() {};
+  vertex_index(int idx) : v_idx(idx), vt_idx(idx), vn_idx(idx) {};
+  vertex_index(int vidx, int vtidx, int vnidx) : v_idx(vidx), vt_idx(vtidx), vn_idx(vnidx) {};
+
+};
+static inline bool operator==(const vertex_index& a, const vertex_index& b)
+{
+  return a.v_idx == b.v_idx && a.vt_idx == b.vt_idx && a.vn_idx == b.vn_idx;
+}
+
+// Open-addressing (linear probing) hash map from a vertex_index triple to the
+// index of the vertex emitted for it. Keys and values live in flat arrays, so a
+// lookup is a hash and a short scan instead of a std::map tree walk.
+class vertex_index_map {
+public:
+  // 'expected' is an estimate of the number of distinct keys: the table is
+  // sized to stay at most half full with that many, and doubles beyond.
+  explicit vertex_index_map(size_t expected)
+    : size_(0)
+  {
+    size_t capacity = 16;
+    while (capacity < 2 * expected) capacity <<= 1;
+    allocate(capacity);
+  }
+
+  // Returns the value stored for 'key', or inserts 'value' and returns it.
+  unsigned int find_or_insert(const vertex_index& key, unsigned int value, bool& inserted)
+  {
+    if (2 * (size_ + 1) > keys_.size()) {
+      grow();
+    }
+    size_t slot = hash(key) & mask_;
+    while (values_[slot] != kEmpty) {
+      if (keys_[slot] == key) {
+        inserted = false;
+        return values_[slot];
+      }
+      slot = (slot + 1) & mask_;
+    }
+    keys_[slot] = key;
+    values_[slot] = value;
+    size_++;
+    inserted = true;
+    return value;
+  }
+
+  size_t size() const { return size_; }
+
+  // Number of slots currently allocated (one key and one value each).
+  size_t capacity() const { return keys_.size(); }
+
+private:
+  static constexpr unsigned int kEmpty = 0xffffffffu;
+
+  static inline size_t hash(const vertex_index& key)
+  {
+    unsigned long long h = (unsigned int)key.v_idx;
+    h = h * 0x9E3779B97F4A7C15ull ^ (unsigned int)key.vt_idx;
+    h = h * 0x9E3779B97F4A7C15ull ^ (unsigned int)key.vn_idx;
+    h *= 0x9E3779B97F4A7C15ull;
+    return (size_t)(h ^ (h >> 32));
+  }
+
+  void allocate(size_t capacity)
+  {
+    keys_.assign(capacity, vertex_index(-1));
+    values_.assign(capacity, kEmpty);
+    mask_ = capacity - 1;
+  }
+
+  void grow()
+  {
+    std::vector<vertex_index> keys;
+    std::vector<unsigned int> values;
+    keys.swap(keys_);
+    values.swap(values_);
+    allocate(2 * keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+      if (values[i] == kEmpty) continue;
+      size_t slot = hash(keys[i]) & mask_;
+      while (values_[slot] != kEmpty) slot = (slot + 1) & mask_;
+      keys_[slot] = keys[i];
+      values_[slot] = values[i];
+    }
+  }
+
+  std::vector<vertex_index> keys_;
+  std::vector<unsigned int> values_;
+  size_t mask_;
+  size_t size_;
+};
+
+}
+
+#endif  // _TINY_OBJ_VERTEX_MAP_H
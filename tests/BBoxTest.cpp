@@ -0,0 +1,95 @@
+#include <limits>
+#include <random>
+#include <glimac/BBox.hpp>
+#include <glimac/ThreadPool.hpp>
+#include "TestCommon.hpp"
+
+// BBox3f::fromPoints (réductions SSE, découpage entre threads) doit donner exactement la boîte obtenue
+// en ajoutant les points un par un: pour tous les restes modulo la largeur des registres, avec l'extrême
+// à chaque position, pour des points serrés (vec3) ou espacés (sommets entrelacés), et quel que soit le pool
+
+static const size_t STRIDES[] = { sizeof(glm::vec3), sizeof(glm::vec4), 32 };
+
+static glimac::BBox3f reference(const std::vector<char>& buffer, size_t count, size_t stride) {
+    glimac::BBox3f box = glimac::BBox3f::emptyBox();
+    for (size_t i = 0; i < count; ++i) {
+        box.grow(*reinterpret_cast<const glm::vec3*>(buffer.data() + i * stride));
+    }
+    return box;
+}
+
+// Tampon de count points espacés de stride octets, sans rien après le dernier point (un débordement
+// de lecture serait vu par les outils mémoire), les octets entre les points étant remplis de valeurs extrêmes
+static std::vector<char> makePoints(size_t count, size_t stride, std::mt19937& rng) {
+    std::uniform_real_distribution<float> value(-100.f, 100.f);
+    std::vector<char> buffer(count ? (count - 1) * stride + sizeof(glm::vec3) : 0);
+    for (size_t i = 0; i < count; ++i) {
+        float* p = reinterpret_cast<float*>(buffer.data() + i * stride);
+        for (size_t k = 0; k < stride / sizeof(float) && (i + 1 < count || k < 3); ++k) {
+            p[k] = k < 3 ? value(rng) : (k % 2 ? 1e30f : -1e30f);
+        }
+    }
+    return buffer;
+}
+
+static glm::vec3& pointAt(std::vector<char>& buffer, size_t stride, size_t i) {
+    return *reinterpret_cast<glm::vec3*>(buffer.data() + i * stride);
+}
+
+static void testSmallCounts() {
+    std::mt19937 rng(1);
+    bool exact = true, empty = true;
+    for (size_t stride : STRIDES) {
+        for (size_t count = 0; count <= 21; ++count) {
+            std::vector<char> buffer = makePoints(count, stride, rng);
+            for (size_t extreme = 0; extreme < count; ++extreme) {
+                // Chaque axe a son minimum et son maximum sur un point différent
+                std::vector<char> points = buffer;
+                pointAt(points, stride, extreme) = glm::vec3(1000.f, -1000.f, 500.f);
+                pointAt(points, stride, (extreme + 1) % count).z = -777.f;
+                auto box = glimac::BBox3f::fromPoints(reinterpret_cast<const glm::vec3*>(points.data()), count, stride);
+                exact = exact && box == reference(points, count, stride);
+            }
+            if (count == 0) {
+                empty = empty && glimac::BBox3f::fromPoints(nullptr, 0, stride).empty();
+            }
+        }
+    }
+    CHECK(exact);
+    CHECK(empty);
+}
+
+static void testLargeCounts() {
+    std::mt19937 rng(2);
+    glimac::ThreadPool single(1), several(4);
+    for (size_t stride : STRIDES) {
+        for (size_t count : { size_t(65535), size_t(300001) }) {
+            std::vector<char> points = makePoints(count, stride, rng);
+            pointAt(points, stride, count - 1) = glm::vec3(-5000.f, 5000.f, 0.f); // dans le reste scalaire
+            pointAt(points, stride, count / 2).z = 9000.f;                         // à la frontière de deux tâches
+            auto expected = reference(points, count, stride);
+            auto pPoints = reinterpret_cast<const glm::vec3*>(points.data());
+            CHECK(glimac::BBox3f::fromPoints(pPoints, count, stride) == expected);
+            CHECK(glimac::BBox3f::fromPoints(pPoints, count, stride, single) == expected);
+            CHECK(glimac::BBox3f::fromPoints(pPoints, count, stride, several) == expected);
+        }
+    }
+}
+
+static void testSpecialValues() {
+    // Un seul point, infinis, boîte plate
+    glm::vec3 single(3.f, -2.f, 1.f);
+    CHECK(glimac::BBox3f::fromPoints(&single, 1) == glimac::BBox3f(single));
+    const float inf = std::numeric_limits<float>::infinity();
+    std::vector<glm::vec3> points = { glm::vec3(0.f), glm::vec3(inf, 1, 2), glm::vec3(-inf, 3, 2), glm::vec3(1, -1, 2), glm::vec3(2, 2, 2) };
+    auto box = glimac::BBox3f::fromPoints(points.data(), points.size());
+    CHECK(box.lower == glm::vec3(-inf, -1, 0));
+    CHECK(box.upper == glm::vec3(inf, 3, 2));
+}
+
+int main() {
+    testSmallCounts();
+    testLargeCounts();
+    testSpecialValues();
+    return test::result();
+}
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <random>
+#include <glimac/BVH.hpp>
+#include <glimac/Sphere.hpp>
+#include "TestCommon.hpp"
+
+// Requêtes de la BVH comparées à un parcours exhaustif des primitives: les requêtes renvoient un
+// sur-ensemble qui, filtré par le même test que la recherche exhaustive, doit donner exactement son résultat.
+// closestHit et closestTriangle doivent trouver le même triangle à la même distance
+
+using glimac::BBox3f;
+using glimac::BVH;
+
+static std::vector<BBox3f> randomBoxes(size_t count, std::mt19937& rng) {
+    std::uniform_real_distribution<float> position(-100.f, 100.f), size(0.f, 4.f);
+    std::vector<BBox3f> boxes;
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 lower(position(rng), position(rng), position(rng));
+        boxes.push_back(BBox3f(lower, lower + glm::vec3(size(rng), size(rng), size(rng))));
+    }
+    // Boîtes confondues et boîte réduite à un point: le découpage ne doit pas boucler
+    for (int i = 0; i < 20; ++i) {
+        boxes.push_back(BBox3f(glm::vec3(5.f), glm::vec3(6.f)));
+    }
+    boxes.push_back(BBox3f(glm::vec3(-3.f)));
+    return boxes;
+}
+
+// Filtre result par predicate, et vérifie qu'aucune primitive n'y apparaît deux fois
+template<typename Predicate>
+static std::vector<uint32_t> filter(std::vector<uint32_t> result, Predicate predicate, bool& unique) {
+    std::sort(result.begin(), result.end());
+    unique = unique && std::adjacent_find(result.begin(), result.end()) == result.end();
+    result.erase(std::remove_if(result.begin(), result.end(), [&](uint32_t i) { return !predicate(i); }), result.end());
+    return result;
+}
+
+// Inclusion exacte (glimac::subset a une tolérance relative qui se trompe de sens pour les coordonnées négatives)
+static bool contains(const BBox3f& outer, const BBox3f& inner) {
+    return glm::all(glm::lessThanEqual(outer.lower, inner.lower)) && glm::all(glm::lessThanEqual(inner.upper, outer.upper));
+}
+
+template<typename Predicate>
+static std::vector<uint32_t> bruteForce(size_t count, Predicate predicate) {
+    std::vector<uint32_t> result;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (predicate(i)) {
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+
+static void testStructure() {
+    std::mt19937 rng(1);
+    auto boxes = randomBoxes(5000, rng);
+    BVH bvh(boxes);
+
+    // Chaque primitive est dans exactement une feuille dont la boîte la contient, et chaque noeud contient ses enfants
+    std::vector<int> seen(boxes.size(), 0);
+    bool contained = true;
+    const auto& nodes = bvh.getNodes();
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        if (nodes[n].isLeaf()) {
+            for (auto i = nodes[n].offset; i < nodes[n].offset + nodes[n].count; ++i) {
+                ++seen[bvh.getPrimitives()[i]];
+                contained = contained && contains(nodes[n].bounds, boxes[bvh.getPrimitives()[i]]);
+            }
+        }
+        else {
+            contained = contained && contains(nodes[n].bounds, nodes[n + 1].bounds) &&
+                        contains(nodes[n].bounds, nodes[nodes[n].offset].bounds);
+        }
+    }
+    CHECK(std::all_of(seen.begin(), seen.end(), [](int count) { return count == 1; }));
+    CHECK(contained);
+
+    // Arbre vide: aucune requête ne trouve rien
+    BVH empty;
+    std::vector<uint32_t> result;
+    empty.queryBox(BBox3f(glm::vec3(-1e6f), glm::vec3(1e6f)), result);
+    empty.queryRay(glimac::Ray(glm::vec3(0.f), glm::vec3(1.f)), result);
+    CHECK(empty.empty() && result.empty());
+    CHECK(BVH(std::vector<BBox3f>()).empty());
+}
+
+static void testQueries() {
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> position(-120.f, 120.f), size(0.f, 40.f), angle(0.f, 6.2831853f);
+    auto boxes = randomBoxes(5000, rng);
+    BVH bvh(boxes);
+    bool sameBox = true, sameFrustum = true, sameRay = true, unique = true;
+
+    for (int query = 0; query < 200; ++query) {
+        glm::vec3 lower(position(rng), position(rng), position(rng));
+        BBox3f box(lower, lower + glm::vec3(size(rng), size(rng), size(rng)));
+        auto overlaps = [&](uint32_t i) { return glimac::conjoint(boxes[i], box); };
+        std::vector<uint32_t> result;
+        bvh.queryBox(box, result);
+        sameBox = sameBox && filter(result, overlaps, unique) == bruteForce(boxes.size(), overlaps);
+
+        // Caméra placée au hasard, regardant dans une direction quelconque
+        glm::vec3 eye(position(rng), position(rng), position(rng));
+        glm::vec3 direction(std::cos(angle(rng)), std::sin(angle(rng)) * 0.5f, std::sin(angle(rng)));
+        glimac::Frustum frustum(glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.5f, 150.f) *
+                                glm::lookAt(eye, eye + direction, glm::vec3(0, 1, 0)));
+        auto visible = [&](uint32_t i) { return frustum.intersects(boxes[i]); };
+        result.clear();
+        bvh.queryFrustum(frustum, result);
+        sameFrustum = sameFrustum && filter(result, visible, unique) == bruteForce(boxes.size(), visible);
+
+        glimac::Ray ray(eye, direction, 1.f, 80.f);
+        const glm::vec3 invDirection = 1.f / ray.direction;
+        auto crossed = [&](uint32_t i) {
+            float tEntry;
+            return glimac::intersectBox(boxes[i], ray.origin, invDirection, ray.tMin, ray.tMax, tEntry);
+        };
+        result.clear();
+        bvh.queryRay(ray, result);
+        sameRay = sameRay && filter(result, crossed, unique) == bruteForce(boxes.size(), crossed);
+    }
+    CHECK(sameBox);
+    CHECK(sameFrustum);
+    CHECK(sameRay);
+    CHECK(unique);
+}
+
+static void testClosestTriangle() {
+    // Sphère plus une grille de triangles aléatoires: des rayons qui traversent plusieurs surfaces
+    glimac::Sphere sphere(10.f, 64, 32);
+    std::vector<glm::vec3> positions;
+    for (GLsizei i = 0; i < sphere.getIndexedVertexCount(); ++i) {
+        positions.push_back(sphere.getIndexedDataPointer()[i].position);
+    }
+    std::vector<unsigned int> indices(sphere.getIndexPointer(), sphere.getIndexPointer() + sphere.getIndexCount());
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> position(-30.f, 30.f), offset(-2.f, 2.f);
+    for (int i = 0; i < 2000; ++i) {
+        glm::vec3 center(position(rng), position(rng), position(rng));
+        unsigned int first = positions.size();
+        for (int k = 0; k < 3; ++k) {
+            positions.push_back(center + glm::vec3(offset(rng), offset(rng), offset(rng)));
+        }
+        indices.insert(indices.end(), { first, first + 1, first + 2 });
+    }
+    const size_t triangleCount = indices.size() / 3;
+    BVH bvh = BVH::fromTriangles(positions.data(), sizeof(glm::vec3), indices.data(), triangleCount);
+
+    auto intersect = [&](uint32_t i, const glimac::Ray& ray, float& t) {
+        return glimac::intersectTriangle(ray, positions[indices[3 * i]], positions[indices[3 * i + 1]], positions[indices[3 * i + 2]], t);
+    };
+    bool same = true, sameCallback = true, found = false;
+    for (int query = 0; query < 500; ++query) {
+        glm::vec3 origin(position(rng), position(rng), position(rng));
+        glm::vec3 target(position(rng) * 0.3f, position(rng) * 0.3f, position(rng) * 0.3f);
+        glimac::Ray ray(origin, target - origin, query % 2 ? 0.f : 0.2f, query % 3 ? 2.f : 0.7f);
+
+        bool expectedHit = false;
+        glimac::RayHit expected = { 0, ray.tMax };
+        for (uint32_t i = 0; i < triangleCount; ++i) {
+            float t;
+            if (intersect(i, ray, t) && t >= ray.tMin && t <= expected.t) {
+                expected = { i, t };
+                expectedHit = true;
+            }
+        }
+        glimac::RayHit hit = { 0, 0.f }, callbackHit = { 0, 0.f };
+        bool triangleHit = bvh.closestTriangle(ray, positions.data(), sizeof(glm::vec3), indices.data(), hit);
+        bool closestHit = bvh.closestHit(ray, callbackHit, intersect);
+        same = same && triangleHit == expectedHit && (!expectedHit || (hit.t == expected.t && hit.primitive == expected.primitive));
+        sameCallback = sameCallback && closestHit == expectedHit &&
+                       (!expectedHit || (callbackHit.t == expected.t && callbackHit.primitive == expected.primitive));
+        found = found || expectedHit;
+    }
+    CHECK(found);
+    CHECK(same);
+    CHECK(sameCallback);
+
+    // Rayon tiré du centre de la sphère seule: touche la sphère à t = rayon (au facteur de facettes près)
+    BVH sphereBVH = BVH::fromTriangles(positions.data(), sizeof(glm::vec3), indices.data(), sphere.getIndexCount() / 3);
+    glimac::RayHit hit;
+    CHECK(sphereBVH.closestTriangle(glimac::Ray(glm::vec3(0.f), glm::vec3(0, 1, 0.01f)), positions.data(), sizeof(glm::vec3), indices.data(), hit));
+    CHECK(hit.t > 9.9f && hit.t <= 10.01f);
+}
+
+int main() {
+    testStructure();
+    testQueries();
+    testClosestTriangle();
+    return test::result();
+}
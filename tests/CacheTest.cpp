@@ -0,0 +1,139 @@
+#include <filesystem>
+#include <fstream>
+#include <glimac/Geometry.hpp>
+#include "TestCommon.hpp"
+
+// Aller-retour par le cache ".cache" de Geometry::loadOBJ: un second chargement doit relire le cache
+// et redonner exactement les mêmes données, et le cache doit être ignoré dès que le .mtl ou mtlBasePath change
+
+namespace fs = std::filesystem;
+
+static void writeFile(const fs::path& path, const std::string& content) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << content;
+}
+
+// Réécrit le fichier en gardant sa taille et sa date: seul le contenu permet de voir s'il a été relu
+static void rewriteKeepingStamp(const fs::path& path, const std::string& content) {
+    fs::file_time_type time = fs::last_write_time(path);
+    writeFile(path, content);
+    fs::last_write_time(path, time);
+}
+
+// Réécrit le fichier avec une date clairement différente, même sur un système de fichiers peu précis
+static void rewriteWithNewStamp(const fs::path& path, const std::string& content) {
+    fs::file_time_type time = fs::last_write_time(path);
+    writeFile(path, content);
+    fs::last_write_time(path, time + std::chrono::hours(1));
+}
+
+static std::string objContent(const char* x) {
+    return std::string("mtllib colors.mtl\nusemtl color\nv 0 0 0\nv ") + x + " 0 0\nv 0 1 0\nv 0 0 1\nf 1 2 3\nf 1 3 4\n";
+}
+
+static std::string mtlContent(const char* kd) {
+    return std::string("newmtl color\nKd ") + kd + "\n";
+}
+
+static bool sameGeometry(const glimac::Geometry& a, const glimac::Geometry& b) {
+    if (a.getVertexCount() != b.getVertexCount() || a.getIndexCount() != b.getIndexCount() ||
+        a.getMeshCount() != b.getMeshCount() || a.getMaterialCount() != b.getMaterialCount()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.getVertexCount(); ++i) {
+        const glimac::Geometry::Vertex& va = a.getVertexBuffer()[i];
+        const glimac::Geometry::Vertex& vb = b.getVertexBuffer()[i];
+        if (va.m_Position != vb.m_Position || va.m_Normal != vb.m_Normal || va.m_TexCoords != vb.m_TexCoords) {
+            return false;
+        }
+    }
+    if (!std::equal(a.getIndexBuffer(), a.getIndexBuffer() + a.getIndexCount(), b.getIndexBuffer())) {
+        return false;
+    }
+    for (size_t i = 0; i < a.getMeshCount(); ++i) {
+        const glimac::Geometry::Mesh& ma = a.getMeshBuffer()[i];
+        const glimac::Geometry::Mesh& mb = b.getMeshBuffer()[i];
+        if (ma.m_sName != mb.m_sName || ma.m_nIndexOffset != mb.m_nIndexOffset ||
+            ma.m_nIndexCount != mb.m_nIndexCount || ma.m_nMaterialIndex != mb.m_nMaterialIndex) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < a.getMaterialCount(); ++i) {
+        if (a.getMaterialBuffer()[i].m_Kd != b.getMaterialBuffer()[i].m_Kd) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static glm::vec3 diffuse(const glimac::Geometry& geometry) {
+    return geometry.getMaterialCount() > 0 ? geometry.getMaterialBuffer()[0].m_Kd : glm::vec3(-1.f);
+}
+
+static float maxX(const glimac::Geometry& geometry) {
+    return geometry.getBoundingBox().upper.x;
+}
+
+int main() {
+    const fs::path directory = fs::temp_directory_path() / "glimac_cache_test";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    // FilePath retire le séparateur final: mtlBasePath est un préfixe collé au nom donné par "mtllib"
+    const fs::path objPath = directory / "mesh.obj";
+    const fs::path mtlPath = directory / "a_colors.mtl";
+    const fs::path otherMtlPath = directory / "b_colors.mtl";
+    const std::string basePath = (directory / "a_").string();
+    const std::string otherBasePath = (directory / "b_").string();
+
+    writeFile(objPath, objContent("1"));
+    writeFile(mtlPath, mtlContent("1 0 0"));
+    writeFile(otherMtlPath, mtlContent("0 0 1"));
+
+    // Premier chargement: analyse du texte et écriture du cache
+    glimac::Geometry parsed;
+    CHECK(parsed.loadOBJ(objPath.string(), basePath, false));
+    CHECK(fs::exists(directory / "mesh.obj.cache"));
+    CHECK(parsed.getIndexCount() == 6);
+    CHECK(diffuse(parsed) == glm::vec3(1, 0, 0));
+    CHECK(maxX(parsed) == 1.f);
+
+    // Même taille et même date: le cache est relu, le nouveau contenu du .obj n'est pas vu
+    rewriteKeepingStamp(objPath, objContent("2"));
+    glimac::Geometry cached;
+    CHECK(cached.loadOBJ(objPath.string(), basePath, false));
+    CHECK(sameGeometry(cached, parsed));
+    CHECK(maxX(cached) == 1.f);
+
+    // Le .mtl a changé: le cache ne vaut plus rien, le .obj est analysé de nouveau
+    rewriteWithNewStamp(mtlPath, mtlContent("0 1 0"));
+    glimac::Geometry mtlChanged;
+    CHECK(mtlChanged.loadOBJ(objPath.string(), basePath, false));
+    CHECK(diffuse(mtlChanged) == glm::vec3(0, 1, 0));
+    CHECK(maxX(mtlChanged) == 2.f);
+
+    // Le cache réécrit est de nouveau valable
+    glimac::Geometry recached;
+    CHECK(recached.loadOBJ(objPath.string(), basePath, false));
+    CHECK(sameGeometry(recached, mtlChanged));
+
+    // Un autre mtlBasePath désigne un autre .mtl, même si rien n'a changé sur le disque
+    glimac::Geometry otherBase;
+    CHECK(otherBase.loadOBJ(objPath.string(), otherBasePath, false));
+    CHECK(diffuse(otherBase) == glm::vec3(0, 0, 1));
+
+    // Un .mtl supprimé invalide aussi le cache: le .obj est analysé de nouveau, sans aucun matériau
+    fs::remove(otherMtlPath);
+    glimac::Geometry missingMtl;
+    CHECK(missingMtl.loadOBJ(objPath.string(), otherBasePath, false));
+    CHECK(missingMtl.getMaterialCount() == 0);
+    CHECK(missingMtl.getMeshCount() == 1 && missingMtl.getMeshBuffer()[0].m_nMaterialIndex == -1);
+    CHECK(maxX(missingMtl) == 2.f);
+
+    // Le cache réécrit sans matériau redonne la même chose
+    glimac::Geometry missingMtlCached;
+    CHECK(missingMtlCached.loadOBJ(objPath.string(), otherBasePath, false));
+    CHECK(sameGeometry(missingMtlCached, missingMtl));
+
+    fs::remove_all(directory);
+    return test::result();
+}
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <glimac/BVH.hpp>
+#include <glimac/Frustum.hpp>
+#include <glimac/Scene.hpp>
+#include "TestCommon.hpp"
+
+// Frustum culling d'un million de boîtes: Frustum::testBoxes, BVH::queryFrustum et Scene::cull comparés
+// à un test exact en double précision sur les 8 coins de chaque boîte. Les boîtes à moins de MARGIN d'un
+// plan dépendent de l'arrondi et ne sont pas comparées
+
+static const size_t BOX_COUNT = 1000000;
+static const double MARGIN = 1e-3;
+
+enum Expected { OUTSIDE, VISIBLE, AMBIGUOUS };
+
+// Une boîte est dehors si ses 8 coins sont derrière un même plan
+static Expected expected(const glimac::Frustum& frustum, const glimac::BBox3f& box) {
+    bool ambiguous = false;
+    for (const auto& plane : frustum.planes) {
+        const glm::dvec3 normal(plane);
+        const double length = glm::length(normal);
+        double farthest = -std::numeric_limits<double>::infinity();
+        for (int corner = 0; corner < 8; ++corner) {
+            glm::dvec3 p(corner & 1 ? box.upper.x : box.lower.x, corner & 2 ? box.upper.y : box.lower.y, corner & 4 ? box.upper.z : box.lower.z);
+            farthest = std::max(farthest, (glm::dot(normal, p) + double(plane.w)) / length);
+        }
+        if (farthest < -MARGIN) {
+            return OUTSIDE;
+        }
+        ambiguous = ambiguous || farthest <= MARGIN;
+    }
+    return ambiguous ? AMBIGUOUS : VISIBLE;
+}
+
+static std::vector<glimac::BBox3f> randomBoxes(std::mt19937& rng) {
+    std::uniform_real_distribution<float> position(-200.f, 200.f), size(0.f, 3.f);
+    std::vector<glimac::BBox3f> boxes(BOX_COUNT);
+    for (auto& box : boxes) {
+        glm::vec3 lower(position(rng), position(rng) * 0.2f, position(rng));
+        box = glimac::BBox3f(lower, lower + glm::vec3(size(rng), size(rng), size(rng)));
+    }
+    return boxes;
+}
+
+static glimac::Frustum camera(const glm::vec3& eye, const glm::vec3& target) {
+    return glimac::Frustum(glm::perspective(glm::radians(70.f), 16.f / 9.f, 0.1f, 120.f) * glm::lookAt(eye, target, glm::vec3(0, 1, 0)));
+}
+
+static void testBoxes(const std::vector<glimac::BBox3f>& boxes, const glimac::BVH& bvh) {
+    const glimac::Frustum frustums[] = { camera(glm::vec3(0, 5, 0), glm::vec3(10, 0, 3)), camera(glm::vec3(-150, 40, 120), glm::vec3(0.f)),
+                                         camera(glm::vec3(300, 0, 0), glm::vec3(400, 0, 0)) };
+    std::vector<unsigned char> visible(boxes.size());
+    for (size_t f = 0; f < 3; ++f) {
+        const glimac::Frustum& frustum = frustums[f];
+        std::vector<Expected> reference(boxes.size());
+        size_t expectedVisible = 0;
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            reference[i] = expected(frustum, boxes[i]);
+            expectedVisible += reference[i] == VISIBLE;
+        }
+        // Les deux premières caméras regardent les boîtes, la dernière regarde ailleurs
+        CHECK((expectedVisible > 0) == (f < 2));
+
+        size_t visibleCount = frustum.testBoxes(boxes.data(), boxes.size(), visible.data());
+        bool same = true, sameClassify = true;
+        size_t counted = 0;
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            counted += visible[i];
+            same = same && (reference[i] == AMBIGUOUS || bool(visible[i]) == (reference[i] == VISIBLE));
+            sameClassify = sameClassify && (reference[i] == AMBIGUOUS || frustum.intersects(boxes[i]) == (reference[i] == VISIBLE));
+        }
+        CHECK(visibleCount == counted);
+        CHECK(visibleCount >= expectedVisible);
+        CHECK(same);
+        CHECK(sameClassify);
+
+        // La BVH renvoit un sur-ensemble: il doit contenir toutes les boîtes visibles, chacune une fois
+        std::vector<uint32_t> result;
+        bvh.queryFrustum(frustum, result);
+        std::sort(result.begin(), result.end());
+        CHECK(std::adjacent_find(result.begin(), result.end()) == result.end());
+        size_t found = std::count_if(result.begin(), result.end(), [&](uint32_t i) { return reference[i] == VISIBLE; });
+        CHECK(found == expectedVisible);
+    }
+    CHECK(frustums[2].testBoxes(boxes.data(), boxes.size(), visible.data()) == 0);
+}
+
+static void testScene(const std::vector<glimac::BBox3f>& boxes) {
+    // Un million d'entités sous 1000 pivots tournés et déplacés, certaines sans maillage ou sans boîte
+    glimac::Scene scene;
+    const size_t PIVOT_COUNT = 1000;
+    scene.reserve(PIVOT_COUNT + boxes.size());
+    for (size_t p = 0; p < PIVOT_COUNT; ++p) {
+        glm::mat4 matrix = glm::rotate(glm::translate(glm::mat4(1.f), glm::vec3(p % 10, 0, p / 100)), float(p) * 0.01f, glm::vec3(0, 1, 0));
+        scene.create(glimac::NO_ENTITY, matrix);
+    }
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        glimac::Entity entity = scene.create(i % PIVOT_COUNT);
+        if (i % 97 != 0) {
+            scene.setMesh(entity, 0);
+        }
+        if (i % 89 != 0) {
+            scene.setLocalBounds(entity, boxes[i]);
+        }
+    }
+    scene.updateWorldMatrices();
+
+    glimac::Frustum frustum = camera(glm::vec3(0, 5, 0), glm::vec3(10, 0, 3));
+    std::vector<unsigned char> visible;
+    size_t visibleCount = scene.cull(frustum, visible);
+    CHECK(visible.size() == scene.size());
+
+    bool same = true, pivotsHidden = true;
+    size_t counted = 0;
+    for (glimac::Entity e = 0; e < scene.size(); ++e) {
+        counted += visible[e];
+        if (e < PIVOT_COUNT) {
+            pivotsHidden = pivotsHidden && !visible[e];
+            continue;
+        }
+        size_t i = e - PIVOT_COUNT;
+        bool drawable = i % 97 != 0;
+        if (i % 89 == 0) {
+            // Sans boîte: jamais éliminée si elle est dessinée
+            same = same && bool(visible[e]) == drawable;
+        }
+        else {
+            Expected reference = expected(frustum, scene.getWorldBounds(e));
+            same = same && (reference == AMBIGUOUS || bool(visible[e]) == (drawable && reference == VISIBLE));
+        }
+    }
+    CHECK(visibleCount == counted);
+    CHECK(visibleCount > 0 && visibleCount < scene.getDrawableCount());
+    CHECK(same);
+    CHECK(pivotsHidden);
+}
+
+int main() {
+    std::mt19937 rng(4);
+    auto boxes = randomBoxes(rng);
+    glimac::BVH bvh(boxes);
+    testBoxes(boxes, bvh);
+    testScene(boxes);
+    return test::result();
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+#include <iostream>
+#ifdef GLIMAC_TEST_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+namespace test {
+
+// Contexte OpenGL 3.3 core pour les tests qui ont besoin du GPU. Avec EGL (Mesa), le contexte est créé
+// sans surface ni affichage, sinon dans une fenêtre GLFW cachée.
+// Si aucun des deux n'est possible, isValid() renvoit false et le test doit renvoyer TEST_SKIPPED
+class GLTestContext {
+public:
+    GLTestContext() {
+#ifdef GLIMAC_TEST_EGL
+        if (createEGLContext()) {
+            return;
+        }
+#endif
+        createGLFWContext();
+    }
+
+    ~GLTestContext() {
+#ifdef GLIMAC_TEST_EGL
+        if (m_nFramebuffer) {
+            glDeleteFramebuffers(1, &m_nFramebuffer);
+            glDeleteRenderbuffers(2, m_Renderbuffers);
+        }
+        if (m_EGLDisplay != EGL_NO_DISPLAY) {
+            eglMakeCurrent(m_EGLDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (m_EGLContext != EGL_NO_CONTEXT) {
+                eglDestroyContext(m_EGLDisplay, m_EGLContext);
+            }
+            eglTerminate(m_EGLDisplay);
+        }
+#endif
+        if (m_pWindow) {
+            glfwDestroyWindow(m_pWindow);
+        }
+        if (m_bGLFWInitialized) {
+            glfwTerminate();
+        }
+    }
+
+    bool isValid() const {
+        return m_bValid;
+    }
+
+private:
+    GLTestContext(const GLTestContext&);
+    GLTestContext& operator =(const GLTestContext&);
+
+#ifdef GLIMAC_TEST_EGL
+    bool createEGLContext() {
+        auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (!getPlatformDisplay) {
+            return false;
+        }
+        m_EGLDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (m_EGLDisplay == EGL_NO_DISPLAY) {
+            return false;
+        }
+        EGLint major, minor;
+        if (!eglInitialize(m_EGLDisplay, &major, &minor) || !eglBindAPI(EGL_OPENGL_API)) {
+            return false;
+        }
+        const EGLint configAttributes[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+        EGLConfig config;
+        EGLint configCount = 0;
+        eglChooseConfig(m_EGLDisplay, configAttributes, &config, 1, &configCount);
+        const EGLint contextAttributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 3,
+            EGL_CONTEXT_MINOR_VERSION, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        m_EGLContext = eglCreateContext(m_EGLDisplay, configCount > 0 ? config : EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttributes);
+        if (m_EGLContext == EGL_NO_CONTEXT || !eglMakeCurrent(m_EGLDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, m_EGLContext)) {
+            return false;
+        }
+        if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+            return false;
+        }
+
+        // sans surface, il n'y a pas de framebuffer par défaut dans lequel dessiner
+        glGenRenderbuffers(2, m_Renderbuffers);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_Renderbuffers[0]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 64, 64);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_Renderbuffers[1]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 64, 64);
+        glGenFramebuffers(1, &m_nFramebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_nFramebuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_Renderbuffers[0]);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_Renderbuffers[1]);
+        glViewport(0, 0, 64, 64);
+        m_bValid = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        return m_bValid;
+    }
+
+    EGLDisplay m_EGLDisplay = EGL_NO_DISPLAY;
+    EGLContext m_EGLContext = EGL_NO_CONTEXT;
+    GLuint m_nFramebuffer = 0;
+    GLuint m_Renderbuffers[2] = {};
+#endif
+
+    void createGLFWContext() {
+        m_bGLFWInitialized = glfwInit() != 0;
+        if (!m_bGLFWInitialized) {
+            std::cerr << "glfwInit failed: no display, skipping" << std::endl;
+            return;
+        }
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        m_pWindow = glfwCreateWindow(64, 64, "test", nullptr, nullptr);
+        if (!m_pWindow) {
+            std::cerr << "no OpenGL 3.3 context available, skipping" << std::endl;
+            return;
+        }
+        glfwMakeContextCurrent(m_pWindow);
+        m_bValid = gladLoadGLLoader((GLADloadproc)glfwGetProcAddress) != 0;
+        if (!m_bValid) {
+            std::cerr << "glad could not load OpenGL, skipping" << std::endl;
+        }
+    }
+
+    bool m_bGLFWInitialized = false;
+    GLFWwindow* m_pWindow = nullptr;
+    bool m_bValid = false;
+};
+
+}
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <glimac/LightClusters.hpp>
+#include "TestCommon.hpp"
+
+// Répartition des lumières dans les clusters: tranches de profondeur (même calcul que le shader), listes
+// d'indices bien formées, et assignation conservative: un point de la sphère d'une lumière, projeté comme
+// un fragment, tombe toujours dans un cluster qui contient cette lumière
+
+const float zNear = 0.1f, zFar = 100.f;
+
+// Cluster du fragment correspondant à un point du repère de la vue, comme lights.fs.glsl
+// (gl_FragCoord.xy * tuiles / taille du framebuffer revient à (ndc * 0.5 + 0.5) * tuiles). false s'il n'est pas visible
+static bool fragmentCluster(const glimac::LightClusters& clusters, const glm::mat4& projection, const glm::vec3& point, size_t& index) {
+    glm::vec4 clip = projection * glm::vec4(point, 1.f);
+    float depth = -point.z;
+    if (depth < zNear || depth > zFar || std::abs(clip.x) > clip.w || std::abs(clip.y) > clip.w) {
+        return false;
+    }
+    glm::vec2 ndc = glm::vec2(clip) / clip.w;
+    glm::vec2 tile = glm::floor((ndc * 0.5f + 0.5f) * glm::vec2(clusters.getTileCountX(), clusters.getTileCountY()));
+    glm::vec2 depthScale = clusters.getDepthScale();
+    float slice = std::floor(std::log(depth) * depthScale.x + depthScale.y);
+    index = clusters.getClusterIndex(unsigned(glm::clamp(tile.x, 0.f, float(clusters.getTileCountX() - 1))),
+                                     unsigned(glm::clamp(tile.y, 0.f, float(clusters.getTileCountY() - 1))),
+                                     unsigned(glm::clamp(slice, 0.f, float(clusters.getSliceCount() - 1))));
+    return true;
+}
+
+static bool clusterContains(const glimac::LightClusters& clusters, size_t index, uint32_t light) {
+    const auto& cluster = clusters.getCluster(index);
+    auto begin = clusters.getLightIndices().begin() + cluster.offset;
+    return std::binary_search(begin, begin + cluster.count, light);
+}
+
+static void testSlices() {
+    glimac::LightClusters clusters(16, 9, 24);
+    clusters.setProjection(glm::perspective(glm::radians(70.f), 16.f / 9.f, zNear, zFar), zNear, zFar);
+    CHECK(clusters.getClusterCount() == 16 * 9 * 24);
+    CHECK(clusters.getSlice(zNear) == 0);
+    CHECK(clusters.getSlice(0.01f) == 0);
+    CHECK(clusters.getSlice(zFar * 0.999f) == 23);
+    CHECK(clusters.getSlice(1000.f) == 23);
+
+    // Tranches exponentielles: la tranche k commence à zNear * (zFar / zNear)^(k / 24)
+    bool boundaries = true, monotonic = true;
+    for (unsigned k = 1; k < 24; ++k) {
+        float start = zNear * std::pow(zFar / zNear, k / 24.f);
+        boundaries = boundaries && clusters.getSlice(start * 1.001f) == k && clusters.getSlice(start * 0.999f) == k - 1;
+    }
+    unsigned previous = 0;
+    for (float depth = zNear; depth < zFar; depth *= 1.01f) {
+        monotonic = monotonic && clusters.getSlice(depth) >= previous;
+        previous = clusters.getSlice(depth);
+    }
+    CHECK(boundaries);
+    CHECK(monotonic);
+}
+
+static void testLists(const glimac::LightClusters& clusters, size_t lightCount) {
+    // Clusters rangés les uns à la suite des autres, indices croissants sans doublon
+    uint32_t offset = 0;
+    bool contiguous = true, sorted = true;
+    for (size_t c = 0; c < clusters.getClusterCount(); ++c) {
+        const auto& cluster = clusters.getCluster(c);
+        contiguous = contiguous && cluster.offset == offset;
+        auto begin = clusters.getLightIndices().begin() + cluster.offset;
+        sorted = sorted && std::adjacent_find(begin, begin + cluster.count, std::greater_equal<uint32_t>()) == begin + cluster.count &&
+                 std::all_of(begin, begin + cluster.count, [&](uint32_t light) { return light < lightCount; });
+        offset += cluster.count;
+    }
+    CHECK(contiguous);
+    CHECK(sorted);
+    CHECK(offset == clusters.getLightIndices().size());
+}
+
+static void testConservative(const glm::mat4& projection) {
+    glimac::LightClusters clusters(16, 9, 24);
+    clusters.setProjection(projection, zNear, zFar);
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> side(-1.f, 1.f), depth(0.f, 1.f), radius(0.05f, 3.f);
+    std::vector<glm::vec4> lights;
+    for (int i = 0; i < 300; ++i) {
+        // Répartition en profondeur exponentielle, comme les tranches: des lumières proches et lointaines
+        float z = zNear * std::pow(zFar / zNear, depth(rng));
+        lights.push_back(glm::vec4(side(rng) * z, side(rng) * z * 0.6f, -z, radius(rng)));
+    }
+    clusters.build(lights.data(), lights.size());
+    testLists(clusters, lights.size());
+
+    // Points tirés dans chaque sphère, dont le centre et les points extrêmes sur les axes
+    std::normal_distribution<float> gaussian;
+    size_t tested = 0;
+    bool found = true;
+    for (uint32_t i = 0; i < lights.size(); ++i) {
+        glm::vec3 center(lights[i]);
+        std::vector<glm::vec3> points = { center };
+        for (int axis = 0; axis < 3; ++axis) {
+            glm::vec3 offset(0.f);
+            offset[axis] = lights[i].w * 0.999f;
+            points.push_back(center + offset);
+            points.push_back(center - offset);
+        }
+        for (int k = 0; k < 200; ++k) {
+            glm::vec3 direction = glm::normalize(glm::vec3(gaussian(rng), gaussian(rng), gaussian(rng)) + glm::vec3(1e-6f));
+            points.push_back(center + direction * lights[i].w * std::cbrt(depth(rng)) * 0.999f);
+        }
+        for (const auto& point : points) {
+            size_t index;
+            if (fragmentCluster(clusters, projection, point, index)) {
+                found = found && clusterContains(clusters, index, i);
+                ++tested;
+            }
+        }
+    }
+    CHECK(tested > 10000);
+    CHECK(found);
+}
+
+static void testSpecialLights() {
+    glimac::LightClusters clusters(16, 9, 24);
+    clusters.setProjection(glm::perspective(glm::radians(70.f), 16.f / 9.f, zNear, zFar), zNear, zFar);
+    std::vector<glm::vec4> lights = {
+        glm::vec4(0, 0, 5, 1),         // derrière la caméra
+        glm::vec4(0, 0, -200, 10),     // au-delà du plan lointain
+        glm::vec4(0, 0, 0, 1000),      // englobe tout le frustum
+        glm::vec4(0.1f, 0, -10, 0.01f) // petite lumière: quelques clusters seulement
+    };
+    clusters.build(lights.data(), lights.size());
+    testLists(clusters, lights.size());
+
+    size_t everywhere = 0, small = 0;
+    bool hidden = true;
+    for (size_t c = 0; c < clusters.getClusterCount(); ++c) {
+        for (uint32_t k = 0; k < clusters.getCluster(c).count; ++k) {
+            uint32_t light = clusters.getLightIndices()[clusters.getCluster(c).offset + k];
+            hidden = hidden && light >= 2;
+            everywhere += light == 2;
+            small += light == 3;
+        }
+    }
+    CHECK(hidden);
+    CHECK(everywhere == clusters.getClusterCount());
+    CHECK(small >= 1 && small <= 8);
+
+    // Sans lumière, tous les clusters sont vides
+    clusters.build(nullptr, 0);
+    CHECK(clusters.getLightIndices().empty());
+    CHECK(std::all_of(clusters.getClusters().begin(), clusters.getClusters().end(),
+                      [](const glimac::LightClusters::Cluster& cluster) { return cluster.count == 0; }));
+}
+
+int main() {
+    testSlices();
+    testConservative(glm::perspective(glm::radians(70.f), 16.f / 9.f, zNear, zFar));
+    // Projection décentrée (glm::frustum): les termes P[2][0] et P[2][1] ne sont pas nuls
+    testConservative(glm::frustum(-0.05f, 0.15f, -0.04f, 0.08f, zNear, zFar));
+    testSpecialLights();
+    return test::result();
+}
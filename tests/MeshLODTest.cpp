@@ -0,0 +1,124 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <glimac/BVH.hpp>
+#include <glimac/MeshLOD.hpp>
+#include "TestCommon.hpp"
+
+// Choix du niveau de détail: seuils de MeshLOD, taille à l'écran calculée par computeScreenSize, et
+// distance au tronçon le plus proche cherchée dans une BVH (utilisée pour le circuit) contre une recherche exhaustive
+
+static void testThresholds() {
+    // Les niveaux ne sont pas dessinés ici: seuls leur nombre et les seuils comptent
+    std::vector<const glimac::MeshBuffer*> levels(4, nullptr);
+    glimac::MeshLOD lod(levels, glimac::MeshLOD::getDefaultScreenSizes(), 2.f);
+    CHECK(lod.getLevelCount() == 4);
+    CHECK(lod.getBoundingRadius() == 2.f);
+
+    // Seuils par défaut 160, 64, 24: un seuil atteint sélectionne déjà son niveau
+    CHECK(lod.selectLevel(std::numeric_limits<float>::max()) == 0);
+    CHECK(lod.selectLevel(1000.f) == 0);
+    CHECK(lod.selectLevel(160.f) == 0);
+    CHECK(lod.selectLevel(159.9f) == 1);
+    CHECK(lod.selectLevel(64.f) == 1);
+    CHECK(lod.selectLevel(63.9f) == 2);
+    CHECK(lod.selectLevel(24.f) == 2);
+    CHECK(lod.selectLevel(23.9f) == 3);
+    CHECK(lod.selectLevel(0.f) == 3);
+
+    // Seuils manquants complétés par 0: le dernier niveau n'est jamais choisi
+    glimac::MeshLOD incomplete(levels, std::vector<float>{ 100.f }, 1.f);
+    CHECK(incomplete.selectLevel(100.f) == 0);
+    CHECK(incomplete.selectLevel(10.f) == 1);
+    CHECK(incomplete.selectLevel(0.f) == 1);
+
+    glimac::MeshLOD single(std::vector<const glimac::MeshBuffer*>(1, nullptr), glimac::MeshLOD::getDefaultScreenSizes(), 1.f);
+    CHECK(single.selectLevel(1000.f) == 0);
+    CHECK(single.selectLevel(0.f) == 0);
+
+    bool thrown = false;
+    try {
+        glimac::MeshLOD empty(std::vector<const glimac::MeshBuffer*>(), std::vector<float>(), 1.f);
+    }
+    catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+static void testScreenSize() {
+    // fovy = 90°: cotan(fovy / 2) = 1, une sphère de rayon 1 à distance 10 couvre un dixième de la demi-hauteur
+    glm::mat4 projection = glm::perspective(glm::radians(90.f), 16.f / 9.f, 0.1f, 100.f);
+    CHECK(std::abs(glimac::computeScreenSize(1.f, 10.f, projection, 720.f) - 72.f) < 1e-3f);
+    CHECK(std::abs(glimac::computeScreenSize(1.f, 20.f, projection, 720.f) - 36.f) < 1e-3f);
+    CHECK(glimac::computeScreenSize(1.f, 0.5f, projection, 720.f) == std::numeric_limits<float>::max());
+
+    // Avec une matrice MV: distance prise sur la translation, rayon multiplié par la plus grande échelle
+    glm::mat4 MVMatrix = glm::scale(glm::translate(glm::mat4(1.f), glm::vec3(0, 0, -10)), glm::vec3(1, 3, 2));
+    CHECK(std::abs(glimac::computeScreenSize(1.f, MVMatrix, projection, 720.f) - 216.f) < 1e-3f);
+
+    // Même sphère qui s'éloigne: le niveau ne peut que devenir plus grossier
+    glimac::MeshLOD lod(std::vector<const glimac::MeshBuffer*>(4, nullptr), glimac::MeshLOD::getDefaultScreenSizes(), 1.f);
+    size_t previous = 0;
+    bool monotonic = true;
+    for (float distance = 1.f; distance < 100.f; distance += 0.5f) {
+        size_t level = lod.selectLevel(glimac::computeScreenSize(1.f, distance, projection, 720.f));
+        monotonic = monotonic && level >= previous;
+        previous = level;
+    }
+    CHECK(monotonic);
+    CHECK(previous == 3);
+}
+
+static float segmentDistance(const glm::vec3& a, const glm::vec3& b, const glm::vec3& point) {
+    glm::vec3 segment = b - a;
+    float length2 = glm::dot(segment, segment);
+    float t = length2 > 0.f ? glm::clamp(glm::dot(point - a, segment) / length2, 0.f, 1.f) : 0.f;
+    return glm::length(point - (a + t * segment));
+}
+
+static void testNearestSegment() {
+    // Circuit fermé aléatoire, comme ceux du projet: chaque point est proche du précédent
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> step(-0.5f, 0.5f), position(-20.f, 20.f);
+    std::vector<glm::vec3> points(2000);
+    points[0] = glm::vec3(0.f);
+    for (size_t i = 1; i < points.size(); ++i) {
+        points[i] = points[i - 1] + glm::vec3(step(rng), step(rng), step(rng));
+    }
+    std::vector<glimac::BBox3f> boxes;
+    for (size_t i = 0; i < points.size(); ++i) {
+        const glm::vec3& a = points[i];
+        const glm::vec3& b = points[(i + 1) % points.size()];
+        boxes.push_back(glimac::BBox3f(glm::min(a, b), glm::max(a, b)));
+    }
+    glimac::BVH bvh(boxes);
+
+    bool same = true;
+    for (int query = 0; query < 500; ++query) {
+        glm::vec3 point(position(rng), position(rng), position(rng));
+        float expected = std::numeric_limits<float>::max();
+        for (size_t i = 0; i < points.size(); ++i) {
+            expected = std::min(expected, segmentDistance(points[i], points[(i + 1) % points.size()], point));
+        }
+        float found = bvh.nearestDistance(point, [&](uint32_t i, const glm::vec3& p) {
+            return segmentDistance(points[i], points[(i + 1) % points.size()], p);
+        });
+        same = same && found == expected;
+    }
+    CHECK(same);
+
+    // Sur un tronçon la distance est nulle, et un arbre vide ne trouve rien
+    CHECK(bvh.nearestDistance(points[10], [&](uint32_t i, const glm::vec3& p) {
+        return segmentDistance(points[i], points[(i + 1) % points.size()], p);
+    }) == 0.f);
+    CHECK(std::isinf(glimac::BVH().nearestDistance(glm::vec3(0.f), [](uint32_t, const glm::vec3&) { return 0.f; })));
+}
+
+int main() {
+    testThresholds();
+    testScreenSize();
+    testNearestSegment();
+    return test::result();
+}
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <array>
+#include <random>
+#include <glimac/MeshOptimizer.hpp>
+#include "TestCommon.hpp"
+
+// Simulation du cache de sommets (ACMR/ATVR) sur des cas calculés à la main, et effet de
+// optimizeVertexCache/optimizeVertexFetch sur une grille dont les triangles ont été mélangés
+
+using glimac::simulateVertexCache;
+
+// Grille de size x size quads, deux triangles par quad, sommets numérotés à partir de firstVertex
+static std::vector<unsigned int> gridIndices(int size, unsigned int firstVertex) {
+    std::vector<unsigned int> indices;
+    indices.reserve(size_t(size) * size * 6);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            unsigned int a = firstVertex + y * (size + 1) + x, b = a + 1, c = a + size + 1, d = c + 1;
+            indices.insert(indices.end(), { a, b, d, a, d, c });
+        }
+    }
+    return indices;
+}
+
+static std::vector<unsigned int> shuffleTriangles(const std::vector<unsigned int>& indices, unsigned int seed) {
+    std::vector<size_t> order(indices.size() / 3);
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(seed));
+    std::vector<unsigned int> shuffled;
+    shuffled.reserve(indices.size());
+    for (auto triangle : order) {
+        shuffled.insert(shuffled.end(), indices.begin() + 3 * triangle, indices.begin() + 3 * triangle + 3);
+    }
+    return shuffled;
+}
+
+// Triangles triés, chacun tourné pour commencer par son plus petit indice (le sens est conservé)
+static std::vector<std::array<unsigned int, 3>> triangleSet(const std::vector<unsigned int>& indices) {
+    std::vector<std::array<unsigned int, 3>> triangles;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        std::array<unsigned int, 3> triangle = { indices[i], indices[i + 1], indices[i + 2] };
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        triangles.push_back(triangle);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+static void testSimulation() {
+    // Deux triangles partageant une arête: 4 sommets transformés une seule fois
+    const unsigned int quad[] = { 0, 1, 2, 2, 1, 3 };
+    auto stats = simulateVertexCache(quad, 6);
+    CHECK(stats.misses == 4);
+    CHECK(stats.triangles == 2);
+    CHECK(stats.vertices == 4);
+    CHECK(stats.getACMR() == 2.f);
+    CHECK(stats.getATVR() == 1.f);
+
+    // Le premier triangle est sorti du cache de 3 sommets avant d'être répété, pas de celui de 6
+    const unsigned int repeated[] = { 0, 1, 2, 3, 4, 5, 0, 1, 2 };
+    CHECK(simulateVertexCache(repeated, 9, 3).misses == 9);
+    CHECK(simulateVertexCache(repeated, 9, 6).misses == 6);
+
+    // FIFO et non LRU: le succès sur 0 ne le protège pas de l'éviction (un LRU donnerait 7)
+    const unsigned int fifo[] = { 0, 1, 2, 0, 3, 4, 0, 5, 6 };
+    CHECK(simulateVertexCache(fifo, 9, 3).misses == 8);
+
+    CHECK(simulateVertexCache(nullptr, 0).getACMR() == 0.f);
+}
+
+static void testVertexCacheOptimization() {
+    const unsigned int firstVertex = 1000; // les indices d'un mesh ne commencent pas forcément à 0
+    auto rows = gridIndices(64, firstVertex);
+    auto indices = shuffleTriangles(rows, 42);
+
+    auto shuffledStats = simulateVertexCache(indices.data(), indices.size());
+    glimac::optimizeVertexCache(indices.data(), indices.size());
+    auto optimizedStats = simulateVertexCache(indices.data(), indices.size());
+
+    CHECK(triangleSet(indices) == triangleSet(rows));
+    CHECK(optimizedStats.vertices == 65 * 65);
+    // Mélangée, la grille transforme presque 3 sommets par triangle; Tipsify descend vers 0.6,
+    // mieux que l'ordre des lignes (environ 1) qui sort chaque ligne du cache avant de la réutiliser
+    CHECK(shuffledStats.getACMR() > 2.5f);
+    CHECK(optimizedStats.getACMR() < 0.7f);
+    CHECK(optimizedStats.getACMR() < simulateVertexCache(rows.data(), rows.size()).getACMR());
+    CHECK(optimizedStats.getATVR() < 1.3f);
+}
+
+static void testVertexFetchOptimization() {
+    const unsigned int firstVertex = 10;
+    auto indices = shuffleTriangles(gridIndices(8, firstVertex), 7);
+    auto original = indices;
+
+    auto remap = glimac::optimizeVertexFetch(indices.data(), indices.size(), firstVertex, 9 * 9);
+
+    // La table est une permutation, et les indices réécrits désignent les mêmes sommets
+    CHECK(remap.size() == 9 * 9);
+    auto sortedRemap = remap;
+    std::sort(sortedRemap.begin(), sortedRemap.end());
+    for (unsigned int i = 0; i < sortedRemap.size(); ++i) {
+        CHECK(sortedRemap[i] == i);
+    }
+    bool remapped = true;
+    for (size_t i = 0; i < indices.size(); ++i) {
+        remapped = remapped && indices[i] == firstVertex + remap[original[i] - firstVertex];
+    }
+    CHECK(remapped);
+
+    // Les sommets sont numérotés dans l'ordre de leur première utilisation
+    unsigned int next = firstVertex;
+    bool firstUseOrder = true;
+    for (auto index : indices) {
+        if (index == next) {
+            ++next;
+        }
+        firstUseOrder = firstUseOrder && index < next;
+    }
+    CHECK(firstUseOrder);
+    CHECK(next == firstVertex + 9 * 9);
+}
+
+int main() {
+    testSimulation();
+    testVertexCacheOptimization();
+    testVertexFetchOptimization();
+    return test::result();
+}
@@ -0,0 +1,62 @@
+#include "GLTestContext.hpp"
+#include <glimac/Cylindre.hpp>
+#include <glimac/MeshBuffer.hpp>
+#include <glimac/Program.hpp>
+#include <glimac/RenderStats.hpp>
+#include <glimac/Sphere.hpp>
+#include "TestCommon.hpp"
+
+// Les maillages sont envoyés une seule fois à leur création: en régime établi,
+// dessiner la scène ne doit plus rien envoyer au GPU
+
+static const char* VERTEX_SHADER = R"(#version 330 core
+layout(location = 0) in vec3 aVertexPosition;
+void main() {
+    gl_Position = vec4(aVertexPosition, 1);
+}
+)";
+
+static const char* FRAGMENT_SHADER = R"(#version 330 core
+out vec4 fColor;
+void main() {
+    fColor = vec4(1);
+}
+)";
+
+int main() {
+    test::GLTestContext context;
+    if (!context.isValid()) {
+        return TEST_SKIPPED;
+    }
+
+    glimac::Program program = glimac::buildProgram(VERTEX_SHADER, FRAGMENT_SHADER);
+    program.use();
+
+    const int FRAME_COUNT = 60;
+    glimac::MeshRegistry registry;
+    size_t firstFrameBytes = 0;
+    for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+        glimac::RenderStats::beginFrame();
+        if (frame == 0) {
+            registry.add("sphere", glimac::Sphere(1, 32, 16));
+            registry.add("cylindre", glimac::Cylindre(1, 0.5f, 32, 4));
+        }
+        registry.get("sphere").draw();
+        registry.get("cylindre").draw();
+        glFinish();
+
+        if (frame == 0) {
+            firstFrameBytes = glimac::RenderStats::getUploadedByteCount();
+            CHECK(firstFrameBytes == registry.getUploadedBytes());
+        }
+        else {
+            CHECK(glimac::RenderStats::getUploadedByteCount() == 0);
+        }
+        CHECK(glimac::RenderStats::getDrawCallCount() == 2);
+    }
+    CHECK(firstFrameBytes > 0);
+    CHECK(glGetError() == GL_NO_ERROR);
+
+    registry.clear();
+    return test::result();
+}
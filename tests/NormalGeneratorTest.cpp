@@ -0,0 +1,179 @@
+#include <cmath>
+#include <glimac/NormalGenerator.hpp>
+#include <glimac/Sphere.hpp>
+#include "TestCommon.hpp"
+
+// Normales générées sur des maillages dont on connaît le résultat: plan, cube (lissé ou découpé
+// le long des arêtes), sphère (normale = position / rayon), triangles dégénérés, et même résultat
+// quel que soit le nombre de threads
+
+using glimac::generateSmoothNormals;
+
+static glimac::VertexStream<const glm::vec3> readStream(const std::vector<glm::vec3>& v) {
+    return glimac::VertexStream<const glm::vec3>{ v.data(), sizeof(glm::vec3), v.size() };
+}
+
+static glimac::VertexStream<glm::vec3> writeStream(std::vector<glm::vec3>& v) {
+    return glimac::VertexStream<glm::vec3>{ v.data(), sizeof(glm::vec3), v.size() };
+}
+
+static bool near(const glm::vec3& a, const glm::vec3& b, float epsilon = 1e-5f) {
+    return glm::all(glm::lessThanEqual(glm::abs(a - b), glm::vec3(epsilon)));
+}
+
+// Cube unité centré, 8 sommets partagés, faces orientées vers l'extérieur (sens trigonométrique)
+static void cube(std::vector<glm::vec3>& positions, std::vector<unsigned int>& indices) {
+    positions.clear();
+    for (int i = 0; i < 8; ++i) {
+        positions.push_back(glm::vec3(i & 1 ? 0.5f : -0.5f, i & 2 ? 0.5f : -0.5f, i & 4 ? 0.5f : -0.5f));
+    }
+    indices = {
+        0, 4, 6, 0, 6, 2, // -x
+        1, 3, 7, 1, 7, 5, // +x
+        0, 1, 5, 0, 5, 4, // -y
+        2, 6, 7, 2, 7, 3, // +y
+        0, 2, 3, 0, 3, 1, // -z
+        4, 5, 7, 4, 7, 6  // +z
+    };
+}
+
+static void testPlane(glimac::ThreadPool& pool) {
+    std::vector<glm::vec3> positions = { glm::vec3(0, 0, 0), glm::vec3(0, 0, 1), glm::vec3(1, 0, 1), glm::vec3(1, 0, 0) };
+    std::vector<unsigned int> indices = { 0, 1, 2, 0, 2, 3 };
+    std::vector<glm::vec3> normals(4, glm::vec3(0.f));
+    auto splits = generateSmoothNormals(indices.data(), indices.size(), readStream(positions), writeStream(normals), 0, 4, glm::radians(30.f), pool);
+    CHECK(splits.empty());
+    for (const auto& n : normals) {
+        CHECK(near(n, glm::vec3(0, 1, 0)));
+    }
+    CHECK((indices == std::vector<unsigned int>{ 0, 1, 2, 0, 2, 3 }));
+}
+
+static void testSmoothCube(glimac::ThreadPool& pool) {
+    std::vector<glm::vec3> positions;
+    std::vector<unsigned int> indices;
+    cube(positions, indices);
+    std::vector<glm::vec3> normals(8, glm::vec3(0.f));
+    auto splits = generateSmoothNormals(indices.data(), indices.size(), readStream(positions), writeStream(normals), 0, 8, glimac::NO_CREASE_ANGLE, pool);
+    CHECK(splits.empty());
+    // Chaque coin touche trois faces symétriques: la normale est la diagonale
+    for (size_t v = 0; v < 8; ++v) {
+        CHECK(near(normals[v], glm::normalize(positions[v])));
+    }
+}
+
+static void testCreasedCube(glimac::ThreadPool& pool) {
+    std::vector<glm::vec3> positions;
+    std::vector<unsigned int> indices;
+    cube(positions, indices);
+    std::vector<glm::vec3> normals(8, glm::vec3(0.f));
+    auto splits = generateSmoothNormals(indices.data(), indices.size(), readStream(positions), writeStream(normals), 0, 8, glm::radians(30.f), pool);
+
+    // Arêtes à 90°: chaque coin devient trois sommets, un par face
+    CHECK(splits.size() == 16);
+    for (const auto& split : splits) {
+        normals.push_back(split.normal);
+        positions.push_back(positions[split.source]);
+    }
+    bool flat = true, samePositions = true;
+    for (size_t t = 0; t < indices.size() / 3; ++t) {
+        const glm::vec3& p0 = positions[indices[3 * t]];
+        glm::vec3 face = glm::normalize(glm::cross(positions[indices[3 * t + 1]] - p0, positions[indices[3 * t + 2]] - p0));
+        for (int k = 0; k < 3; ++k) {
+            flat = flat && near(normals[indices[3 * t + k]], face);
+        }
+    }
+    // Les triangles d'origine n'ont pas bougé: seuls les numéros de sommets ont changé
+    std::vector<unsigned int> original;
+    std::vector<glm::vec3> originalPositions;
+    cube(originalPositions, original);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        samePositions = samePositions && positions[indices[i]] == originalPositions[original[i]];
+    }
+    CHECK(flat);
+    CHECK(samePositions);
+}
+
+static void testSphere(glimac::ThreadPool& pool) {
+    const GLsizei discLat = 64, discLong = 32;
+    glimac::Sphere sphere(2.f, discLat, discLong);
+    std::vector<glm::vec3> positions;
+    for (GLsizei i = 0; i < sphere.getIndexedVertexCount(); ++i) {
+        positions.push_back(sphere.getIndexedDataPointer()[i].position);
+    }
+    std::vector<unsigned int> indices(sphere.getIndexPointer(), sphere.getIndexPointer() + sphere.getIndexCount());
+    std::vector<glm::vec3> normals(positions.size(), glm::vec3(0.f));
+    auto splits = generateSmoothNormals(indices.data(), indices.size(), readStream(positions), writeStream(normals), 0, positions.size(),
+                                        glimac::NO_CREASE_ANGLE, pool);
+    CHECK(splits.empty());
+
+    // Hors couture et pôles (sommets dupliqués qui ne voient qu'un côté), la normale est radiale
+    float maxAngle = 0.f;
+    for (GLsizei j = 1; j < discLong; ++j) {
+        for (GLsizei i = 1; i < discLat; ++i) {
+            size_t v = j * (discLat + 1) + i;
+            glm::vec3 expected = glm::normalize(positions[v]);
+            maxAngle = glm::max(maxAngle, std::atan2(glm::length(glm::cross(normals[v], expected)), glm::dot(normals[v], expected)));
+        }
+    }
+    CHECK(maxAngle < glm::radians(0.5f));
+}
+
+static void testDegenerate(glimac::ThreadPool& pool) {
+    // Triangle plat (points alignés) et sommets hors des triangles: leurs normales restent inchangées
+    std::vector<glm::vec3> positions = { glm::vec3(0, 0, 0), glm::vec3(1, 0, 0), glm::vec3(2, 0, 0), glm::vec3(5, 5, 5) };
+    std::vector<unsigned int> indices = { 0, 1, 2 };
+    const glm::vec3 unchanged(0, 0, 1);
+    for (float creaseAngle : { glm::radians(30.f), glimac::NO_CREASE_ANGLE }) {
+        std::vector<glm::vec3> normals(4, unchanged);
+        auto splits = generateSmoothNormals(indices.data(), indices.size(), readStream(positions), writeStream(normals), 0, 4, creaseAngle, pool);
+        CHECK(splits.empty());
+        for (const auto& n : normals) {
+            CHECK(n == unchanged);
+        }
+    }
+}
+
+static void testThreadCount() {
+    // Grille bosselée assez grande pour être découpée en plusieurs tâches
+    const int SIZE = 200;
+    std::vector<glm::vec3> positions;
+    for (int y = 0; y <= SIZE; ++y) {
+        for (int x = 0; x <= SIZE; ++x) {
+            positions.push_back(glm::vec3(x, std::sin(x * 0.3f) * std::cos(y * 0.2f) * 3.f, y));
+        }
+    }
+    std::vector<unsigned int> grid;
+    for (int y = 0; y < SIZE; ++y) {
+        for (int x = 0; x < SIZE; ++x) {
+            unsigned int a = y * (SIZE + 1) + x, b = a + 1, c = a + SIZE + 1, d = c + 1;
+            grid.insert(grid.end(), { a, c, d, a, d, b });
+        }
+    }
+
+    glimac::ThreadPool single(1), several(4);
+    for (float creaseAngle : { glm::radians(20.f), glimac::NO_CREASE_ANGLE }) {
+        std::vector<unsigned int> indices1 = grid, indices4 = grid;
+        std::vector<glm::vec3> normals1(positions.size()), normals4(positions.size());
+        auto splits1 = generateSmoothNormals(indices1.data(), indices1.size(), readStream(positions), writeStream(normals1), 0, positions.size(), creaseAngle, single);
+        auto splits4 = generateSmoothNormals(indices4.data(), indices4.size(), readStream(positions), writeStream(normals4), 0, positions.size(), creaseAngle, several);
+        CHECK(indices1 == indices4);
+        CHECK(splits1.size() == splits4.size());
+        bool same = true;
+        for (size_t v = 0; v < positions.size(); ++v) {
+            same = same && near(normals1[v], normals4[v]);
+        }
+        CHECK(same);
+    }
+}
+
+int main() {
+    glimac::ThreadPool pool(2);
+    testPlane(pool);
+    testSmoothCube(pool);
+    testCreasedCube(pool);
+    testSphere(pool);
+    testDegenerate(pool);
+    testThreadCount();
+    return test::result();
+}
@@ -0,0 +1,138 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <glimac/ThreadPool.hpp>
+#include <tiny_obj_loader.h>
+#include "TestCommon.hpp"
+
+// LoadObjMapped et LoadObjParallel doivent produire exactement les formes et matériaux de LoadObj:
+// sur wagon.obj (valeurs de référence ci-dessous), sur des cas limites écrits à la main
+// et sur une grille assez grosse pour être découpée en plusieurs morceaux
+
+static bool sameShapes(const std::vector<tinyobj::shape_t>& a, const std::vector<tinyobj::shape_t>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        const tinyobj::mesh_t& meshA = a[i].mesh;
+        const tinyobj::mesh_t& meshB = b[i].mesh;
+        if (a[i].name != b[i].name || meshA.positions != meshB.positions || meshA.normals != meshB.normals ||
+            meshA.texcoords != meshB.texcoords || meshA.indices != meshB.indices || meshA.material_ids != meshB.material_ids) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool sameMaterials(const std::vector<tinyobj::material_t>& a, const std::vector<tinyobj::material_t>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].name != b[i].name || a[i].diffuse_texname != b[i].diffuse_texname ||
+            std::equal(a[i].diffuse, a[i].diffuse + 3, b[i].diffuse) == false || a[i].shininess != b[i].shininess) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Charge le fichier avec les trois chargeurs et vérifie qu'ils sont d'accord; renvoit le résultat de LoadObj
+static std::vector<tinyobj::shape_t> checkLoaders(const std::string& filename, const std::string& basePath, glimac::ThreadPool& pool) {
+    std::vector<tinyobj::shape_t> shapes, mappedShapes, parallelShapes;
+    std::vector<tinyobj::material_t> materials, mappedMaterials, parallelMaterials;
+    std::string error = tinyobj::LoadObj(shapes, materials, filename.c_str(), basePath.c_str());
+    std::string mappedError = tinyobj::LoadObjMapped(mappedShapes, mappedMaterials, filename.c_str(), basePath.c_str());
+    std::string parallelError = tinyobj::LoadObjParallel(parallelShapes, parallelMaterials, filename.c_str(), pool, basePath.c_str());
+
+    CHECK(mappedError == error);
+    CHECK(parallelError == error);
+    CHECK(sameShapes(mappedShapes, shapes));
+    CHECK(sameShapes(parallelShapes, shapes));
+    CHECK(sameMaterials(mappedMaterials, materials));
+    CHECK(sameMaterials(parallelMaterials, materials));
+    return shapes;
+}
+
+static size_t triangleCount(const std::vector<tinyobj::shape_t>& shapes) {
+    size_t count = 0;
+    for (const auto& shape : shapes) {
+        count += shape.mesh.indices.size() / 3;
+    }
+    return count;
+}
+
+// Valeurs de référence de wagon.obj
+static const size_t WAGON_SHAPE_COUNT = 1;
+static const size_t WAGON_VERTEX_COUNT = 2584;
+static const size_t WAGON_TRIANGLE_COUNT = 1674;
+
+int main() {
+    glimac::ThreadPool pool(4);
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "glimac_obj_loader_test";
+    std::filesystem::create_directories(directory);
+
+    // Modèle du projet
+    std::string assets = std::string(GLIMAC_ASSETS_DIR) + "/models/";
+    std::vector<tinyobj::shape_t> wagon = checkLoaders(assets + "wagon.obj", assets, pool);
+    CHECK(wagon.size() == WAGON_SHAPE_COUNT);
+    CHECK(wagon[0].name == "Cube");
+    CHECK(wagon[0].mesh.positions.size() == 3 * WAGON_VERTEX_COUNT);
+    CHECK(triangleCount(wagon) == WAGON_TRIANGLE_COUNT);
+    // la fin du fichier utilise "usemtl" sans nom: pas de matériau
+    CHECK(wagon[0].mesh.material_ids.front() == 0);
+    CHECK(wagon[0].mesh.material_ids.back() == -1);
+
+    // Cas limites: indices relatifs, polygones, points et lignes, groupes, objets, matériaux, CRLF, commentaires.
+    // Un "g" seul n'est pas une commande et "o empty" n'a aucune face: deux formes
+    {
+        std::ofstream mtl(directory / "edge.mtl");
+        mtl << "newmtl red\nKd 1 0 0\nnewmtl blue\nKd 0 0 1\nmap_Kd blue.png\n";
+        std::ofstream obj(directory / "edge.obj", std::ios::binary);
+        obj << "# edge cases\nmtllib edge.mtl\n"
+               "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\r\nvt 0 0\nvt 1 0\nvt 1 1\nvn 0 0 1\n"
+               "o first\nusemtl red\nf 1/1/1 2/2/1 3/3/1\nf -4/-3/-1 -3/-2/-1 -2/-1/-1 -1/-1/-1\r\n"
+               "f 1 2\nf 3\n  \t\nusemtl blue\nf 1//1 3//1 4//1\n"
+               "g group1 group2\nusemtl unknown\nf 1/1 2/2 3/3\n"
+               "g\nv 2 2 2\nf 1 -1 2 3 4\n"
+               "o empty\nusemtl red\n";
+    }
+    std::vector<tinyobj::shape_t> edge = checkLoaders((directory / "edge.obj").string(), directory.string() + "/", pool);
+    CHECK(edge.size() == 2);
+    CHECK(triangleCount(edge) == 1 + 2 + 1 + 1 + 3);
+
+    // Grille de plus de 2 Mo, découpée en morceaux par LoadObjParallel, avec des indices relatifs
+    // qui traversent les frontières des morceaux
+    {
+        const int SIZE = 200;
+        std::ofstream obj(directory / "grid.obj");
+        for (int y = 0; y <= SIZE; ++y) {
+            for (int x = 0; x <= SIZE; ++x) {
+                obj << "v " << x << " " << y * 0.5f << " " << (x * y) % 7 << "\nvt " << x / float(SIZE) << " " << y / float(SIZE) << "\n";
+            }
+        }
+        obj << "vn 0 0 1\n";
+        for (int y = 0; y < SIZE; ++y) {
+            if (y % 50 == 0) {
+                obj << "g row" << y << "\n";
+            }
+            for (int x = 0; x < SIZE; ++x) {
+                int i = y * (SIZE + 1) + x + 1;
+                int j = i + SIZE + 1;
+                if ((x + y) % 2) {
+                    obj << "f " << i << "/" << i << "/1 " << i + 1 << "/" << i + 1 << "/1 " << j + 1 << "/" << j + 1 << "/1 " << j << "/" << j << "/1\n";
+                }
+                else {
+                    obj << "v " << x << " " << y << " 1\nf -1//-1 " << i << "//1 " << i + 1 << "//1\n";
+                }
+            }
+        }
+    }
+    CHECK(std::filesystem::file_size(directory / "grid.obj") > (2u << 20));
+    std::vector<tinyobj::shape_t> grid = checkLoaders((directory / "grid.obj").string(), "", pool);
+    CHECK(grid.size() == 4);
+    CHECK(triangleCount(grid) == 200 * 200 / 2 * 2 + 200 * 200 / 2);
+
+    std::filesystem::remove_all(directory);
+    return test::result();
+}
@@ -0,0 +1,134 @@
+#include "GLTestContext.hpp"
+#include <random>
+#include <stdexcept>
+#include <glimac/MeshBuffer.hpp>
+#include <glimac/PackedVertex.hpp>
+#include <glimac/Sphere.hpp>
+#include "TestCommon.hpp"
+
+// Précision de la compression des sommets (PackedVertex), puis tailles envoyées par MeshRegistry
+// en Float et en Packed et refus des noms déjà enregistrés (cette partie a besoin d'un contexte OpenGL)
+
+using glimac::PackedVertex;
+using glimac::ShapeVertex;
+
+static glm::vec3 randomUnitVector(std::mt19937& rng) {
+    std::normal_distribution<float> gaussian;
+    glm::vec3 v;
+    do {
+        v = glm::vec3(gaussian(rng), gaussian(rng), gaussian(rng));
+    } while (glm::length(v) < 1e-3f);
+    return glm::normalize(v);
+}
+
+static void testAccuracy() {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> position(-50.f, 120.f), texCoord(0.f, 1.f);
+    std::vector<ShapeVertex> vertices;
+    for (int i = 0; i < 10000; ++i) {
+        vertices.push_back(ShapeVertex(glm::vec3(position(rng), position(rng) * 0.01f, position(rng)), randomUnitVector(rng),
+                                       glm::vec2(texCoord(rng), texCoord(rng))));
+    }
+    // Normales sur les axes et les diagonales: les arêtes et les coins repliés de l'octaèdre
+    for (int x = -1; x <= 1; ++x) {
+        for (int y = -1; y <= 1; ++y) {
+            for (int z = -1; z <= 1; ++z) {
+                if (x || y || z) {
+                    vertices.push_back(ShapeVertex(glm::vec3(0.f), glm::normalize(glm::vec3(x, y, z)), glm::vec2(0.f, 1.f)));
+                }
+            }
+        }
+    }
+
+    glimac::BBox3f bounds;
+    auto packed = glimac::packVertices(vertices.data(), vertices.size(), bounds);
+    CHECK(packed.size() == vertices.size());
+
+    // Position: un demi-pas de quantification (taille de la boîte / 65535) par axe
+    glm::vec3 maxPositionError = bounds.size() / 65535.f * 0.5f + glm::vec3(1e-5f) * glm::max(glm::abs(bounds.lower), glm::abs(bounds.upper));
+    glm::vec3 positionError(0.f);
+    float normalAngle = 0.f, texCoordError = 0.f;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        ShapeVertex unpacked = glimac::unpackVertex(packed[i], bounds);
+        positionError = glm::max(positionError, glm::abs(unpacked.position - vertices[i].position));
+        // atan2 reste précis pour de petits angles, contrairement à acos(dot)
+        normalAngle = glm::max(normalAngle, std::atan2(glm::length(glm::cross(unpacked.normal, vertices[i].normal)),
+                                                       glm::dot(unpacked.normal, vertices[i].normal)));
+        texCoordError = glm::max(texCoordError, glm::max(glm::abs(unpacked.texCoords.x - vertices[i].texCoords.x),
+                                                         glm::abs(unpacked.texCoords.y - vertices[i].texCoords.y)));
+    }
+    CHECK(positionError.x <= maxPositionError.x && positionError.y <= maxPositionError.y && positionError.z <= maxPositionError.z);
+    // Normale sur 2 x 16 bits: moins d'un centième de degré d'écart (environ 0.004° mesuré)
+    CHECK(normalAngle <= glm::radians(0.01f));
+    // Demi-flottant dans [0, 1]: 11 bits de mantisse
+    CHECK(texCoordError <= 1.f / 2048.f);
+
+    // Les coins de la boîte tombent sur les valeurs extrêmes (0 et 65535): seul l'arrondi flottant du décodage reste
+    PackedVertex upper = glimac::packVertex(ShapeVertex(bounds.upper, glm::vec3(0, 0, 1), glm::vec2(0.5f)), bounds);
+    PackedVertex lower = glimac::packVertex(ShapeVertex(bounds.lower, glm::vec3(0, 0, 1), glm::vec2(0.f)), bounds);
+    CHECK(upper.position[0] == 65535 && upper.position[1] == 65535 && upper.position[2] == 65535);
+    CHECK(lower.position[0] == 0 && lower.position[1] == 0 && lower.position[2] == 0);
+    CHECK(glimac::unpackVertex(lower, bounds).position == bounds.lower);
+    CHECK(glm::all(glm::lessThanEqual(glm::abs(glimac::unpackVertex(upper, bounds).position - bounds.upper), maxPositionError)));
+    // Un axe plat (taille nulle) est décodé sur sa coordonnée
+    glimac::BBox3f flat(glm::vec3(0, 2, 0), glm::vec3(1, 2, 1));
+    CHECK(glimac::unpackVertex(glimac::packVertex(ShapeVertex(glm::vec3(0.5f, 2, 0.5f), glm::vec3(0, 1, 0), glm::vec2(0.f)), flat), flat).position.y == 2.f);
+}
+
+static void testRegistry() {
+    test::GLTestContext context;
+    if (!context.isValid()) {
+        std::cerr << "No OpenGL context: MeshRegistry checks skipped" << std::endl;
+        return;
+    }
+
+    glimac::Sphere sphere(1, 32, 16);
+    std::vector<ShapeVertex> vertices(sphere.getIndexedDataPointer(), sphere.getIndexedDataPointer() + sphere.getIndexedVertexCount());
+    std::vector<unsigned int> indices(sphere.getIndexPointer(), sphere.getIndexPointer() + sphere.getIndexCount());
+    const size_t indexBytes = indices.size() * sizeof(unsigned int);
+
+    glimac::MeshRegistry registry;
+    const glimac::MeshBuffer& floatMesh = registry.add("float", vertices, indices);
+    const glimac::MeshBuffer& packedMesh = registry.add("packed", vertices, indices, glimac::VertexFormat::Packed);
+    CHECK(floatMesh.getUploadedBytes() == vertices.size() * 32 + indexBytes);
+    CHECK(floatMesh.getUnpackedBytes() == floatMesh.getUploadedBytes());
+    CHECK(packedMesh.getUploadedBytes() == vertices.size() * 16 + indexBytes);
+    CHECK(packedMesh.getUnpackedBytes() == floatMesh.getUploadedBytes());
+    CHECK(registry.getUploadedBytes() == floatMesh.getUploadedBytes() + packedMesh.getUploadedBytes());
+    CHECK(registry.getUnpackedBytes() == 2 * floatMesh.getUploadedBytes());
+
+    // Un nom déjà pris est refusé sans toucher au maillage en place ni aux totaux
+    size_t uploadedBytes = registry.getUploadedBytes();
+    bool thrown = false;
+    try {
+        registry.add("float", sphere);
+    }
+    catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(&registry.get("float") == &floatMesh);
+    CHECK(registry.getMeshCount() == 2);
+    CHECK(registry.getUploadedBytes() == uploadedBytes);
+
+    registry.addLOD("sphere", glimac::Sphere::createLODChain(1, 16, 8, 2));
+    CHECK(registry.getMeshCount() == 4);
+    thrown = false;
+    try {
+        registry.addLOD("sphere", glimac::Sphere::createLODChain(1, 16, 8, 2));
+    }
+    catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(registry.getMeshCount() == 4);
+
+    CHECK(glGetError() == GL_NO_ERROR);
+    registry.clear();
+}
+
+int main() {
+    testAccuracy();
+    testRegistry();
+    return test::result();
+}
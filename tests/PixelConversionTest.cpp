@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+#include <glimac/PixelConversion.hpp>
+#include "TestCommon.hpp"
+
+// Chaque noyau (scalaire, SSE2, AVX2), imposé tour à tour, doit donner exactement les résultats des
+// versions scalaires, quels que soient la longueur (reste non multiple de la largeur SIMD) et l'alignement
+
+static bool sameBits(const std::vector<float>& a, const std::vector<float>& b) {
+    return std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+static void testKernel() {
+    // Toutes les valeurs d'octet, à tous les décalages et longueurs jusqu'à 3 vecteurs AVX2
+    std::vector<unsigned char> bytes(256 + 96);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = (unsigned char)(i * 7);
+    }
+    for (size_t offset = 0; offset < 32; ++offset) {
+        for (size_t count : { size_t(0), size_t(1), size_t(7), size_t(15), size_t(31), size_t(33), size_t(67), size_t(256) }) {
+            std::vector<float> expected(count), actual(count);
+            glimac::convertU8ToF32Scalar(bytes.data() + offset, expected.data(), count);
+            glimac::convertU8ToF32(bytes.data() + offset, actual.data(), count);
+            CHECK(sameBits(expected, actual));
+        }
+    }
+    for (int value = 0; value < 256; ++value) {
+        unsigned char byte = (unsigned char)value;
+        float converted;
+        glimac::convertU8ToF32(&byte, &converted, 1);
+        CHECK(converted == value * (1.f / 255));
+    }
+
+    // Flottants: valeurs limites (hors de [0, 1], NaN, infinis, milieux entre deux octets) puis aléatoires
+    std::vector<float> floats = {
+        0.f, -0.f, 1.f, -1.f, 2.f, 1e-30f, -1e-30f, 0.5f / 255, 1.5f / 255, 254.5f / 255,
+        std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()
+    };
+    for (int i = 0; i < 256; ++i) {
+        floats.push_back((i + 0.5f) / 255);
+        floats.push_back(std::nextafter((i + 0.5f) / 255, 0.f));
+        floats.push_back(std::nextafter((i + 0.5f) / 255, 1.f));
+    }
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> distribution(-0.25f, 1.25f);
+    for (int i = 0; i < 4096; ++i) {
+        floats.push_back(distribution(random));
+    }
+    for (size_t offset = 0; offset < 9; ++offset) {
+        size_t count = floats.size() - offset;
+        std::vector<unsigned char> expected(count), actual(count);
+        glimac::convertF32ToU8Scalar(floats.data() + offset, expected.data(), count);
+        glimac::convertF32ToU8(floats.data() + offset, actual.data(), count);
+        CHECK(expected == actual);
+    }
+
+    // Aller-retour sans perte sur les 256 valeurs
+    std::vector<float> normalized(256);
+    std::vector<unsigned char> roundTrip(256);
+    glimac::convertU8ToF32(bytes.data(), normalized.data(), 256);
+    glimac::convertF32ToU8(normalized.data(), roundTrip.data(), 256);
+    CHECK(std::equal(roundTrip.begin(), roundTrip.end(), bytes.begin()));
+}
+
+int main() {
+    std::printf("default kernel: %s\n", glimac::getPixelConversionKernel());
+    const char* defaultKernel = glimac::getPixelConversionKernel();
+
+    const glimac::PixelConversionKernel kernels[] = { glimac::PixelConversionKernel::SCALAR, glimac::PixelConversionKernel::SSE2,
+                                                      glimac::PixelConversionKernel::AVX2 };
+    const char* names[] = { "scalar", "sse2", "avx2" };
+    size_t testedCount = 0;
+    for (size_t k = 0; k < 3; ++k) {
+        if (!glimac::isPixelConversionKernelSupported(kernels[k])) {
+            CHECK(!glimac::setPixelConversionKernel(kernels[k]));
+            std::printf("%s: not supported here, skipped\n", names[k]);
+            continue;
+        }
+        CHECK(glimac::setPixelConversionKernel(kernels[k]));
+        CHECK(std::strcmp(glimac::getPixelConversionKernel(), names[k]) == 0);
+        std::printf("%s: tested\n", names[k]);
+        testKernel();
+        ++testedCount;
+    }
+    // Le noyau choisi par défaut est le plus large disponible
+    CHECK(testedCount > 0 && std::strcmp(defaultKernel, names[testedCount - 1]) == 0);
+
+    return test::result();
+}
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <glimac/Cylindre.hpp>
+#include <glimac/Sphere.hpp>
+#include "TestCommon.hpp"
+
+// Les versions indexée et non indexée de Sphere et Cylindre décrivent les mêmes triangles, dans le même
+// ordre, et ce sont ceux de l'équation paramétrique (calculés ici sommet par sommet, comme avant l'indexation)
+
+using glimac::ShapeVertex;
+
+static bool sameVertex(const ShapeVertex& a, const ShapeVertex& b, float epsilon = 0.f) {
+    for (int k = 0; k < 3; ++k) {
+        if (std::abs(a.position[k] - b.position[k]) > epsilon || std::abs(a.normal[k] - b.normal[k]) > epsilon) {
+            return false;
+        }
+    }
+    return std::abs(a.texCoords.x - b.texCoords.x) <= epsilon && std::abs(a.texCoords.y - b.texCoords.y) <= epsilon;
+}
+
+// Indices dans les bornes, chaque sommet unique utilisé, et triangle k = vertex 3k, 3k + 1, 3k + 2
+template<typename Shape>
+static void checkIndexedMatchesSoup(const Shape& shape, GLsizei expectedUniqueCount) {
+    CHECK(shape.getIndexCount() == shape.getVertexCount());
+    CHECK(shape.getIndexedVertexCount() == expectedUniqueCount);
+
+    std::vector<bool> used(shape.getIndexedVertexCount(), false);
+    bool inRange = true, sameTriangles = true;
+    for (GLsizei i = 0; i < shape.getIndexCount(); ++i) {
+        unsigned int index = shape.getIndexPointer()[i];
+        if (index >= unsigned(shape.getIndexedVertexCount())) {
+            inRange = false;
+            continue;
+        }
+        used[index] = true;
+        sameTriangles = sameTriangles && sameVertex(shape.getIndexedDataPointer()[index], shape.getDataPointer()[i]);
+    }
+    CHECK(inRange);
+    CHECK(sameTriangles);
+    CHECK(std::find(used.begin(), used.end(), false) == used.end());
+}
+
+static ShapeVertex sphereVertex(GLfloat r, GLsizei discLat, GLsizei discLong, GLsizei i, GLsizei j) {
+    float phi = i * 2 * glm::pi<float>() / discLat, theta = -glm::pi<float>() / 2 + j * glm::pi<float>() / discLong;
+    ShapeVertex vertex;
+    vertex.normal = glm::vec3(std::sin(phi) * std::cos(theta), std::sin(theta), std::cos(phi) * std::cos(theta));
+    vertex.position = r * vertex.normal;
+    vertex.texCoords = glm::vec2(float(i) / discLat, 1.f - float(j) / discLong);
+    return vertex;
+}
+
+static void testSphere(GLfloat r, GLsizei discLat, GLsizei discLong) {
+    glimac::Sphere sphere(r, discLat, discLong);
+    CHECK(sphere.getVertexCount() == discLat * discLong * 6);
+    checkIndexedMatchesSoup(sphere, (discLat + 1) * (discLong + 1));
+
+    // Deux triangles par face (i, j): (i, j) (i + 1, j) (i + 1, j + 1) et (i, j) (i + 1, j + 1) (i, j + 1)
+    const GLsizei corners[6][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 }, { 1, 1 }, { 0, 1 } };
+    bool parametric = true;
+    const ShapeVertex* pVertex = sphere.getDataPointer();
+    for (GLsizei j = 0; j < discLong; ++j) {
+        for (GLsizei i = 0; i < discLat; ++i) {
+            for (const auto& corner : corners) {
+                parametric = parametric && sameVertex(*pVertex++, sphereVertex(r, discLat, discLong, i + corner[0], j + corner[1]), 1e-5f);
+            }
+        }
+    }
+    CHECK(parametric);
+}
+
+static ShapeVertex cylindreVertex(GLfloat height, GLfloat r, GLsizei discLat, GLsizei discHeight, GLsizei i, GLsizei j) {
+    float phi = (i % discLat) * 2 * glm::pi<float>() / discLat;
+    ShapeVertex vertex;
+    vertex.position = glm::vec3(r * std::sin(phi), r * std::cos(phi), j * height / discHeight);
+    vertex.normal = glm::vec3(std::sin(phi), std::cos(phi), 0.f);
+    vertex.texCoords = glm::vec2(float(i % discLat) / discLat, float(j) / discHeight);
+    return vertex;
+}
+
+static void testCylindre(GLfloat height, GLfloat r, GLsizei discLat, GLsizei discHeight) {
+    glimac::Cylindre cylindre(height, r, discLat, discHeight);
+    CHECK(cylindre.getVertexCount() == discLat * discHeight * 6);
+    // La couture est refermée par (i + 1) % discLat: pas de colonne de sommets dupliquée
+    checkIndexedMatchesSoup(cylindre, discLat * (discHeight + 1));
+
+    const GLsizei corners[6][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 }, { 1, 1 }, { 0, 1 } };
+    bool parametric = true;
+    const ShapeVertex* pVertex = cylindre.getDataPointer();
+    for (GLsizei j = 0; j < discHeight; ++j) {
+        for (GLsizei i = 0; i < discLat; ++i) {
+            for (const auto& corner : corners) {
+                parametric = parametric && sameVertex(*pVertex++, cylindreVertex(height, r, discLat, discHeight, i + corner[0], j + corner[1]), 1e-5f);
+            }
+        }
+    }
+    CHECK(parametric);
+}
+
+// Taille en octets des deux versions: sommets seuls, ou sommets uniques et indices 32 bits
+template<typename Shape>
+static void checkByteSizes(const char* name, const Shape& shape, size_t expectedSoupBytes, size_t expectedIndexedBytes) {
+    size_t soupBytes = size_t(shape.getVertexCount()) * sizeof(ShapeVertex);
+    size_t indexedBytes = size_t(shape.getIndexedVertexCount()) * sizeof(ShapeVertex) + size_t(shape.getIndexCount()) * sizeof(unsigned int);
+    std::printf("%s: %zu bytes non-indexed, %zu bytes indexed (%.0f%%)\n", name, soupBytes, indexedBytes, 100. * indexedBytes / soupBytes);
+    CHECK(soupBytes == expectedSoupBytes);
+    CHECK(indexedBytes == expectedIndexedBytes);
+}
+
+int main() {
+    // Tailles des primitives de la scène. Sphère 64 x 32: 12288 coins, 65 x 33 = 2145 sommets uniques.
+    // Cylindre 20 x 20: 2400 coins, 20 x 21 = 420 sommets uniques (32 octets par sommet)
+    CHECK(sizeof(ShapeVertex) == 32);
+    checkByteSizes("Sphere 64x32", glimac::Sphere(1.f, 64, 32), 12288 * 32, 2145 * 32 + 12288 * 4);
+    checkByteSizes("Cylindre 20x20", glimac::Cylindre(1.f, 1.f, 20, 20), 2400 * 32, 420 * 32 + 2400 * 4);
+
+    testSphere(1.f, 32, 16);
+    testSphere(2.5f, 7, 3);
+    testSphere(0.5f, 4, 2);
+    testCylindre(1.f, 0.5f, 32, 8);
+    testCylindre(3.f, 2.f, 3, 1);
+
+    // Chaque niveau de détail respecte aussi le contrat
+    for (const auto& level : glimac::Sphere::createLODChain(1.f, 64, 32)) {
+        checkIndexedMatchesSoup(level, level.getIndexedVertexCount());
+    }
+    for (const auto& level : glimac::Cylindre::createLODChain(1.f, 1.f, 32, 4)) {
+        checkIndexedMatchesSoup(level, level.getIndexedVertexCount());
+    }
+    return test::result();
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+
+// Code de retour que CTest interprète comme un test sauté (voir SKIP_RETURN_CODE dans tests/CMakeLists.txt)
+#define TEST_SKIPPED 77
+
+namespace test {
+
+inline int& failureCount() {
+    static int count = 0;
+    return count;
+}
+
+// Code de retour du test: 0 si aucune vérification n'a échoué
+inline int result() {
+    if (failureCount() > 0) {
+        std::cerr << failureCount() << " check(s) failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+}
+
+// Continue après un échec pour rapporter toutes les vérifications fausses
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << std::endl; \
+            ++test::failureCount(); \
+        } \
+    } while (false)
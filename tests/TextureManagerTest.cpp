@@ -0,0 +1,53 @@
+#include "GLTestContext.hpp"
+#include <glimac/Image.hpp>
+#include <glimac/RenderStats.hpp>
+#include <glimac/TextureManager.hpp>
+#include "TestCommon.hpp"
+
+// Chaque image n'a qu'une texture GL, créée au premier bind: dessiner N frames
+// avec les mêmes matériaux ne doit ni créer de texture ni rien envoyer au GPU
+
+int main() {
+    test::GLTestContext context;
+    if (!context.isValid()) {
+        return TEST_SKIPPED;
+    }
+
+    glimac::Image grass(64, 32, glimac::PixelFormat::RGBA8);
+    glimac::Image sky(16, 16);
+    const glimac::Image* materials[][2] = {
+        { &grass, &sky },
+        { &sky, nullptr },
+        { &grass, nullptr }
+    };
+
+    const int FRAME_COUNT = 100;
+    GLuint grassTexture = 0;
+    for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+        glimac::RenderStats::beginFrame();
+        for (const auto& textures : materials) {
+            for (GLuint unit = 0; unit < 2; ++unit) {
+                if (textures[unit]) {
+                    glimac::TextureManager::bind(textures[unit], unit);
+                }
+            }
+        }
+
+        CHECK(glimac::TextureManager::getTextureCount() == 2);
+        if (frame == 0) {
+            grassTexture = glimac::TextureManager::getTexture(&grass);
+            CHECK(glimac::RenderStats::getUploadedByteCount() == grass.getByteSize() + sky.getByteSize());
+        }
+        else {
+            CHECK(glimac::TextureManager::getTexture(&grass) == grassTexture);
+            CHECK(glimac::RenderStats::getUploadedByteCount() == 0);
+        }
+    }
+    CHECK(glIsTexture(grassTexture));
+    CHECK(glGetError() == GL_NO_ERROR);
+
+    glimac::TextureManager::clear();
+    CHECK(glimac::TextureManager::getTextureCount() == 0);
+    CHECK(!glIsTexture(grassTexture));
+    return test::result();
+}